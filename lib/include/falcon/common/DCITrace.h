@@ -0,0 +1,144 @@
+/*
+ * Copyright (c) 2019 Robert Falkenberg.
+ *
+ * This file is part of FALCON
+ * (see https://github.com/falkenber9/falcon).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+/*
+ * Binary DCI trace
+ *
+ * A trace file starts with a DCITraceFileHeader, followed by one block per
+ * subframe: a DCITraceSubframeHeader and nof_dci DCITraceRecords.
+ * All fields are in host byte order; traces of a host with different byte
+ * order fail the magic check. The file header stores the sizes of the
+ * subframe header and the record, so that readers can skip fields appended
+ * by later versions.
+ */
+
+#define DCI_TRACE_MAGIC 0x49434446  // "FDCI"
+#define DCI_TRACE_VERSION 1
+#define DCI_TRACE_MAX_PAYLOAD_BYTES 16
+#define DCI_TRACE_DEFAULT_BUFFER_SIZE (256*1024)
+
+#define DCI_TRACE_DIR_UL 0
+#define DCI_TRACE_DIR_DL 1
+
+#define DCI_TRACE_FLAG_GAP 0x01  // subframe without result, gap_reason is valid
+#define DCI_TRACE_FLAG_LOAD_SHEDDING_SHIFT 4     // degradation level of the DCI search (0: full search)
+#define DCI_TRACE_FLAG_LOAD_SHEDDING_MASK 0x30
+
+struct __attribute__((packed)) DCITraceFileHeader {
+  uint32_t magic;
+  uint16_t version;
+  uint16_t file_header_size;
+  uint16_t subframe_header_size;
+  uint16_t record_size;
+};
+
+struct __attribute__((packed)) DCITraceSubframeHeader {
+  int64_t tv_sec;
+  uint32_t tv_usec;
+  uint16_t sfn;
+  uint8_t sf_idx;
+  uint8_t cfi;
+  uint8_t flags;
+  uint8_t gap_reason;
+  uint16_t nof_dci;
+};
+
+// Fields that the text format prints as -1 are stored as -1 as well
+struct __attribute__((packed)) DCITraceRecord {
+  uint16_t rnti;
+  uint8_t direction;    // DCI_TRACE_DIR_*
+  uint8_t format;       // srslte_dci_format_t
+  int16_t mcs_idx;
+  int16_t nof_prb;
+  int32_t tbs;
+  int32_t tbs0;
+  int32_t tbs1;
+  int8_t ndi;
+  int8_t ndi_1;
+  int8_t harq_process;
+  uint8_t ncce;
+  uint8_t L;
+  uint8_t nof_bits;
+  uint32_t histval;
+  uint8_t payload[DCI_TRACE_MAX_PAYLOAD_BYTES];  // message bits, packed MSB first
+};
+
+// Packs unpacked bits (one bit per byte) into the record payload
+void DCITracePackPayload(DCITraceRecord& record, const uint8_t* bits, uint32_t nof_bits);
+// Prints a record as one line of the DCIToFile text format
+void DCITracePrintText(FILE* file, const DCITraceSubframeHeader& header, const DCITraceRecord& record);
+
+/**
+ * @brief Buffered writer for binary DCI traces.
+ * Subframes are collected in memory and written in large chunks.
+ */
+class DCITraceWriter {
+public:
+  DCITraceWriter(size_t bufferSize = DCI_TRACE_DEFAULT_BUFFER_SIZE);
+  DCITraceWriter(const DCITraceWriter&) = delete; //prevent copy
+  DCITraceWriter& operator=(const DCITraceWriter&) = delete; //prevent copy
+  ~DCITraceWriter();
+
+  bool open(const std::string& filename);
+  bool isOpen() const;
+  void writeSubframe(const DCITraceSubframeHeader& header, const DCITraceRecord* records);
+  void flush();
+  void close();
+  uint64_t getNofSubframes() const;
+  uint64_t getNofBytes() const;
+private:
+  void append(const void* data, size_t size);
+
+  FILE* file;
+  std::vector<uint8_t> buffer;
+  size_t nof_buffered;
+  uint64_t nof_subframes;
+  uint64_t nof_bytes;
+};
+
+/**
+ * @brief Sequential reader for binary DCI traces.
+ */
+class DCITraceReader {
+public:
+  DCITraceReader();
+  DCITraceReader(const DCITraceReader&) = delete; //prevent copy
+  DCITraceReader& operator=(const DCITraceReader&) = delete; //prevent copy
+  ~DCITraceReader();
+
+  // returns false if the file cannot be opened or has no valid file header
+  bool open(const std::string& filename);
+  void close();
+  // reads the next subframe; returns false at the end of the file or on a truncated block
+  bool next(DCITraceSubframeHeader& header, std::vector<DCITraceRecord>& records);
+  const DCITraceFileHeader& getFileHeader() const;
+private:
+  bool readSized(void* dst, size_t dst_size, size_t file_size);
+
+  FILE* file;
+  DCITraceFileHeader fileHeader;
+};
@@ -0,0 +1,226 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <atomic>
+#include <vector>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+#define LOCK_FREE_QUEUE_DEFAULT_SPIN_COUNT 2000
+#define LOCK_FREE_QUEUE_CACHE_LINE 64
+
+// Bounded multi-producer/multi-consumer ring of raw pointers (D. Vyukov's
+// sequence-numbered ring). Enqueue and dequeue are lock-free; a blocking
+// dequeue spins for a while and then parks on a condition variable, which
+// producers only signal if a consumer is actually parked. Likewise,
+// consumers only signal the emptied queue if a thread waits for it.
+// The queue does not own the elements.
+template <class T>
+class LockFreeQueue {
+public:
+  LockFreeQueue(size_t capacity, uint32_t spinCount = LOCK_FREE_QUEUE_DEFAULT_SPIN_COUNT) :
+    cells(roundUpPow2(capacity)),
+    mask(cells.size() - 1),
+    spinCount(spinCount),
+    enqueuePos(0),
+    dequeuePos(0),
+    nofParked(0),
+    nofEmptyWaiters(0),
+    canceled(false)
+  {
+    for(size_t i = 0; i < cells.size(); i++) {
+      cells[i].sequence.store(i, std::memory_order_relaxed);
+      cells[i].data = nullptr;
+    }
+  }
+  LockFreeQueue(const LockFreeQueue&) = delete; //prevent copy
+  LockFreeQueue& operator=(const LockFreeQueue&) = delete; //prevent copy
+
+  ~LockFreeQueue() {
+    cancel();
+  }
+
+  // Returns false if the queue is full
+  bool enqueue(T* t) {
+    size_t pos = enqueuePos.load(std::memory_order_relaxed);
+    Cell* cell;
+    while(true) {
+      cell = &cells[pos & mask];
+      size_t seq = cell->sequence.load(std::memory_order_acquire);
+      intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+      if(diff == 0) {
+        if(enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+          break;
+        }
+      }
+      else if(diff < 0) {
+        // the cell is still occupied; full, unless a consumer is just taking its element
+        if(dequeuePos.load(std::memory_order_relaxed) <= pos - cells.size()) {
+          return false;
+        }
+        cpuRelax();
+        pos = enqueuePos.load(std::memory_order_relaxed);
+      }
+      else {
+        pos = enqueuePos.load(std::memory_order_relaxed);
+      }
+    }
+    cell->data = t;
+    cell->sequence.store(pos + 1, std::memory_order_release);
+
+    // pairs with the increment of nofParked in dequeue()
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if(nofParked.load(std::memory_order_relaxed) > 0) {
+      std::lock_guard<std::mutex> lock(m);
+      c.notify_one();
+    }
+    return true;
+  }
+
+  // Waits until an element is available;
+  // only returns nullptr if queue is canceled
+  T* dequeue() {
+    T* result = nullptr;
+    for(uint32_t i = 0; i < spinCount; i++) {
+      if(canceled.load(std::memory_order_relaxed)) {
+        return nullptr;
+      }
+      if(tryDequeue(result)) {
+        notifyIfEmpty();
+        return result;
+      }
+      cpuRelax();
+    }
+
+    std::unique_lock<std::mutex> lock(m);
+    nofParked.fetch_add(1);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    bool found = false;
+    while(!canceled.load() && !(found = tryDequeue(result))) {
+      c.wait(lock);
+    }
+    nofParked.fetch_sub(1);
+    lock.unlock();
+    if(found) {
+      notifyIfEmpty();
+    }
+    return found ? result : nullptr;
+  }
+
+  // Immediately returns an element or nullptr if empty/canceled
+  T* dequeueImmediate() {
+    T* result = nullptr;
+    if(tryDequeue(result)) {
+      notifyIfEmpty();
+    }
+    return result;
+  }
+
+  void cancel() {
+    std::lock_guard<std::mutex> lock(m);
+    canceled = true;
+    c.notify_all();   //wake all parked consumers
+    emptied.notify_all();
+  }
+
+  // Waits until all elements are dequeued; returns false if canceled before
+  bool waitEmpty() {
+    std::unique_lock<std::mutex> lock(m);
+    nofEmptyWaiters.fetch_add(1);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    while(!empty() && !canceled.load()) {
+      emptied.wait(lock);
+    }
+    nofEmptyWaiters.fetch_sub(1);
+    return empty();
+  }
+
+  bool empty() const {
+    return size() == 0;
+  }
+
+  // Approximate number of elements while producers/consumers are active
+  size_t size() const {
+    size_t deq = dequeuePos.load(std::memory_order_acquire);
+    size_t enq = enqueuePos.load(std::memory_order_acquire);
+    return enq > deq ? enq - deq : 0;
+  }
+
+  size_t capacity() const {
+    return cells.size();
+  }
+
+private:
+  struct Cell {
+    std::atomic<size_t> sequence;
+    T* data;
+  };
+
+  // hint to the CPU (and its hyper-thread sibling) while spinning
+  static void cpuRelax() {
+#if defined(__x86_64__) || defined(__i386__)
+    _mm_pause();
+#else
+    std::this_thread::yield();
+#endif
+  }
+
+  // called after a successful dequeue, without holding m
+  void notifyIfEmpty() {
+    // pairs with the increment of nofEmptyWaiters in waitEmpty()
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if(nofEmptyWaiters.load(std::memory_order_relaxed) > 0 && empty()) {
+      std::lock_guard<std::mutex> lock(m);
+      emptied.notify_all();
+    }
+  }
+
+  static size_t roundUpPow2(size_t n) {
+    size_t result = 2;
+    while(result < n) {
+      result <<= 1;
+    }
+    return result;
+  }
+
+  bool tryDequeue(T*& result) {
+    size_t pos = dequeuePos.load(std::memory_order_relaxed);
+    Cell* cell;
+    while(true) {
+      cell = &cells[pos & mask];
+      size_t seq = cell->sequence.load(std::memory_order_acquire);
+      intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1);
+      if(diff == 0) {
+        if(dequeuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+          break;
+        }
+      }
+      else if(diff < 0) {
+        return false;
+      }
+      else {
+        pos = dequeuePos.load(std::memory_order_relaxed);
+      }
+    }
+    result = cell->data;
+    cell->sequence.store(pos + mask + 1, std::memory_order_release);
+    return true;
+  }
+
+  std::vector<Cell> cells;
+  const size_t mask;
+  const uint32_t spinCount;
+  alignas(LOCK_FREE_QUEUE_CACHE_LINE) std::atomic<size_t> enqueuePos;
+  alignas(LOCK_FREE_QUEUE_CACHE_LINE) std::atomic<size_t> dequeuePos;
+  alignas(LOCK_FREE_QUEUE_CACHE_LINE) std::atomic<uint32_t> nofParked;
+  std::atomic<uint32_t> nofEmptyWaiters;
+  std::atomic<bool> canceled;
+  std::mutex m;
+  std::condition_variable c;        // parked consumers
+  std::condition_variable emptied;  // waitEmpty(); separate from c, so that notify_one always reaches a consumer
+};
@@ -47,6 +47,27 @@
 #define DEFAULT_NOF_PRB 50
 #define DEFAULT_NOF_PORTS 2
 #define DEFAULT_NOF_RX_ANT 1
+#define DEFAULT_NOF_WORKER_THREADS 1
+#define DEFAULT_NOF_SEARCH_THREADS 1
+#define DEFAULT_REORDER_BUFFER_DEPTH 100
+#define DEFAULT_NOF_SUBFRAME_BUFFERS 20
+#define DEFAULT_RF_THREAD_PRIO 0
+#define DEFAULT_LOAD_SHEDDING_POLICY "adaptive"
+#define DEFAULT_RNTI_SNAPSHOT_INTERVAL_MS 10000
+#define DEFAULT_DCI_FORMAT_SET "owl"
+// 0: breadth-first search, 1..L: depth of the recursive DCI search, 99: unlimited (L is not larger than 3)
+#define DEFAULT_MAX_RECURSION_DEPTH 99
+// 0: disambiguation disabled, 1..max recursion depth: depth of the disambiguation search
+#define DEFAULT_DCI_DISAMBIGUATION_DEPTH 99
+// 1: single survivor; list Viterbi and early termination are disabled unless either option is set
+#define DEFAULT_LIST_VITERBI_SIZE 1
+#define DEFAULT_VITERBI_MIN_RELIABILITY 0.0f
+// min. estimated probability of a DCI to decode a location (0: occupancy gate disabled)
+#define DEFAULT_OCCUPANCY_THRESHOLD 0.0f
+// decode the search spaces of known RNTIs before the blind DCI search
+#define DEFAULT_TARGETED_DCI_SEARCH false
+// decode DCI predicted by HARQ timing before the DCI search
+#define DEFAULT_HARQ_HINTS false
 
 //#define DEFAULT_DCI_FORMAT_SPLIT_RATIO 1.0
 #define DEFAULT_DCI_FORMAT_SPLIT_RATIO 0.99
@@ -90,11 +90,15 @@ typedef struct SRSLTE_API {
   bool checked;  // Flag whether this location has already been processed by dci blind search
   bool sufficient_power;    // Flag if this location has enough power to carry any useful information
   float power;   // Average LLR of location (avg of cce.power)
+  float spread;  // Variance of |LLR| relative to power^2 (occupancy feature)
+  float relative_power;  // power relative to the average of all CCEs (occupancy feature)
+  float occupancy;       // Estimated probability that this location carries a DCI (1: not estimated)
 } falcon_dci_location_t;
 
 typedef struct SRSLTE_API {
     falcon_dci_location_t* location[4];   //overlapping location for each aggregation level. CAUTION: might be NULL
     float power;    // Average LLR in CCE
+    float power2;   // Average squared LLR in CCE
 } falcon_cce_to_dci_location_map_t;
 
 SRSLTE_API int falcon_dci_index_of_format_in_list(srslte_dci_format_t format,
@@ -0,0 +1,70 @@
+/*
+ * Copyright (c) 2019 Robert Falkenberg.
+ *
+ * This file is part of FALCON
+ * (see https://github.com/falkenber9/falcon).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ */
+#pragma once
+
+#include "falcon/phy/falcon_phch/falcon_dci.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Occupancy gate
+ *
+ * Estimates the probability that a location carries a DCI from features
+ * derived by srslte_pdcch_cce_avg_llr_power (logistic regression, one model
+ * per aggregation level). Locations below a threshold are not decoded.
+ * Models are trained offline (OccupancyGateTrainer) from feature traces.
+ *
+ * Model file: one line per aggregation level "l w_bias w_power w_spread w_relative_power",
+ * l = 0..3, lines starting with '#' are ignored.
+ */
+
+#define FALCON_OCCUPANCY_NOF_FEATURES 4   // bias, power, spread, relative power
+#define FALCON_OCCUPANCY_NOF_LEVELS 4
+
+typedef struct SRSLTE_API {
+  float weights[FALCON_OCCUPANCY_NOF_LEVELS][FALCON_OCCUPANCY_NOF_FEATURES];
+} falcon_occupancy_gate_t;
+
+/* Untrained default: QPSK symbols of a transmitted CCE have a small magnitude spread, noise does not */
+SRSLTE_API void falcon_occupancy_gate_init(falcon_occupancy_gate_t *q);
+
+SRSLTE_API int falcon_occupancy_gate_load(falcon_occupancy_gate_t *q, const char *filename);
+
+SRSLTE_API int falcon_occupancy_gate_save(const falcon_occupancy_gate_t *q, const char *filename);
+
+/* Feature vector of a location (features[0] = 1 for the bias) */
+SRSLTE_API void falcon_occupancy_features(const falcon_dci_location_t *location, float *features);
+
+SRSLTE_API float falcon_occupancy_gate_predict(const falcon_occupancy_gate_t *q, const falcon_dci_location_t *location);
+
+/* Threshold that keeps target_recall of the given DCI occupancies (sorted in place); 0 without DCI */
+SRSLTE_API float falcon_occupancy_gate_threshold(float *dci_occupancy, uint32_t nof_dci, double target_recall);
+
+/* Sets the occupancy of all locations with sufficient power */
+SRSLTE_API void falcon_occupancy_gate_apply(const falcon_occupancy_gate_t *q,
+                                            falcon_dci_location_t *locations,
+                                            uint32_t nof_locations);
+
+#ifdef __cplusplus
+}
+#endif
@@ -23,6 +23,7 @@
 
 #include "falcon/phy/common/falcon_phy_common.h"
 #include "falcon/phy/falcon_phch/falcon_dci.h"
+#include "falcon/phy/falcon_phch/falcon_viterbi.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -35,8 +36,48 @@ extern "C" {
 //#define MAX_NUM_OF_CCE 64
 #define MAX_NUM_OF_CCE 84
 
+/* Decoder state for DCI decoding. Each thread decoding from the same srslte_pdcch_t
+ * (i.e. sharing its LLRs) requires its own instance. */
+/* Max. difference of reliability between the best survivor and a survivor of a known RNTI */
+#define FALCON_PDCCH_LIST_TIE_MARGIN 0.01f
+
+/* Returns nonzero if rnti is known, i.e. preferred among survivors of similar reliability */
+typedef int (*falcon_pdcch_rnti_filter_t)(void *arg, uint16_t rnti);
+
+typedef struct SRSLTE_API {
+  srslte_viterbi_t decoder;
+  srslte_crc_t crc;
+  float rm_f[3 * (SRSLTE_DCI_MAX_BITS + 16)];
+
+  // list Viterbi (optional)
+  falcon_viterbi_t list_decoder;
+  uint32_t list_size;
+  float min_reliability;
+  falcon_pdcch_rnti_filter_t rnti_filter;
+  void *rnti_filter_arg;
+  uint8_t list_data[FALCON_VITERBI_MAX_LIST][FALCON_VITERBI_MAX_BITS];
+} falcon_pdcch_decoder_t;
+
+SRSLTE_API int falcon_pdcch_decoder_init(falcon_pdcch_decoder_t *d);
+
+/* Replaces the srsLTE Viterbi by the list Viterbi if min_reliability > 0 or list_size > 1.
+ * Candidates abandoned early yield the CRC remainder FALCON_ILLEGAL_RNTI. Among up to list_size
+ * survivors of similar reliability, the first one accepted by rnti_filter (if set) is returned. */
+SRSLTE_API void falcon_pdcch_decoder_set_list_viterbi(falcon_pdcch_decoder_t *d,
+                                                      uint32_t list_size,
+                                                      float min_reliability);
+
+SRSLTE_API void falcon_pdcch_decoder_set_rnti_filter(falcon_pdcch_decoder_t *d,
+                                                     falcon_pdcch_rnti_filter_t filter,
+                                                     void *arg);
+
+SRSLTE_API void falcon_pdcch_decoder_free(falcon_pdcch_decoder_t *d);
+
 SRSLTE_API uint32_t srslte_pdcch_nof_cce(srslte_pdcch_t *q, uint32_t cfi);
 
+/* Sum of absolute LLR values (SIMD if available) */
+SRSLTE_API float falcon_pdcch_llr_abs_sum(const float *llr, uint32_t len);
+
 SRSLTE_API float srslte_pdcch_decode_msg_check_power(srslte_pdcch_t *q,
                                           uint32_t cfi,
                                           srslte_dci_msg_t *msg,
@@ -63,6 +104,32 @@ SRSLTE_API int srslte_pdcch_decode_msg_limit_avg_llr_power(srslte_pdcch_t *q,
                                                            uint16_t *crc_rem,
                                                            double minimum_avg_llr_bound);
 
+/* Same as srslte_pdcch_decode_msg_limit_avg_llr_power, but with a separate decoder state d */
+SRSLTE_API int falcon_pdcch_decode_msg_limit_avg_llr_power(srslte_pdcch_t *q,
+                                                           falcon_pdcch_decoder_t *d,
+                                                           srslte_dci_msg_t *msg,
+                                                           falcon_dci_location_t *location,
+                                                           srslte_dci_format_t format,
+                                                           uint32_t cfi,
+                                                           uint16_t *crc_rem,
+                                                           double minimum_avg_llr_bound);
+
+/* Sets msg->format to the requested format; formats 0 and 1A are distinguished by the flag bit */
+SRSLTE_API void falcon_pdcch_dci_msg_set_format(srslte_dci_msg_t *msg,
+                                                srslte_dci_format_t format);
+
+/* Decodes one location for several formats at once. Formats of equal payload size are decoded only once.
+ * Results are stored in msgs[i] and crc_rem[i]. Returns the number of decoder runs or a negative error code. */
+SRSLTE_API int falcon_pdcch_decode_msg_multi(srslte_pdcch_t *q,
+                                             falcon_pdcch_decoder_t *d,
+                                             falcon_dci_location_t *location,
+                                             const srslte_dci_format_t *formats,
+                                             uint32_t nof_formats,
+                                             uint32_t cfi,
+                                             srslte_dci_msg_t **msgs,
+                                             uint16_t **crc_rem,
+                                             double minimum_avg_llr_bound);
+
 /* Decoding functions: Try to decode a DCI message after calling srslte_pdcch_extract_llr */
 SRSLTE_API int srslte_pdcch_decode_msg_no_llr_limit(srslte_pdcch_t *q,
                                                     srslte_dci_msg_t *msg,
@@ -78,7 +145,8 @@ SRSLTE_API uint32_t srslte_pdcch_nof_missed_cce(srslte_pdcch_t *q, uint32_t cfi,
                                            falcon_cce_to_dci_location_map_t *cce_map,
                                            uint32_t max_cce);
 
-/* Calculate average power (LLR) on each CCE for DCI filtering */
+/* Calculate average power (LLR) on each CCE for DCI filtering.
+ * In addition, the power of each location in cce_map is derived from its CCEs. */
 SRSLTE_API int srslte_pdcch_cce_avg_llr_power(srslte_pdcch_t *q, uint32_t cfi,
                                               falcon_cce_to_dci_location_map_t *cce_map,
                                               uint32_t max_cce);
@@ -94,6 +162,32 @@ SRSLTE_API uint32_t srslte_pdcch_generic_locations_ncce(uint32_t nof_cce,
 SRSLTE_API uint32_t srslte_pdcch_validate_location(uint32_t nof_cce, uint32_t ncce, uint32_t l,
                                                    uint32_t nsubframe, uint16_t rnti);
 
+/* Lazily populated, direct-mapped table of search spaces (valid (ncce, L) per rnti, subframe and nof_cce).
+ * Not thread-safe: each thread requires its own instance. */
+#define FALCON_SEARCH_SPACE_CACHE_SIZE  4096  // entries, power of 2
+#define FALCON_SEARCH_SPACE_NOF_BITS    165   // bit offsets for L=0..3: 0, 88, 132, 154
+
+typedef struct SRSLTE_API {
+  uint32_t tag;       // 0 if empty
+  uint32_t padding;
+  uint64_t mask[(FALCON_SEARCH_SPACE_NOF_BITS + 63) / 64];
+} falcon_search_space_entry_t;
+
+typedef struct SRSLTE_API {
+  falcon_search_space_entry_t *entries;
+  uint64_t nof_hits;
+  uint64_t nof_misses;
+} falcon_search_space_cache_t;
+
+SRSLTE_API int falcon_search_space_cache_init(falcon_search_space_cache_t *c);
+
+SRSLTE_API void falcon_search_space_cache_free(falcon_search_space_cache_t *c);
+
+/* Same result as srslte_pdcch_validate_location(), but O(1) after the first call for rnti/nsubframe/nof_cce */
+SRSLTE_API uint32_t falcon_search_space_cache_validate_location(falcon_search_space_cache_t *c,
+                                                                uint32_t nof_cce, uint32_t ncce, uint32_t l,
+                                                                uint32_t nsubframe, uint16_t rnti);
+
 SRSLTE_API uint32_t srslte_pdcch_ue_locations_all(srslte_pdcch_t *q,
                                                   falcon_dci_location_t *locations,
                                                   uint32_t max_locations,
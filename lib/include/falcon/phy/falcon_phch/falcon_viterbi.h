@@ -0,0 +1,78 @@
+/*
+ * Copyright (c) 2019 Robert Falkenberg.
+ *
+ * This file is part of FALCON
+ * (see https://github.com/falkenber9/falcon).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ */
+#pragma once
+
+#include <stdint.h>
+
+#include "srslte/config.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * List Viterbi decoder for the tail-biting convolutional code of the PDCCH
+ * (K=7, rate 1/3, polynomials 0x6D, 0x4F, 0x57).
+ *
+ * Soft bits follow the srsLTE convention (positive: bit 1). The decoder tracks
+ * how well the best path matches the received soft bits (reliability: path
+ * metric relative to the sum of absolute soft bits, 1.0 for a perfect match)
+ * and abandons the decoding at a checkpoint if the reliability is below a
+ * lower bound. Noise-only locations are typically rejected halfway through
+ * the trellis.
+ */
+
+#define FALCON_VITERBI_K 7
+#define FALCON_VITERBI_NOF_STATES 64
+#define FALCON_VITERBI_MAX_BITS 128       // message including CRC
+#define FALCON_VITERBI_GUARD 24           // wrap-around steps to settle the start state of the tail-biting trellis
+#define FALCON_VITERBI_CHECK_INTERVAL 16  // steps between two reliability checkpoints
+#define FALCON_VITERBI_MAX_LIST 8
+#define FALCON_VITERBI_MAX_VISITED 16     // end states checked for tail-biting survivors
+
+typedef struct SRSLTE_API {
+  float metric[2][FALCON_VITERBI_NOF_STATES];
+  uint8_t decisions[FALCON_VITERBI_GUARD + FALCON_VITERBI_MAX_BITS][FALCON_VITERBI_NOF_STATES];
+  float sign[3][FALCON_VITERBI_NOF_STATES / 2];  // +-1 per coded bit of the butterfly transitions
+  uint32_t nof_early_terminations;
+} falcon_viterbi_t;
+
+SRSLTE_API void falcon_viterbi_init(falcon_viterbi_t *q);
+
+/* Tail-biting encoder matching the decoder (3 * nof_bits output bits) */
+SRSLTE_API void falcon_viterbi_encode(const uint8_t *input, uint8_t *output, uint32_t nof_bits);
+
+/* Decodes nof_bits from 3 * nof_bits soft bits.
+ * Returns 0 if the decoding was abandoned (reliability below min_reliability, 0 disables the checkpoints).
+ * Otherwise, up to list_size tail-biting survivors are written to data[0..n-1] (nof_bits each),
+ * ordered by path metric, and n is returned. Without a tail-biting survivor, the best path is returned.
+ * If reliability is not NULL, it receives the reliability of each survivor. */
+SRSLTE_API int falcon_viterbi_decode_list(falcon_viterbi_t *q,
+                                          const float *llr,
+                                          uint32_t nof_bits,
+                                          float min_reliability,
+                                          uint8_t **data,
+                                          float *reliability,
+                                          uint32_t list_size);
+
+#ifdef __cplusplus
+}
+#endif
@@ -21,23 +21,65 @@
 #pragma once
 
 #include <stdint.h>
+#include <stddef.h>
 #include <vector>
 
-class Histogram {
+#include "RNTIActivityEstimator.h"
+
+// Counters saturate; frequencies are exact as long as itemCount <= HISTOGRAM_MAX_COUNT
+#define HISTOGRAM_MAX_COUNT 0xffff
+#define HISTOGRAM_DENSE_ALL 0xffffffff
+#define HISTOGRAM_SPARSE_MIN_CAPACITY 64
+
+/*
+ * Frequency of the items within a sliding window of the last itemCount
+ * additions. The window is either a plain ring of items or, if
+ * runLengthEncoded is set, a ring of runs (item, count), in which repeated
+ * items such as padding cost O(1) per add() and per eviction.
+ * Items below denseRange are counted in an array, all others in a hashed
+ * map that only holds items within the window.
+ */
+class Histogram : public RNTIActivityEstimator {
 public:
-  Histogram(uint32_t itemCount, uint32_t valueRange);
+  Histogram(uint32_t itemCount,
+            uint32_t valueRange,
+            bool runLengthEncoded = false,
+            uint32_t denseRange = HISTOGRAM_DENSE_ALL);
   //Histogram(const Histogram& other);
-  virtual ~Histogram();
-  virtual void add(uint16_t item);
-  virtual void add(uint16_t item, uint32_t nTimes);
-  virtual uint32_t getFrequency(uint16_t item) const;
-  virtual const uint32_t* getFrequencyAll() const;
-  virtual bool ready() const;
+  virtual ~Histogram() override;
+  virtual void add(uint16_t item) override;
+  virtual void add(uint16_t item, uint32_t nTimes) override;
+  virtual uint32_t getFrequency(uint16_t item) const override;
+  virtual void accumulate(uint32_t* buf) const override;
+  virtual bool ready() const override;
   virtual uint32_t getItemCount() const;
   virtual uint32_t getValueRange() const;
+  virtual bool isRunLengthEncoded() const;
+  virtual uint32_t getDenseRange() const;
+  // allocated bytes of counters and history
+  virtual size_t getMemorySize() const override;
+  virtual const char* getName() const override;
 private:
+  struct Run {
+    uint16_t item;
+    uint32_t count;
+  };
+  struct SparseSlot {
+    uint16_t item;
+    uint16_t count;   // 0: empty
+  };
+  void addRun(uint16_t item, uint32_t nTimes);
+  void increment(uint16_t item, uint32_t n);
+  void decrement(uint16_t item, uint32_t n);
+  uint32_t sparseHome(uint16_t item) const;
+  uint32_t sparseFind(uint16_t item) const;
+  void sparseErase(uint32_t idx);
+  void sparseGrow();
   //void initBuffers();
-  std::vector<uint32_t> rnti_histogram;           // the actual histogram
+  std::vector<uint16_t> rnti_histogram;           // the actual histogram (items below denseRange)
+  uint32_t denseRange;
+  std::vector<SparseSlot> sparse;                 // open addressing, linear probing
+  uint32_t sparse_used;
   std::vector<uint16_t> rnti_history;             // circular buffer of the recent seen RNTIs
   uint32_t rnti_history_current;     // index to current head/(=foot) of rnti_history
   uint32_t rnti_history_end;         // index to highest index in history array
@@ -45,4 +87,9 @@ private:
   bool rnti_histogram_ready;           // ready-indicator, if history is filled
   uint32_t itemCount;
   uint32_t valueRange;
+  bool runLengthEncoded;
+  std::vector<Run> runs;        // circular buffer of runs (run-length encoded mode only)
+  uint32_t runs_head;           // oldest run
+  uint32_t nof_runs;
+  uint32_t nof_items;           // items in the window
 };
@@ -0,0 +1,105 @@
+/*
+ * Copyright (c) 2019 Robert Falkenberg.
+ *
+ * This file is part of FALCON 
+ * (see https://github.com/falkenber9/falcon).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string>
+#include <vector>
+#include <memory>
+
+// count-min sketch of the "sketch" estimator
+#define RNTI_ACTIVITY_SKETCH_WIDTH 8192
+#define RNTI_ACTIVITY_SKETCH_DEPTH 3
+
+/*
+ * Activity of RNTIs within the recent candidate stream, used by the
+ * RNTIManager to accept or reject unknown RNTIs. Time advances with each
+ * added item (including padding), so itemCount items span the window.
+ */
+class RNTIActivityEstimator {
+public:
+  virtual ~RNTIActivityEstimator();
+  virtual void add(uint16_t item) = 0;
+  virtual void add(uint16_t item, uint32_t nTimes) = 0;
+  // (estimated) number of occurrences within the window
+  virtual uint32_t getFrequency(uint16_t item) const = 0;
+  // adds the frequency of each item to buf[item]; buf holds valueRange elements
+  virtual void accumulate(uint32_t* buf) const = 0;
+  virtual bool ready() const = 0;
+  // allocated bytes
+  virtual size_t getMemorySize() const = 0;
+  virtual const char* getName() const = 0;
+
+  // "histogram" (exact sliding window), "decay" (exponential decay per item) or
+  // "sketch" (exponential decay in a count-min sketch); nullptr for unknown names.
+  // "decay" keeps one float per value (256 KiB for 16 bit RNTIs), more than the
+  // dense histogram; "sketch" is the compact option (96 KiB), at the cost of
+  // overestimating colliding RNTIs.
+  // runLengthEncoded and denseRange only apply to the histogram.
+  static std::unique_ptr<RNTIActivityEstimator> create(const std::string& name,
+                                                       uint32_t itemCount,
+                                                       uint32_t valueRange,
+                                                       bool runLengthEncoded,
+                                                       uint32_t denseRange);
+};
+
+/*
+ * Exponentially decaying counters with a time constant of itemCount items,
+ * so that a steady rate yields the same frequency as a sliding window of
+ * itemCount items. Constant memory and O(depth) updates, no history.
+ * Items are hashed into depth rows of width counters (count-min sketch with
+ * conservative update); if width covers the value range, each item has its
+ * own counter and the estimate is exact.
+ * Decay is applied lazily: new items are added with a growing weight, which
+ * is divided out on reads and renormalized from time to time.
+ */
+class DecayingActivityEstimator : public RNTIActivityEstimator {
+public:
+  DecayingActivityEstimator(uint32_t itemCount,
+                            uint32_t valueRange,
+                            uint32_t width,
+                            uint32_t depth);
+  virtual ~DecayingActivityEstimator() override;
+  virtual void add(uint16_t item) override;
+  virtual void add(uint16_t item, uint32_t nTimes) override;
+  virtual uint32_t getFrequency(uint16_t item) const override;
+  virtual void accumulate(uint32_t* buf) const override;
+  virtual bool ready() const override;
+  virtual size_t getMemorySize() const override;
+  virtual const char* getName() const override;
+  uint32_t getWidth() const;
+  uint32_t getDepth() const;
+private:
+  uint32_t index(uint16_t item, uint32_t row) const;
+  float estimate(uint16_t item) const;
+  void renormalize();
+  uint32_t itemCount;
+  uint32_t valueRange;
+  uint32_t width;
+  uint32_t depth;
+  uint32_t shift;       // hash: (item * multiplier[row]) >> shift
+  bool exact;
+  std::vector<float> counters;   // depth rows of width counters
+  double growth;        // weight increase per item: exp(1/itemCount)
+  double weight;        // weight of the next item
+  uint32_t nof_items;   // saturates at itemCount (ready indicator)
+};
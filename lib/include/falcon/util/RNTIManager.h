@@ -21,14 +21,17 @@
 #pragma once
 
 #include <vector>
-#include <list>
 #include <string.h>
 #include <strings.h>
 #include <string>
+#include <mutex>
+#include <atomic>
+#include <memory>
 
 #include "rnti_manager_c.h"
 
 #include "Histogram.h"
+#include "RNTIActivityEstimator.h"
 #include "Interval.h"
 
 // DCI minimum average llr for accepting DCI for blind decoding
@@ -46,10 +49,25 @@
 #define RNTI_HISTORY_DEPTH_MSEC 200  //200
 #define RNTI_PER_SUBFRAME (304/5)
 #define RNTI_HISTORY_DEPTH (RNTI_HISTORY_DEPTH_MSEC)*(RNTI_PER_SUBFRAME)
+// store the history as runs (padding of each time step is a single run)
+#define RNTI_HISTORY_RUN_LENGTH_ENCODED true
+// RNTIs below this value are counted in dense arrays, the others in hashed maps.
+// Use RNTI_CRNTI_START to keep the sparsely populated C-RNTI range in hashed maps.
+#define RNTI_CRNTI_START 0x003D
+#define RNTI_HISTOGRAM_DENSE_RANGE RNTI_HISTOGRAM_ELEMENT_COUNT
+// activity estimator of each format (see RNTIActivityEstimator::create)
+#define RNTI_DEFAULT_ACTIVITY_ESTIMATOR "histogram"
 
 // Reserverd values
 #define ILLEGAL_RNTI 0
 
+// Subframe numbering (sfn * 10 + sf_idx) for epoch-based time steps
+#define RNTI_MANAGER_NOF_TTI 10240
+
+// Timer wheel for the expiry of active RNTIs (resolution in ms)
+#define RNTI_TIMER_WHEEL_RESOLUTION 64
+#define RNTI_TIMER_WHEEL_NOF_SLOTS 256
+
 // Constant values for format indices
 #define FORMAT_INDEX_UPLINK 0
 #define FORMAT_INDEX_FIRST_DOWNLINK (FORMAT_INDEX_UPLINK + 1)
@@ -65,20 +83,55 @@ class RNTIActiveSetItem {
 public:
   uint16_t rnti;
   ActivationReason reason;
-  RNTIActiveSetItem(uint16_t rnti, ActivationReason reason = RM_ACT_UNSET) :
+  uint32_t deadline;  // next expiry check (timestamp)
+  RNTIActiveSetItem(uint16_t rnti, ActivationReason reason = RM_ACT_UNSET, uint32_t deadline = 0) :
     rnti(rnti),
-    reason(reason) {}
+    reason(reason),
+    deadline(deadline) {}
   bool operator==(const RNTIActiveSetItem& other) const { return rnti == other.rnti; }
   bool operator!=(const RNTIActiveSetItem& other) const { return rnti != other.rnti; }
 };
 
+// Candidates collected by one search thread during a subframe.
+// They are merged into the histograms by RNTIManager::commitSubframe().
+class RNTICandidateDelta {
+public:
+  RNTICandidateDelta();
+  void add(uint16_t rnti, uint32_t formatIdx);
+  void append(const RNTICandidateDelta& other);
+  void clear();   // keeps capacity
+  uint32_t getNofFormats() const;
+  const std::vector<uint16_t>& getCandidates(uint32_t formatIdx) const;
+private:
+  std::vector<std::vector<uint16_t> > candidates;
+};
+
+/*
+ * Thread-safe RNTI manager, shared by all subframe workers.
+ * Per-RNTI state (active flag, activation reason, associated format and
+ * last-seen timestamp) is packed into one atomic word, so validation and
+ * refresh of active RNTIs do not lock. Each histogram has its own lock and
+ * receives candidates in bulk once per subframe. Evergreen and forbidden
+ * ranges, the activity estimator and the threshold must be configured
+ * before decoding starts.
+ */
+typedef uint32_t rnti_state_t;
+
 class RNTIManager {
 public:
-  RNTIManager(uint32_t nformats, uint32_t maxCandidatesPerStepPerFormat);
+  RNTIManager(uint32_t nformats,
+              uint32_t maxCandidatesPerStepPerFormat,
+              uint32_t histogramDenseRange = RNTI_HISTOGRAM_DENSE_RANGE);
   virtual ~RNTIManager();
 
   virtual void addEvergreen(uint16_t rntiStart, uint16_t rntiEnd, uint32_t formatIdx);
   virtual void addForbidden(uint16_t rntiStart, uint16_t rntiEnd, uint32_t formatIdx);
+  // replaces the activity estimators of all formats (discards their state); false for unknown names
+  virtual bool setActivityEstimator(const std::string& name);
+  virtual const char* getActivityEstimatorName() const;
+  // unknown RNTIs are accepted if their frequency exceeds the threshold
+  virtual void setThreshold(uint32_t threshold);
+  virtual uint32_t getThreshold() const;
   virtual void addCandidate(uint16_t rnti, uint32_t formatIdx);
   virtual bool validate(uint16_t rnti, uint32_t formatIdx);
   virtual bool validateAndRefresh(uint16_t rnti, uint32_t formatIdx);
@@ -87,12 +140,35 @@ public:
   virtual bool isForbidden(uint16_t rnti, uint32_t formatIdx) const;
   virtual void stepTime();
   virtual void stepTime(uint32_t nSteps);
+  // merges the candidates of subframe tti (sfn*10+sf_idx) and advances time to tti, one step
+  // per elapsed subframe; late subframes (tti already passed) do not step time backwards. Clears delta.
+  virtual void commitSubframe(uint32_t tti, RNTICandidateDelta& delta);
+  virtual uint32_t getTimestamp() const;
+  // Writes active RNTIs and recent frequencies to filename (via a temporary file).
+  // tag identifies the cell.
+  virtual bool saveSnapshot(const std::string& filename, uint32_t tag);
+  // Restores a snapshot of the same cell and format count on top of the current state.
+  // The time since the snapshot (ageMs < 0: derive from the wall clock) is added to the
+  // age of active RNTIs, frequencies are scaled down to the remaining part of the window
+  // and age out with it. Meant for a fresh manager: the padding for the passed part of the
+  // window ages frequencies collected before the restore as well.
+  virtual bool loadSnapshot(const std::string& filename, uint32_t tag, int64_t ageMs = -1);
+  // allocated bytes of per-RNTI state and histograms
+  virtual size_t getMemorySize();
   virtual uint32_t getFrequency(uint16_t rnti, uint32_t formatIdx);
   virtual uint32_t getAssociatedFormatIdx(uint16_t rnti);
   virtual ActivationReason getActivationReason(uint16_t rnti);
   virtual void getHistogramSummary(uint32_t* buf);
   virtual std::vector<rnti_manager_active_set_t> getActiveSet();
+  // fills result and reuses its capacity
+  virtual void getActiveSet(std::vector<rnti_manager_active_set_t>& result);
+  // fills at most buf_sz entries of buf; returns the number of entries
+  virtual uint32_t getActiveSet(rnti_manager_active_set_t* buf, uint32_t buf_sz);
+  virtual uint32_t getNofActive();
   virtual void printActiveSet();
+  // Calls f(const rnti_manager_active_set_t&) for each active RNTI without allocating.
+  // The active set is locked meanwhile, so f must not activate or deactivate RNTIs.
+  template <class F> void forEachActive(F f);
 
   static std::string getActivationReasonString(ActivationReason reason);
 private:
@@ -100,21 +176,54 @@ private:
   RMValidationResult_t validateByActiveList(uint16_t rnti, uint32_t formatIdx);
   bool validateByHistogram(uint16_t rnti, uint32_t formatIdx);
   virtual uint32_t getLikelyDlFormatIdx(uint16_t rnti);
-  void activateRNTI(uint16_t rnti, ActivationReason reason);
-  void deactivateRNTI(uint16_t rnti);
-  bool isExpired(uint16_t rnti) const;
-  void cleanExpired();
+  void activateRNTI(uint16_t rnti, ActivationReason reason, uint32_t formatIdx, bool refresh);
+  void refreshRNTI(uint16_t rnti);
+  void deactivateRNTI(uint16_t rnti, rnti_state_t expected);
+  bool isExpired(rnti_state_t state) const;
+  bool getActiveSetEntry(const RNTIActiveSetItem& item, uint32_t now, rnti_manager_active_set_t& entry);
+  bool isInActiveSet(uint16_t rnti) const;
+  void insertActiveSet(uint16_t rnti, ActivationReason reason, uint32_t lastSeen);
+  void removeActiveSet(uint16_t rnti);
+  void scheduleExpiry(RNTIActiveSetItem& item, uint32_t deadline);
+  void processTimerWheel();
+  // returns the number of elapsed time steps
+  uint32_t advanceTo(uint32_t tti);
   uint32_t nformats;
-  std::vector<Histogram> histograms;
+  std::vector<std::unique_ptr<RNTIActivityEstimator> > histograms;
+  std::unique_ptr<std::mutex[]> histogramMutex;   // one per format
+  uint32_t histogramDenseRange;
   std::vector<std::vector<Interval> > evergreen;
   std::vector<std::vector<Interval> > forbidden;
-  std::vector<bool> active;
-  std::list<RNTIActiveSetItem> activeSet;
-  std::vector<uint32_t> lastSeen;
-  std::vector<uint32_t> assocFormatIdx;
-  uint32_t timestamp;
+  std::unique_ptr<std::atomic<rnti_state_t>[]> state;  // packed per-RNTI state, see RNTIManager.cc
+  // active set as sparse set: dense array of items and the position of each RNTI in it
+  std::vector<RNTIActiveSetItem> activeSet;
+  std::vector<uint16_t> activeSetIndex;
+  // expiry checks, slot = deadline / RNTI_TIMER_WHEEL_RESOLUTION % RNTI_TIMER_WHEEL_NOF_SLOTS;
+  // entries are valid while they match the deadline of the item in the active set
+  struct TimerWheelEntry {
+    uint16_t rnti;
+    uint32_t deadline;
+  };
+  std::vector<std::vector<TimerWheelEntry> > timerWheel;
+  uint32_t timerWheelTick;     // next tick to process
+  std::mutex activeSetMutex;   // activeSet, timerWheel and (de)activation of RNTIs
+  std::atomic<uint32_t> timestamp;
+  int32_t lastTti;             // -1: no subframe committed yet
+  std::mutex timeMutex;
   uint32_t lifetime;
   uint32_t threshold;
   uint32_t maxCandidatesPerStepPerFormat;
-  std::vector<int32_t> remainingCandidates;
+  std::unique_ptr<std::atomic<int32_t>[]> remainingCandidates;
 };
+
+template <class F>
+void RNTIManager::forEachActive(F f) {
+  std::lock_guard<std::mutex> lock(activeSetMutex);
+  uint32_t now = timestamp.load(std::memory_order_relaxed);
+  rnti_manager_active_set_t entry;
+  for(const RNTIActiveSetItem& item : activeSet) {
+    if(getActiveSetEntry(item, now, entry)) {
+      f(static_cast<const rnti_manager_active_set_t&>(entry));
+    }
+  }
+}
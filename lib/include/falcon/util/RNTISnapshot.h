@@ -0,0 +1,62 @@
+/*
+ * Copyright (c) 2019 Robert Falkenberg.
+ *
+ * This file is part of FALCON 
+ * (see https://github.com/falkenber9/falcon).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ */
+#pragma once
+
+#include <stdint.h>
+
+/*
+ * Binary snapshot of the RNTIManager for warm starts
+ *
+ * A snapshot consists of a RNTISnapshotHeader, nof_active
+ * RNTISnapshotActive entries and nof_frequencies RNTISnapshotFrequency
+ * entries. All elements have fixed sizes, so that the file can be mapped
+ * into memory and read in place. All fields are in host byte order; files
+ * of a host with different byte order fail the magic check.
+ */
+
+#define RNTI_SNAPSHOT_MAGIC 0x534e5246  // "FRNS"
+#define RNTI_SNAPSHOT_VERSION 1
+
+struct __attribute__((packed)) RNTISnapshotHeader {
+  uint32_t magic;
+  uint16_t version;
+  uint16_t header_size;
+  uint32_t tag;             // identifies the cell; snapshots of other cells are rejected
+  uint32_t nof_formats;
+  int64_t wallclock_ms;     // time of the snapshot (ms since epoch), for age compensation
+  uint32_t window_ms;       // time span of the frequencies
+  uint32_t nof_active;
+  uint32_t nof_frequencies;
+};
+
+struct __attribute__((packed)) RNTISnapshotActive {
+  uint16_t rnti;
+  uint8_t format_idx;       // associated format
+  uint8_t reason;           // ActivationReason
+  uint32_t age_ms;          // time since last seen
+};
+
+struct __attribute__((packed)) RNTISnapshotFrequency {
+  uint16_t rnti;
+  uint8_t format_idx;
+  uint8_t reserved;
+  uint32_t count;
+};
@@ -0,0 +1,216 @@
+/*
+ * Copyright (c) 2019 Robert Falkenberg.
+ *
+ * This file is part of FALCON
+ * (see https://github.com/falkenber9/falcon).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ */
+#include "falcon/common/DCITrace.h"
+
+#include <cstring>
+#include <algorithm>
+
+void DCITracePackPayload(DCITraceRecord& record, const uint8_t* bits, uint32_t nof_bits) {
+  if(nof_bits > 8*DCI_TRACE_MAX_PAYLOAD_BYTES) {
+    nof_bits = 8*DCI_TRACE_MAX_PAYLOAD_BYTES;
+  }
+  memset(record.payload, 0, sizeof(record.payload));
+  for(uint32_t i = 0; i < nof_bits; i++) {
+    if(bits[i]) {
+      record.payload[i/8] |= static_cast<uint8_t>(0x80 >> (i%8));
+    }
+  }
+  record.nof_bits = static_cast<uint8_t>(nof_bits);
+}
+
+void DCITracePrintText(FILE* file, const DCITraceSubframeHeader& header, const DCITraceRecord& record) {
+  // same hex representation as sprint_hex: packed bytes, last byte padded with zeros
+  char hex_str[2*DCI_TRACE_MAX_PAYLOAD_BYTES + 1];
+  uint32_t nof_bytes = (record.nof_bits + 7) / 8;
+  for(uint32_t i = 0; i < nof_bytes; i++) {
+    snprintf(&hex_str[2*i], 3, "%02x", record.payload[i]);
+  }
+  hex_str[2*nof_bytes] = 0;
+
+  fprintf(file,
+          "%ld.%06ld\t%04d\t%d\t%d\t%d\t"
+          "%d\t%d\t%d\t%d\t%d\t"
+          "%d\t%d\t%d\t%d\t"
+          "%d\t%d\t%d\t%d\t%d\t%s\n",
+          static_cast<long>(header.tv_sec), static_cast<long>(header.tv_usec), header.sfn, header.sf_idx, record.rnti, record.direction,
+          record.mcs_idx, record.nof_prb, record.tbs, record.tbs0, record.tbs1,
+          record.direction == DCI_TRACE_DIR_DL ? record.format + 1 : 0, record.ndi, record.ndi_1, record.harq_process,
+          record.ncce, record.L, header.cfi, record.histval, record.nof_bits, hex_str);
+}
+
+DCITraceWriter::DCITraceWriter(size_t bufferSize) :
+  file(nullptr),
+  buffer(std::max(bufferSize, sizeof(DCITraceSubframeHeader))),
+  nof_buffered(0),
+  nof_subframes(0),
+  nof_bytes(0)
+{
+
+}
+
+DCITraceWriter::~DCITraceWriter() {
+  close();
+}
+
+bool DCITraceWriter::open(const std::string& filename) {
+  close();
+  file = fopen(filename.c_str(), "wb");
+  if(file == nullptr) {
+    return false;
+  }
+  DCITraceFileHeader fileHeader;
+  fileHeader.magic = DCI_TRACE_MAGIC;
+  fileHeader.version = DCI_TRACE_VERSION;
+  fileHeader.file_header_size = sizeof(DCITraceFileHeader);
+  fileHeader.subframe_header_size = sizeof(DCITraceSubframeHeader);
+  fileHeader.record_size = sizeof(DCITraceRecord);
+  append(&fileHeader, sizeof(fileHeader));
+  return true;
+}
+
+bool DCITraceWriter::isOpen() const {
+  return file != nullptr;
+}
+
+void DCITraceWriter::writeSubframe(const DCITraceSubframeHeader& header, const DCITraceRecord* records) {
+  if(file == nullptr) {
+    return;
+  }
+  append(&header, sizeof(header));
+  append(records, header.nof_dci * sizeof(DCITraceRecord));
+  nof_subframes++;
+}
+
+void DCITraceWriter::flush() {
+  if(file != nullptr && nof_buffered > 0) {
+    fwrite(buffer.data(), 1, nof_buffered, file);
+    fflush(file);
+  }
+  nof_buffered = 0;
+}
+
+void DCITraceWriter::close() {
+  if(file != nullptr) {
+    flush();
+    fclose(file);
+    file = nullptr;
+  }
+}
+
+uint64_t DCITraceWriter::getNofSubframes() const {
+  return nof_subframes;
+}
+
+uint64_t DCITraceWriter::getNofBytes() const {
+  return nof_bytes;
+}
+
+void DCITraceWriter::append(const void* data, size_t size) {
+  const uint8_t* src = static_cast<const uint8_t*>(data);
+  nof_bytes += size;
+  while(size > 0) {
+    if(nof_buffered == buffer.size()) {
+      fwrite(buffer.data(), 1, nof_buffered, file);
+      nof_buffered = 0;
+    }
+    size_t chunk = std::min(size, buffer.size() - nof_buffered);
+    memcpy(&buffer[nof_buffered], src, chunk);
+    nof_buffered += chunk;
+    src += chunk;
+    size -= chunk;
+  }
+}
+
+DCITraceReader::DCITraceReader() :
+  file(nullptr),
+  fileHeader()
+{
+
+}
+
+DCITraceReader::~DCITraceReader() {
+  close();
+}
+
+bool DCITraceReader::open(const std::string& filename) {
+  close();
+  file = fopen(filename.c_str(), "rb");
+  if(file == nullptr) {
+    return false;
+  }
+  memset(&fileHeader, 0, sizeof(fileHeader));
+  if(fread(&fileHeader, sizeof(fileHeader), 1, file) != 1 ||
+     fileHeader.magic != DCI_TRACE_MAGIC ||
+     fileHeader.version > DCI_TRACE_VERSION ||
+     fileHeader.file_header_size < sizeof(DCITraceFileHeader)) {
+    close();
+    return false;
+  }
+  // skip extensions of the file header
+  if(fseek(file, fileHeader.file_header_size, SEEK_SET) != 0) {
+    close();
+    return false;
+  }
+  return true;
+}
+
+void DCITraceReader::close() {
+  if(file != nullptr) {
+    fclose(file);
+    file = nullptr;
+  }
+}
+
+bool DCITraceReader::next(DCITraceSubframeHeader& header, std::vector<DCITraceRecord>& records) {
+  records.clear();
+  if(file == nullptr) {
+    return false;
+  }
+  if(!readSized(&header, sizeof(header), fileHeader.subframe_header_size)) {
+    return false;
+  }
+  records.resize(header.nof_dci);
+  for(uint32_t i = 0; i < header.nof_dci; i++) {
+    if(!readSized(&records[i], sizeof(DCITraceRecord), fileHeader.record_size)) {
+      records.clear();
+      return false;
+    }
+  }
+  return true;
+}
+
+const DCITraceFileHeader& DCITraceReader::getFileHeader() const {
+  return fileHeader;
+}
+
+// Reads an element stored with file_size bytes into a struct of dst_size bytes.
+// Missing fields are zeroed, unknown trailing fields are skipped.
+bool DCITraceReader::readSized(void* dst, size_t dst_size, size_t file_size) {
+  memset(dst, 0, dst_size);
+  size_t n = std::min(dst_size, file_size);
+  if(fread(dst, 1, n, file) != n) {
+    return false;
+  }
+  if(file_size > n && fseek(file, static_cast<long>(file_size - n), SEEK_CUR) != 0) {
+    return false;
+  }
+  return true;
+}
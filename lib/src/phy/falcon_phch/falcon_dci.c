@@ -25,6 +25,7 @@
 #include <stdio.h>
 #include <string.h>
 #include <strings.h>
+#include <pthread.h>
 
 
 #include "falcon/phy/falcon_phch/falcon_dci.h"
@@ -259,10 +260,12 @@ int srslte_dci_msg_to_trace_timestamp(srslte_dci_msg_t *msg,
       if(crc_is_crnti == true) {  // HARQ only for C-RNTI
         // We know, last_dl_tbs needs to be saved on a per-RNTI basis.
         // However, we maintain OWLs initial behaviour here
-//TODO: Fix rance condition upon multithreaded processing
-//FIXME: Any instance of DCICollection writes/reads this variable !!
+        // Any instance of DCICollection writes/reads this variable, possibly
+        // from several subframe worker threads at once.
         static int32_t last_dl_tbs[8][SRSLTE_MAX_CODEWORDS] = {{0}};
+        static pthread_mutex_t last_dl_tbs_mutex = PTHREAD_MUTEX_INITIALIZER;
 
+        pthread_mutex_lock(&last_dl_tbs_mutex);
         // Set last TBS for this TB (pid) in case of mcs>28 (7.1.7.2 of 36.213)
         for (int i=0;i<SRSLTE_MAX_CODEWORDS;i++) {
           if (dl_grant->mcs[i].idx > 28) {
@@ -275,6 +278,7 @@ int srslte_dci_msg_to_trace_timestamp(srslte_dci_msg_t *msg,
           // save it for next time
           last_dl_tbs[dl_dci->harq_process][i] = dl_grant->mcs[i].tbs;
         }
+        pthread_mutex_unlock(&last_dl_tbs_mutex);
       }
       // End CNI Fix
 
@@ -0,0 +1,135 @@
+/*
+ * Copyright (c) 2019 Robert Falkenberg.
+ *
+ * This file is part of FALCON
+ * (see https://github.com/falkenber9/falcon).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <strings.h>
+
+#include "falcon/phy/falcon_phch/falcon_occupancy_gate.h"
+
+#include "srslte/phy/utils/debug.h"
+
+void falcon_occupancy_gate_init(falcon_occupancy_gate_t *q) {
+  bzero(q, sizeof(falcon_occupancy_gate_t));
+  // spread of |LLR| is about 0.57 for noise and approaches 0 for clean QPSK
+  for (uint32_t l = 0; l < FALCON_OCCUPANCY_NOF_LEVELS; l++) {
+    q->weights[l][0] = 4.0f;
+    q->weights[l][2] = -8.0f;
+  }
+}
+
+int falcon_occupancy_gate_load(falcon_occupancy_gate_t *q, const char *filename) {
+  FILE *f = fopen(filename, "r");
+  if (f == NULL) {
+    ERROR("Could not open occupancy model %s\n", filename);
+    return SRSLTE_ERROR;
+  }
+  falcon_occupancy_gate_t model;
+  uint32_t nof_levels = 0;
+  char line[256];
+  while (fgets(line, sizeof(line), f) != NULL) {
+    if (line[0] == '#' || line[0] == '\n') {
+      continue;
+    }
+    unsigned int l;
+    float w[FALCON_OCCUPANCY_NOF_FEATURES];
+    if (sscanf(line, "%u %f %f %f %f", &l, &w[0], &w[1], &w[2], &w[3]) != 1 + FALCON_OCCUPANCY_NOF_FEATURES ||
+        l >= FALCON_OCCUPANCY_NOF_LEVELS) {
+      ERROR("Invalid line in occupancy model %s: %s", filename, line);
+      fclose(f);
+      return SRSLTE_ERROR;
+    }
+    for (uint32_t i = 0; i < FALCON_OCCUPANCY_NOF_FEATURES; i++) {
+      model.weights[l][i] = w[i];
+    }
+    nof_levels |= 1u << l;
+  }
+  fclose(f);
+  if (nof_levels != (1u << FALCON_OCCUPANCY_NOF_LEVELS) - 1) {
+    ERROR("Occupancy model %s does not cover all aggregation levels\n", filename);
+    return SRSLTE_ERROR;
+  }
+  *q = model;
+  return SRSLTE_SUCCESS;
+}
+
+int falcon_occupancy_gate_save(const falcon_occupancy_gate_t *q, const char *filename) {
+  FILE *f = fopen(filename, "w");
+  if (f == NULL) {
+    ERROR("Could not open occupancy model %s\n", filename);
+    return SRSLTE_ERROR;
+  }
+  fprintf(f, "# l w_bias w_power w_spread w_relative_power\n");
+  for (uint32_t l = 0; l < FALCON_OCCUPANCY_NOF_LEVELS; l++) {
+    fprintf(f, "%u %f %f %f %f\n", l, q->weights[l][0], q->weights[l][1], q->weights[l][2], q->weights[l][3]);
+  }
+  fclose(f);
+  return SRSLTE_SUCCESS;
+}
+
+void falcon_occupancy_features(const falcon_dci_location_t *location, float *features) {
+  features[0] = 1.0f;
+  features[1] = location->power;
+  features[2] = location->spread;
+  features[3] = location->relative_power;
+}
+
+float falcon_occupancy_gate_predict(const falcon_occupancy_gate_t *q, const falcon_dci_location_t *location) {
+  float features[FALCON_OCCUPANCY_NOF_FEATURES];
+  falcon_occupancy_features(location, features);
+  const float *w = q->weights[location->L % FALCON_OCCUPANCY_NOF_LEVELS];
+  float z = 0;
+  for (uint32_t i = 0; i < FALCON_OCCUPANCY_NOF_FEATURES; i++) {
+    z += w[i] * features[i];
+  }
+  return 1.0f / (1.0f + expf(-z));
+}
+
+static int compare_float(const void *a, const void *b) {
+  float fa = *(const float *)a;
+  float fb = *(const float *)b;
+  return (fa > fb) - (fa < fb);
+}
+
+float falcon_occupancy_gate_threshold(float *dci_occupancy, uint32_t nof_dci, double target_recall) {
+  if (nof_dci == 0) {
+    return 0;
+  }
+  qsort(dci_occupancy, nof_dci, sizeof(float), compare_float);
+  // the nof_missed lowest occupancies fall below the threshold
+  uint32_t nof_missed = (uint32_t)floor((1.0 - target_recall) * nof_dci);
+  if (nof_missed > nof_dci - 1) {
+    nof_missed = nof_dci - 1;
+  }
+  return dci_occupancy[nof_missed];
+}
+
+void falcon_occupancy_gate_apply(const falcon_occupancy_gate_t *q,
+                                 falcon_dci_location_t *locations,
+                                 uint32_t nof_locations)
+{
+  for (uint32_t i = 0; i < nof_locations; i++) {
+    if (locations[i].sufficient_power) {
+      locations[i].occupancy = falcon_occupancy_gate_predict(q, &locations[i]);
+    }
+  }
+}
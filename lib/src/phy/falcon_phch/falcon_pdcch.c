@@ -22,6 +22,10 @@
 #include <string.h>
 #include <strings.h>
 
+#if defined(LV_HAVE_AVX512) || defined(LV_HAVE_AVX) || defined(LV_HAVE_SSE)
+#include <immintrin.h>
+#endif
+
 #include "falcon/phy/falcon_phch/falcon_pdcch.h"
 
 #include "srslte/phy/utils/bit.h"
@@ -40,6 +44,43 @@ uint32_t srslte_pdcch_nof_cce(srslte_pdcch_t *q, uint32_t cfi) {
   return NOF_CCE(cfi);
 }
 
+float falcon_pdcch_llr_abs_sum(const float *llr, uint32_t len) {
+  uint32_t i = 0;
+  float sum = 0;
+
+#if defined(LV_HAVE_AVX512)
+  __m512 acc = _mm512_setzero_ps();
+  for (; i + 16 <= len; i += 16) {
+    acc = _mm512_add_ps(acc, _mm512_abs_ps(_mm512_loadu_ps(&llr[i])));
+  }
+  sum += _mm512_reduce_add_ps(acc);
+#elif defined(LV_HAVE_AVX)
+  const __m256 abs_mask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7fffffff));
+  __m256 acc = _mm256_setzero_ps();
+  for (; i + 8 <= len; i += 8) {
+    acc = _mm256_add_ps(acc, _mm256_and_ps(_mm256_loadu_ps(&llr[i]), abs_mask));
+  }
+  __m128 acc128 = _mm_add_ps(_mm256_castps256_ps128(acc), _mm256_extractf128_ps(acc, 1));
+  acc128 = _mm_add_ps(acc128, _mm_movehl_ps(acc128, acc128));
+  acc128 = _mm_add_ss(acc128, _mm_shuffle_ps(acc128, acc128, 1));
+  sum += _mm_cvtss_f32(acc128);
+#elif defined(LV_HAVE_SSE)
+  const __m128 abs_mask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+  __m128 acc = _mm_setzero_ps();
+  for (; i + 4 <= len; i += 4) {
+    acc = _mm_add_ps(acc, _mm_and_ps(_mm_loadu_ps(&llr[i]), abs_mask));
+  }
+  acc = _mm_add_ps(acc, _mm_movehl_ps(acc, acc));
+  acc = _mm_add_ss(acc, _mm_shuffle_ps(acc, acc, 1));
+  sum += _mm_cvtss_f32(acc);
+#endif
+
+  for (; i < len; i++) {
+    sum += fabsf(llr[i]);
+  }
+  return sum;
+}
+
 /** 36.213 v9.1.1
  * Computes up to max_candidates UE-specific candidates for DCI messages and saves them
  * in the structure pointed by c.
@@ -100,14 +141,132 @@ uint32_t srslte_pdcch_ue_locations_check(srslte_pdcch_t *q, uint32_t nsubframe,
 
 
 
-/** Tries to decode a DCI message from the LLRs stored in the srslte_pdcch_t structure by the function
-  * srslte_pdcch_extract_llr(). This function can be called multiple times.
-  * The decoded message is stored in msg and the CRC remainder in crc_rem pointer
-  *
-  * Note: This function is identical to srslte_pdcch_decode_msg(..., 0.5), however
-  * allows other values for minimum_avg_llr_bound
-  */
-int srslte_pdcch_decode_msg_limit_avg_llr_power(srslte_pdcch_t *q,
+int falcon_pdcch_decoder_init(falcon_pdcch_decoder_t *d) {
+  int ret = SRSLTE_ERROR_INVALID_INPUTS;
+  if (d != NULL) {
+    ret = SRSLTE_ERROR;
+    bzero(d, sizeof(falcon_pdcch_decoder_t));
+
+    int poly[3] = { 0x6D, 0x4F, 0x57 };
+    if (srslte_viterbi_init(&d->decoder, SRSLTE_VITERBI_27, poly, SRSLTE_DCI_MAX_BITS + 16, true)) {
+      return ret;
+    }
+    if (srslte_crc_init(&d->crc, SRSLTE_LTE_CRC16, 16)) {
+      srslte_viterbi_free(&d->decoder);
+      return ret;
+    }
+    falcon_viterbi_init(&d->list_decoder);
+    d->list_size = 1;
+    ret = SRSLTE_SUCCESS;
+  }
+  return ret;
+}
+
+void falcon_pdcch_decoder_free(falcon_pdcch_decoder_t *d) {
+  if (d != NULL) {
+    srslte_viterbi_free(&d->decoder);
+    bzero(d, sizeof(falcon_pdcch_decoder_t));
+  }
+}
+
+void falcon_pdcch_decoder_set_list_viterbi(falcon_pdcch_decoder_t *d, uint32_t list_size, float min_reliability) {
+  if (d != NULL) {
+    d->list_size = SRSLTE_MAX(1, SRSLTE_MIN(list_size, FALCON_VITERBI_MAX_LIST));
+    d->min_reliability = min_reliability;
+  }
+}
+
+void falcon_pdcch_decoder_set_rnti_filter(falcon_pdcch_decoder_t *d, falcon_pdcch_rnti_filter_t filter, void *arg) {
+  if (d != NULL) {
+    d->rnti_filter = filter;
+    d->rnti_filter_arg = arg;
+  }
+}
+
+static uint16_t falcon_pdcch_crc_rem(falcon_pdcch_decoder_t *d, uint8_t *data, uint32_t nof_bits) {
+  uint8_t *x = &data[nof_bits];
+  uint16_t p_bits = (uint16_t) srslte_bit_pack(&x, 16);
+  uint16_t crc_res = ((uint16_t) srslte_crc_checksum(&d->crc, data, nof_bits) & 0xffff);
+  return p_bits ^ crc_res;
+}
+
+/* List Viterbi decoding of the rate-dematched bits in d->rm_f */
+static void falcon_pdcch_list_decode(falcon_pdcch_decoder_t *d, uint8_t *data, uint32_t nof_bits, uint16_t *crc) {
+  uint8_t *list[FALCON_VITERBI_MAX_LIST];
+  float reliability[FALCON_VITERBI_MAX_LIST];
+  for (uint32_t i = 0; i < d->list_size; i++) {
+    list[i] = d->list_data[i];
+  }
+  int n = falcon_viterbi_decode_list(&d->list_decoder, d->rm_f, nof_bits + 16, d->min_reliability, list, reliability, d->list_size);
+  if (n <= 0) {
+    // abandoned: hopeless candidate
+    bzero(data, sizeof(uint8_t) * (nof_bits + 16));
+    if (crc) {
+      *crc = FALCON_ILLEGAL_RNTI;
+    }
+    return;
+  }
+
+  uint32_t selected = 0;
+  uint16_t rnti = falcon_pdcch_crc_rem(d, list[0], nof_bits);
+  if (d->rnti_filter != NULL && n > 1 && !d->rnti_filter(d->rnti_filter_arg, rnti)) {
+    for (uint32_t i = 1; i < (uint32_t) n && reliability[0] - reliability[i] <= FALCON_PDCCH_LIST_TIE_MARGIN; i++) {
+      uint16_t alt = falcon_pdcch_crc_rem(d, list[i], nof_bits);
+      if (d->rnti_filter(d->rnti_filter_arg, alt)) {
+        DEBUG("List Viterbi: survivor %d (rnti 0x%x) preferred over 0x%x\n", i, alt, rnti);
+        selected = i;
+        rnti = alt;
+        break;
+      }
+    }
+  }
+  memcpy(data, list[selected], sizeof(uint8_t) * (nof_bits + 16));
+  if (crc) {
+    *crc = rnti;
+  }
+}
+
+/* Equivalent to srslte_pdcch_dci_decode(), but uses the decoder state of d instead of q */
+static int falcon_pdcch_dci_decode(srslte_pdcch_t *q, falcon_pdcch_decoder_t *d, float *e, uint8_t *data, uint32_t E, uint32_t nof_bits, uint16_t *crc) {
+
+  uint16_t p_bits, crc_res;
+  uint8_t *x;
+
+  if (q         != NULL         &&
+      d         != NULL         &&
+      data      != NULL         &&
+      E         <= q->max_bits  &&
+      nof_bits  <= SRSLTE_DCI_MAX_BITS)
+    {
+      bzero(d->rm_f, sizeof(float)*3 * (SRSLTE_DCI_MAX_BITS + 16));
+
+      /* unrate matching */
+      srslte_rm_conv_rx(e, E, d->rm_f, 3 * (nof_bits + 16));
+
+      if (d->list_size > 1 || d->min_reliability > 0) {
+        falcon_pdcch_list_decode(d, data, nof_bits, crc);
+        return SRSLTE_SUCCESS;
+      }
+
+      /* viterbi decoder */
+      srslte_viterbi_decode_f(&d->decoder, d->rm_f, data, nof_bits + 16);
+
+      x = &data[nof_bits];
+      p_bits = (uint16_t) srslte_bit_pack(&x, 16);
+      crc_res = ((uint16_t) srslte_crc_checksum(&d->crc, data, nof_bits) & 0xffff);
+      if (crc) {
+        *crc = p_bits ^ crc_res;
+      }
+      return SRSLTE_SUCCESS;
+    } else {
+      fprintf(stderr, "Invalid parameters: E: %d, max_bits: %d, nof_bits: %d\n", E, q ? q->max_bits : 0, nof_bits);
+      return SRSLTE_ERROR_INVALID_INPUTS;
+    }
+}
+
+/* Decodes with the decoder state of q if d is NULL */
+static int pdcch_decode_msg_limit_avg_llr_power(srslte_pdcch_t *q,
+                                                falcon_pdcch_decoder_t *d,
                                                 srslte_dci_msg_t *msg,
                                                 falcon_dci_location_t *location,
                                                 srslte_dci_format_t format,
@@ -130,14 +289,15 @@ int srslte_pdcch_decode_msg_limit_avg_llr_power(srslte_pdcch_t *q,
           uint32_t nof_bits = srslte_dci_format_sizeof(format, q->cell.nof_prb, q->cell.nof_ports);
           uint32_t e_bits = PDCCH_FORMAT_NOF_BITS(location->L);
 
-          double mean = 0;
-          for (uint32_t i=0;i<e_bits;i++) {
-              mean += fabsf(q->llr[location->ncce * 72 + i]);
-            }
-          mean /= e_bits;
+          double mean = falcon_pdcch_llr_abs_sum(&q->llr[location->ncce * 72], e_bits) / e_bits;
           if (mean > minimum_avg_llr_bound) {
-              ret = srslte_pdcch_dci_decode(q, &q->llr[location->ncce * 72],
-                  msg->data, e_bits, nof_bits, crc_rem);
+              if (d != NULL) {
+                  ret = falcon_pdcch_dci_decode(q, d, &q->llr[location->ncce * 72],
+                      msg->data, e_bits, nof_bits, crc_rem);
+                } else {
+                  ret = srslte_pdcch_dci_decode(q, &q->llr[location->ncce * 72],
+                      msg->data, e_bits, nof_bits, crc_rem);
+                }
               if (ret == SRSLTE_SUCCESS) {
                   msg->nof_bits = nof_bits;
                   // Check format differentiation
@@ -164,6 +324,123 @@ int srslte_pdcch_decode_msg_limit_avg_llr_power(srslte_pdcch_t *q,
   return ret;
 }
 
+/** Tries to decode a DCI message from the LLRs stored in the srslte_pdcch_t structure by the function
+  * srslte_pdcch_extract_llr(). This function can be called multiple times.
+  * The decoded message is stored in msg and the CRC remainder in crc_rem pointer
+  *
+  * Note: This function is identical to srslte_pdcch_decode_msg(..., 0.5), however
+  * allows other values for minimum_avg_llr_bound
+  */
+int srslte_pdcch_decode_msg_limit_avg_llr_power(srslte_pdcch_t *q,
+                                                srslte_dci_msg_t *msg,
+                                                falcon_dci_location_t *location,
+                                                srslte_dci_format_t format,
+                                                uint32_t cfi,
+                                                uint16_t *crc_rem,
+                                                double minimum_avg_llr_bound)
+{
+  return pdcch_decode_msg_limit_avg_llr_power(q, NULL, msg, location, format, cfi, crc_rem, minimum_avg_llr_bound);
+}
+
+/** Same as srslte_pdcch_decode_msg_limit_avg_llr_power(), but all decoder state is taken from d.
+  * Multiple threads may decode from the same q concurrently, as long as each uses its own d.
+  */
+int falcon_pdcch_decode_msg_limit_avg_llr_power(srslte_pdcch_t *q,
+                                                falcon_pdcch_decoder_t *d,
+                                                srslte_dci_msg_t *msg,
+                                                falcon_dci_location_t *location,
+                                                srslte_dci_format_t format,
+                                                uint32_t cfi,
+                                                uint16_t *crc_rem,
+                                                double minimum_avg_llr_bound)
+{
+  return pdcch_decode_msg_limit_avg_llr_power(q, d, msg, location, format, cfi, crc_rem, minimum_avg_llr_bound);
+}
+
+void falcon_pdcch_dci_msg_set_format(srslte_dci_msg_t *msg, srslte_dci_format_t format) {
+  // Check format differentiation
+  if (format == SRSLTE_DCI_FORMAT0 || format == SRSLTE_DCI_FORMAT1A) {
+    msg->format = (msg->data[0] == 0)?SRSLTE_DCI_FORMAT0:SRSLTE_DCI_FORMAT1A;
+  } else {
+    msg->format = format;
+  }
+}
+
+/** Decodes the DCI candidate at location for all given formats. The average LLR power of the location
+  * is computed once. Formats with the same payload size (e.g. 0/1A) share a single Viterbi run, since
+  * rate dematching and decoding only depend on the number of bits.
+  * If the average LLR power is below minimum_avg_llr_bound, msgs and crc_rem are left untouched.
+  */
+int falcon_pdcch_decode_msg_multi(srslte_pdcch_t *q,
+                                  falcon_pdcch_decoder_t *d,
+                                  falcon_dci_location_t *location,
+                                  const srslte_dci_format_t *formats,
+                                  uint32_t nof_formats,
+                                  uint32_t cfi,
+                                  srslte_dci_msg_t **msgs,
+                                  uint16_t **crc_rem,
+                                  double minimum_avg_llr_bound)
+{
+  int ret = SRSLTE_ERROR_INVALID_INPUTS;
+  if (q                 != NULL       &&
+      d                 != NULL       &&
+      formats           != NULL       &&
+      msgs              != NULL       &&
+      crc_rem           != NULL       &&
+      falcon_dci_location_isvalid(location))
+    {
+      if (location->ncce * 72 + PDCCH_FORMAT_NOF_BITS(location->L) >
+          NOF_CCE(cfi)*72) {
+          fprintf(stderr, "Invalid location: nCCE: %d, L: %d, NofCCE: %d\n",
+                  location->ncce, location->L, NOF_CCE(cfi));
+        } else {
+          ret = 0;
+
+          uint32_t e_bits = PDCCH_FORMAT_NOF_BITS(location->L);
+          float *e = &q->llr[location->ncce * 72];
+
+          // prefer the location power derived by srslte_pdcch_cce_avg_llr_power
+          double mean = location->power;
+          if (mean <= 0) {
+              mean = falcon_pdcch_llr_abs_sum(e, e_bits) / e_bits;
+            }
+          if (mean <= minimum_avg_llr_bound) {
+              DEBUG("Skipping DCI:  nCCE=%d, L=%d, mean=%f\n", location->ncce, location->L, mean);
+              return ret;
+            }
+
+          uint32_t nof_bits[nof_formats];
+          for (uint32_t f=0; f<nof_formats; f++) {
+              nof_bits[f] = srslte_dci_format_sizeof(formats[f], q->cell.nof_prb, q->cell.nof_ports);
+
+              // reuse the result of a previous format with equal payload size
+              uint32_t prev = 0;
+              while (prev < f && nof_bits[prev] != nof_bits[f]) {
+                  prev++;
+                }
+              if (prev < f) {
+                  memcpy(msgs[f]->data, msgs[prev]->data, sizeof(uint8_t) * (nof_bits[f] + 16));
+                  *crc_rem[f] = *crc_rem[prev];
+                } else {
+                  if (falcon_pdcch_dci_decode(q, d, e, msgs[f]->data, e_bits, nof_bits[f], crc_rem[f]) != SRSLTE_SUCCESS) {
+                      fprintf(stderr, "Error calling pdcch_dci_decode\n");
+                      return SRSLTE_ERROR;
+                    }
+                  ret++;
+                }
+
+              msgs[f]->nof_bits = nof_bits[f];
+              falcon_pdcch_dci_msg_set_format(msgs[f], formats[f]);
+              DEBUG("Decoded DCI: nCCE=%d, L=%d, format=%s, msg_len=%d, mean=%f, crc_rem=0x%x\n",
+                    location->ncce, location->L, srslte_dci_format_string(formats[f]), nof_bits[f], mean, *crc_rem[f]);
+            }
+        }
+    } else {
+      fprintf(stderr, "Invalid parameters, location=%d,%d\n", location ? location->ncce : 0, location ? location->L : 0);
+    }
+  return ret;
+}
+
 /**
  * @brief srslte_pdcch_generic_locations_ncce Wrapper function for computation of DCI
  * message candidates in ue/common search space. The search space is selected by the
@@ -244,6 +521,80 @@ uint32_t srslte_pdcch_validate_location(uint32_t nof_cce, uint32_t ncce, uint32_
   return is_valid;
 }
 
+static const uint32_t search_space_offset[4] = {0, 88, 132, 154};
+
+static inline bool search_space_get(const falcon_search_space_entry_t *e, uint32_t ncce, uint32_t l) {
+  uint32_t bit = search_space_offset[l] + (ncce >> l);
+  return (e->mask[bit / 64] >> (bit % 64)) & 1;
+}
+
+static inline void search_space_set(falcon_search_space_entry_t *e, uint32_t ncce, uint32_t l) {
+  uint32_t bit = search_space_offset[l] + (ncce >> l);
+  e->mask[bit / 64] |= (uint64_t)1 << (bit % 64);
+}
+
+int falcon_search_space_cache_init(falcon_search_space_cache_t *c) {
+  int ret = SRSLTE_ERROR_INVALID_INPUTS;
+  if (c != NULL) {
+    ret = SRSLTE_ERROR;
+    bzero(c, sizeof(falcon_search_space_cache_t));
+    c->entries = calloc(FALCON_SEARCH_SPACE_CACHE_SIZE, sizeof(falcon_search_space_entry_t));
+    if (c->entries) {
+      ret = SRSLTE_SUCCESS;
+    }
+  }
+  return ret;
+}
+
+void falcon_search_space_cache_free(falcon_search_space_cache_t *c) {
+  if (c != NULL) {
+    free(c->entries);
+    bzero(c, sizeof(falcon_search_space_cache_t));
+  }
+}
+
+uint32_t falcon_search_space_cache_validate_location(falcon_search_space_cache_t *c,
+                                                     uint32_t nof_cce, uint32_t ncce, uint32_t l,
+                                                     uint32_t nsubframe, uint16_t rnti)
+{
+  if (c == NULL || c->entries == NULL || l > 3 || nsubframe > 9 || nof_cce > MAX_NUM_OF_CCE) {
+    return srslte_pdcch_validate_location(nof_cce, ncce, l, nsubframe, rnti);
+  }
+
+  // candidates of level l always start at multiples of 2^l
+  if (ncce >= nof_cce || (ncce & ((1u << l) - 1)) != 0) {
+    return 0;
+  }
+
+  uint32_t tag = 0x80000000 | ((uint32_t)nof_cce << 20) | (nsubframe << 16) | rnti;
+  uint32_t idx = ((uint32_t)rnti * 10 + nsubframe + nof_cce * 7919) & (FALCON_SEARCH_SPACE_CACHE_SIZE - 1);
+  falcon_search_space_entry_t *e = &c->entries[idx];
+
+  if (e->tag != tag) {
+    srslte_dci_location_t loc[MAX_CANDIDATES_UE];
+    uint32_t num_candidates = srslte_pdcch_generic_locations_ncce(nof_cce, loc, MAX_CANDIDATES_UE, nsubframe, rnti);
+    bzero(e->mask, sizeof(e->mask));
+    for (uint32_t i = 0; i < num_candidates; i++) {
+      if (loc[i].L <= 3) {
+        search_space_set(e, loc[i].ncce, loc[i].L);
+      }
+    }
+    e->tag = tag;
+    c->nof_misses++;
+  } else {
+    c->nof_hits++;
+  }
+
+  if (!search_space_get(e, ncce, l)) {
+    return 0;
+  }
+  // ambiguous, if a candidate of level l-1 starts at the same CCE
+  if (l > 0 && search_space_get(e, ncce, l - 1)) {
+    return 1;
+  }
+  return 2;
+}
+
 /** 36.213 v9.1.1
  * Computes up to max_candidates UE-specific candidates for DCI messages and saves them
  * in the structure pointed by c.
@@ -265,11 +616,11 @@ uint32_t srslte_pdcch_ue_locations_all(srslte_pdcch_t *q, falcon_dci_location_t
           c[k].used = 0;
           c[k].checked = 0;
           c[k].sufficient_power = 1;
+          c[k].occupancy = 1;
+          c[k].spread = 0;
+          c[k].relative_power = 0;
           if (l == 0) {
-              float mean = 0;
-              for (j=0;j<PDCCH_FORMAT_NOF_BITS(c[k].L);j++) {
-                  mean += fabsf(q->llr[(c[k].ncce) * 72 + j]);
-                }
+              float mean = falcon_pdcch_llr_abs_sum(&q->llr[(c[k].ncce) * 72], PDCCH_FORMAT_NOF_BITS(c[k].L));
               mean /= PDCCH_FORMAT_NOF_BITS(c[k].L);
               DEBUG("power %f\n",mean);
               c[k].power = mean;
@@ -330,6 +681,9 @@ uint32_t srslte_pdcch_ue_locations_all_map(srslte_pdcch_t *q, falcon_dci_locatio
         c[k].L = (uint32_t)l;
         c[k].ncce = (L) * (i % (NOF_CCE(cfi) / (L)));
         c[k].power = 0;
+        c[k].spread = 0;
+        c[k].relative_power = 0;
+        c[k].occupancy = 1;
         c[k].used = 0;
         c[k].occupied = 0;
         c[k].checked = 0;
@@ -590,12 +944,23 @@ int srslte_pdcch_cce_avg_llr_power(srslte_pdcch_t *q,
   uint32_t num_cce_bits = PDCCH_FORMAT_NOF_BITS(0);
   if (q != NULL &&
       cce_map != NULL) {
-      for(uint32_t cce_idx = 0; cce_idx < NOF_CCE(cfi) && cce_idx < max_cce; cce_idx++) {
-          double mean = 0;
-          for (int i = 0; i < num_cce_bits; i++) {
-              mean += fabsf(q->llr[cce_idx * 72 + i]);
+      uint32_t nof_cce = SRSLTE_MIN(SRSLTE_MIN(NOF_CCE(cfi), max_cce), MAX_NUM_OF_CCE);
+      float power_sum[MAX_NUM_OF_CCE + 1];  // prefix sums of CCE power
+      float power2_sum[MAX_NUM_OF_CCE + 1];
+      power_sum[0] = 0;
+      power2_sum[0] = 0;
+
+      // single pass over the LLRs of all CCEs
+      for(uint32_t cce_idx = 0; cce_idx < nof_cce; cce_idx++) {
+          const float *llr = &q->llr[cce_idx * 72];
+          float sq_sum = 0;
+          for(uint32_t i = 0; i < num_cce_bits; i++) {
+              sq_sum += llr[i] * llr[i];
             }
-          cce_map[cce_idx].power = mean / num_cce_bits;
+          cce_map[cce_idx].power = falcon_pdcch_llr_abs_sum(llr, num_cce_bits) / num_cce_bits;
+          cce_map[cce_idx].power2 = sq_sum / num_cce_bits;
+          power_sum[cce_idx + 1] = power_sum[cce_idx] + cce_map[cce_idx].power;
+          power2_sum[cce_idx + 1] = power2_sum[cce_idx] + cce_map[cce_idx].power2;
           if(cce_map[cce_idx].power < DCI_MINIMUM_AVG_LLR_BOUND) {
               for(int aggr_idx=0; aggr_idx<4; aggr_idx++) {
                   falcon_dci_location_t* parent = cce_map[cce_idx].location[aggr_idx];
@@ -603,6 +968,23 @@ int srslte_pdcch_cce_avg_llr_power(srslte_pdcch_t *q,
                 }
             }
         }
+
+      // power of each location is the average of its CCEs
+      float avg_power = nof_cce > 0 ? power_sum[nof_cce] / nof_cce : 0;
+      for(uint32_t cce_idx = 0; cce_idx < nof_cce; cce_idx++) {
+          for(uint32_t aggr_idx=0; aggr_idx<4; aggr_idx++) {
+              falcon_dci_location_t* parent = cce_map[cce_idx].location[aggr_idx];
+              if(parent && parent->ncce == cce_idx) {
+                  uint32_t end = SRSLTE_MIN(cce_idx + PDCCH_FORMAT_NOF_CCE(aggr_idx), nof_cce);
+                  float power = (power_sum[end] - power_sum[cce_idx]) / PDCCH_FORMAT_NOF_CCE(aggr_idx);
+                  float power2 = (power2_sum[end] - power2_sum[cce_idx]) / PDCCH_FORMAT_NOF_CCE(aggr_idx);
+                  parent->power = power;
+                  // occupancy features
+                  parent->spread = power > 0 ? (power2 - power * power) / (power * power) : 0;
+                  parent->relative_power = avg_power > 0 ? power / avg_power : 0;
+                }
+            }
+        }
       ret = SRSLTE_SUCCESS;
     }
   return ret;
@@ -0,0 +1,181 @@
+/*
+ * Copyright (c) 2019 Robert Falkenberg.
+ *
+ * This file is part of FALCON
+ * (see https://github.com/falkenber9/falcon).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ */
+
+#include <math.h>
+#include <string.h>
+#include <strings.h>
+
+#include "falcon/phy/falcon_phch/falcon_viterbi.h"
+
+#define MIN_BITS (FALCON_VITERBI_K - 1)
+
+static const uint32_t falcon_viterbi_poly[3] = { 0x6D, 0x4F, 0x57 };
+
+void falcon_viterbi_init(falcon_viterbi_t *q) {
+  bzero(q, sizeof(falcon_viterbi_t));
+  // Butterfly p: states p and p+32 lead to states 2p and 2p+1. All polynomials tap the
+  // newest and the oldest bit of the register, so the four transitions only differ
+  // in the sign of the coded bits of register 2p (from state p with input 0).
+  for (uint32_t p = 0; p < FALCON_VITERBI_NOF_STATES / 2; p++) {
+    for (uint32_t j = 0; j < 3; j++) {
+      q->sign[j][p] = __builtin_parity((2 * p) & falcon_viterbi_poly[j]) ? 1.0f : -1.0f;
+    }
+  }
+}
+
+void falcon_viterbi_encode(const uint8_t *input, uint8_t *output, uint32_t nof_bits) {
+  if (nof_bits < MIN_BITS) {
+    return;
+  }
+  // tail-biting: the register starts with the last K-1 bits of the message
+  uint32_t reg = 0;
+  for (uint32_t i = nof_bits - MIN_BITS; i < nof_bits; i++) {
+    reg = (reg << 1) | (input[i] & 1);
+  }
+  for (uint32_t i = 0; i < nof_bits; i++) {
+    reg = ((reg << 1) | (input[i] & 1)) & (2 * FALCON_VITERBI_NOF_STATES - 1);
+    for (uint32_t j = 0; j < 3; j++) {
+      output[3 * i + j] = (uint8_t) __builtin_parity(reg & falcon_viterbi_poly[j]);
+    }
+  }
+}
+
+/* Traces the survivor of end_state back to the start of the message (skipping the guard).
+ * Returns the state before the first message bit. */
+static uint32_t falcon_viterbi_traceback(falcon_viterbi_t *q, uint32_t guard, uint32_t nof_bits, uint32_t end_state, uint8_t *data) {
+  uint32_t state = end_state;
+  for (uint32_t t = guard + nof_bits; t-- > guard; ) {
+    data[t - guard] = (uint8_t)(state & 1);
+    state = (state >> 1) | ((uint32_t) q->decisions[t][state] << (MIN_BITS - 1));
+  }
+  return state;
+}
+
+int falcon_viterbi_decode_list(falcon_viterbi_t *q,
+                               const float *llr,
+                               uint32_t nof_bits,
+                               float min_reliability,
+                               uint8_t **data,
+                               float *reliability,
+                               uint32_t list_size)
+{
+  if (q == NULL || llr == NULL || data == NULL ||
+      nof_bits < MIN_BITS || nof_bits > FALCON_VITERBI_MAX_BITS ||
+      list_size == 0) {
+    return SRSLTE_ERROR_INVALID_INPUTS;
+  }
+  if (list_size > FALCON_VITERBI_MAX_LIST) {
+    list_size = FALCON_VITERBI_MAX_LIST;
+  }
+
+  // The trellis starts with the last bits of the message (wrap-around),
+  // so that the unknown start state has settled when the message begins.
+  uint32_t guard = nof_bits < FALCON_VITERBI_GUARD ? nof_bits : FALCON_VITERBI_GUARD;
+  uint32_t nof_steps = guard + nof_bits;
+  // checkpoints only in the second half; short paths through noise match too well
+  uint32_t first_check = nof_steps / 2;
+
+  float *cur = q->metric[0];
+  float *next = q->metric[1];
+  bzero(cur, sizeof(float) * FALCON_VITERBI_NOF_STATES);
+  float abs_sum = 0;
+
+  for (uint32_t t = 0; t < nof_steps; t++) {
+    uint32_t k = t < guard ? nof_bits - guard + t : t - guard;
+    const float *s = &llr[3 * k];
+
+    // branch metric (correlation) of the transitions p -> 2p
+    float bm[FALCON_VITERBI_NOF_STATES / 2];
+    for (uint32_t p = 0; p < FALCON_VITERBI_NOF_STATES / 2; p++) {
+      bm[p] = q->sign[0][p] * s[0] + q->sign[1][p] * s[1] + q->sign[2][p] * s[2];
+    }
+    abs_sum += fabsf(s[0]) + fabsf(s[1]) + fabsf(s[2]);
+
+    // add-compare-select, written branch-free for auto-vectorization
+    const float *restrict c = cur;
+    float *restrict n = next;
+    uint8_t *restrict decision = q->decisions[t];
+    for (uint32_t p = 0; p < FALCON_VITERBI_NOF_STATES / 2; p++) {
+      float lo = c[p];
+      float hi = c[p + FALCON_VITERBI_NOF_STATES / 2];
+      float m00 = lo + bm[p];
+      float m10 = hi - bm[p];
+      float m01 = lo - bm[p];
+      float m11 = hi + bm[p];
+      n[2 * p] = m10 > m00 ? m10 : m00;
+      n[2 * p + 1] = m11 > m01 ? m11 : m01;
+      decision[2 * p] = m10 > m00;
+      decision[2 * p + 1] = m11 > m01;
+    }
+    float *tmp = cur;
+    cur = next;
+    next = tmp;
+
+    if (min_reliability > 0 &&
+        t + 1 >= first_check &&
+        t + 1 < nof_steps &&
+        (t + 1 - first_check) % FALCON_VITERBI_CHECK_INTERVAL == 0) {
+      float best = cur[0];
+      for (uint32_t state = 1; state < FALCON_VITERBI_NOF_STATES; state++) {
+        best = best > cur[state] ? best : cur[state];
+      }
+      if (best < min_reliability * abs_sum) {
+        q->nof_early_terminations++;
+        return 0;
+      }
+    }
+  }
+
+  // Survivors that start and end in the same state are valid tail-biting codewords.
+  // Visit the end states in order of their path metric until the list is full.
+  uint32_t n = 0;
+  uint32_t best_state = 0;
+  uint64_t visited = 0;
+  for (uint32_t i = 0; i < FALCON_VITERBI_MAX_VISITED && n < list_size; i++) {
+    uint32_t end_state = 0;
+    float end_metric = -INFINITY;
+    for (uint32_t state = 0; state < FALCON_VITERBI_NOF_STATES; state++) {
+      if (!(visited & (1ULL << state)) && cur[state] > end_metric) {
+        end_state = state;
+        end_metric = cur[state];
+      }
+    }
+    visited |= 1ULL << end_state;
+    if (i == 0) {
+      best_state = end_state;
+    }
+    if (falcon_viterbi_traceback(q, guard, nof_bits, end_state, data[n]) == end_state) {
+      if (reliability != NULL) {
+        reliability[n] = abs_sum > 0 ? end_metric / abs_sum : 0;
+      }
+      n++;
+    }
+  }
+  // no tail-biting survivor: fall back to the best path
+  if (n == 0) {
+    falcon_viterbi_traceback(q, guard, nof_bits, best_state, data[0]);
+    if (reliability != NULL) {
+      reliability[0] = abs_sum > 0 ? cur[best_state] / abs_sum : 0;
+    }
+    n = 1;
+  }
+  return (int) n;
+}
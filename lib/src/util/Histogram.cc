@@ -21,18 +21,27 @@
 #include "falcon/util/Histogram.h"
 
 #include <cstdlib>
+#include <algorithm>
 #include <string.h>
 #include <strings.h>
 
-Histogram::Histogram(uint32_t _itemCount, uint32_t _valueRange) :
+Histogram::Histogram(uint32_t _itemCount, uint32_t _valueRange, bool _runLengthEncoded, uint32_t _denseRange) :
   //rnti_history_active_users(0),
-  rnti_histogram(_valueRange, 0),
-  rnti_history(_itemCount, 0),
+  rnti_histogram(std::min(_valueRange, _denseRange), 0),
+  denseRange(std::min(_valueRange, _denseRange)),
+  sparse(denseRange < _valueRange ? HISTOGRAM_SPARSE_MIN_CAPACITY : 0),
+  sparse_used(0),
+  rnti_history(_runLengthEncoded ? 0 : _itemCount, 0),
   rnti_history_current(0),
   rnti_history_end(_itemCount),
   rnti_histogram_ready(false),
   itemCount(_itemCount),
-  valueRange(_valueRange)
+  valueRange(_valueRange),
+  runLengthEncoded(_runLengthEncoded),
+  runs(_runLengthEncoded ? _itemCount + 2 : 0),  // each run holds at least one item
+  runs_head(0),
+  nof_runs(0),
+  nof_items(0)
 {
 //  initBuffers();
 }
@@ -68,35 +77,91 @@ void Histogram::add(uint16_t item) {
 }
 
 void Histogram::add(uint16_t item, uint32_t nTimes) {
-  while(nTimes-- > 0) {
+  if(runLengthEncoded) {
+    addRun(item, nTimes);
+    return;
+  }
+  // process contiguous ranges of the ring at once
+  while(nTimes > 0) {
+    uint32_t chunk = std::min(nTimes, rnti_history_end - rnti_history_current);
+    uint16_t* slots = &rnti_history[rnti_history_current];
     if(rnti_histogram_ready) {
-      //    if(rnti_histogram[*h->rnti_history_current] == RNTI_HISTOGRAM_THRESHOLD) {  // this rnti is no longer in use, decrement active user counter
-      //      rnti_history_active_users--;
-      //    }
-      rnti_histogram[rnti_history[rnti_history_current]]--;    // decrement occurence counter for old rnti
-      //printf("Decremented RNTI %d to %d\n", *h->rnti_history_current, h->rnti_histogram[*h->rnti_history_current]);
+      // decrement occurence counters of old rntis, once per sequence of equal values (e.g. padding)
+      uint32_t i = 0;
+      while(i < chunk) {
+        uint16_t old = slots[i];
+        uint32_t j = i + 1;
+        while(j < chunk && slots[j] == old) {
+          j++;
+        }
+        decrement(old, j - i);
+        i = j;
+      }
     }
-    rnti_history[rnti_history_current] = item;               // add new rnti to history
-    rnti_histogram[item]++;                     // increment occurence counter for new rnti
-    //  if(rnti_histogram[item] == RNTI_HISTOGRAM_THRESHOLD) {  // this rnti reaches threshold -> increment active user counter
-    //    rnti_history_active_users++;
-    //  }
+    std::fill(slots, slots + chunk, item);      // add new rnti to history
+    increment(item, chunk);                     // increment occurence counter for new rnti
 
-    rnti_history_current++;
+    rnti_history_current += chunk;
     if(rnti_history_current == rnti_history_end) {  // set current to next element in history
       rnti_histogram_ready = true;                   // first wrap around: histogram is ready now
       rnti_history_current = 0;
     }
+    nTimes -= chunk;
+  }
+}
+
+void Histogram::addRun(uint16_t item, uint32_t nTimes) {
+  if(nTimes == 0) {
+    return;
+  }
+  uint32_t capacity = static_cast<uint32_t>(runs.size());
+  uint32_t last = (runs_head + nof_runs + capacity - 1) % capacity;
+  if(nof_runs > 0 && runs[last].item == item) {
+    runs[last].count += nTimes;
+  }
+  else {
+    Run& run = runs[(runs_head + nof_runs) % capacity];
+    run.item = item;
+    run.count = nTimes;
+    nof_runs++;
+  }
+  increment(item, nTimes);
+  nof_items += nTimes;
+  if(nof_items >= itemCount) {
+    rnti_histogram_ready = true;
+  }
+
+  // evict the oldest items beyond the window
+  while(nof_items > itemCount) {
+    Run& oldest = runs[runs_head];
+    uint32_t evict = std::min(oldest.count, nof_items - itemCount);
+    decrement(oldest.item, evict);
+    oldest.count -= evict;
+    nof_items -= evict;
+    if(oldest.count == 0) {
+      runs_head = (runs_head + 1) % capacity;
+      nof_runs--;
+    }
   }
 }
 
 uint32_t Histogram::getFrequency(uint16_t item) const {
-  return rnti_histogram[item];
+  if(item < denseRange) {
+    return rnti_histogram[item];
+  }
+  uint32_t idx = sparseFind(item);
+  return sparse[idx].count;
 }
 
-const uint32_t* Histogram::getFrequencyAll() const
-{
-  return rnti_histogram.data();
+void Histogram::accumulate(uint32_t* buf) const {
+  for(uint32_t i=0; i<denseRange; i++) {
+    buf[i] += rnti_histogram[i];
+  }
+  for(const SparseSlot& slot : sparse) {
+    if(slot.count > 0) {
+      buf[slot.item] += slot.count;
+    }
+  }
 }
 
 bool Histogram::ready() const {
@@ -110,3 +175,106 @@ uint32_t Histogram::getItemCount() const {
 uint32_t Histogram::getValueRange() const {
   return valueRange;
 }
+
+bool Histogram::isRunLengthEncoded() const {
+  return runLengthEncoded;
+}
+
+uint32_t Histogram::getDenseRange() const {
+  return denseRange;
+}
+
+size_t Histogram::getMemorySize() const {
+  return rnti_histogram.size() * sizeof(uint16_t) +
+      sparse.size() * sizeof(SparseSlot) +
+      rnti_history.size() * sizeof(uint16_t) +
+      runs.size() * sizeof(Run);
+}
+
+const char* Histogram::getName() const {
+  return "histogram";
+}
+
+void Histogram::increment(uint16_t item, uint32_t n) {
+  if(n == 0) {
+    return;
+  }
+  uint16_t* count;
+  if(item < denseRange) {
+    count = &rnti_histogram[item];
+  }
+  else {
+    uint32_t idx = sparseFind(item);
+    if(sparse[idx].count == 0) {
+      // new item; keep load factor below 1/2
+      if(2 * (sparse_used + 1) > sparse.size()) {
+        sparseGrow();
+        idx = sparseFind(item);
+      }
+      sparse[idx].item = item;
+      sparse_used++;
+    }
+    count = &sparse[idx].count;
+  }
+  *count = static_cast<uint16_t>(std::min<uint32_t>(*count + n, HISTOGRAM_MAX_COUNT));
+}
+
+void Histogram::decrement(uint16_t item, uint32_t n) {
+  if(item < denseRange) {
+    rnti_histogram[item] = static_cast<uint16_t>(rnti_histogram[item] - std::min<uint32_t>(rnti_histogram[item], n));
+    return;
+  }
+  uint32_t idx = sparseFind(item);
+  if(sparse[idx].count > n) {
+    sparse[idx].count = static_cast<uint16_t>(sparse[idx].count - n);
+  }
+  else if(sparse[idx].count > 0) {
+    sparseErase(idx);
+  }
+}
+
+uint32_t Histogram::sparseHome(uint16_t item) const {
+  // Fibonacci hashing; capacity is a power of two
+  return (static_cast<uint32_t>(item) * 2654435769u) & static_cast<uint32_t>(sparse.size() - 1);
+}
+
+// index of item or of the empty slot where it would be inserted
+uint32_t Histogram::sparseFind(uint16_t item) const {
+  uint32_t mask = static_cast<uint32_t>(sparse.size() - 1);
+  uint32_t idx = sparseHome(item);
+  while(sparse[idx].count != 0 && sparse[idx].item != item) {
+    idx = (idx + 1) & mask;
+  }
+  return idx;
+}
+
+// backward-shift deletion keeps probe sequences intact without tombstones
+void Histogram::sparseErase(uint32_t idx) {
+  uint32_t mask = static_cast<uint32_t>(sparse.size() - 1);
+  uint32_t next = idx;
+  while(true) {
+    next = (next + 1) & mask;
+    if(sparse[next].count == 0) {
+      break;
+    }
+    uint32_t home = sparseHome(sparse[next].item);
+    // the entry may stay if its home lies cyclically within (idx, next]
+    bool stays = idx <= next ? (idx < home && home <= next) : (idx < home || home <= next);
+    if(!stays) {
+      sparse[idx] = sparse[next];
+      idx = next;
+    }
+  }
+  sparse[idx].count = 0;
+  sparse_used--;
+}
+
+void Histogram::sparseGrow() {
+  std::vector<SparseSlot> old(2 * sparse.size());
+  old.swap(sparse);
+  for(const SparseSlot& slot : old) {
+    if(slot.count > 0) {
+      sparse[sparseFind(slot.item)] = slot;
+    }
+  }
+}
@@ -0,0 +1,177 @@
+/*
+ * Copyright (c) 2019 Robert Falkenberg.
+ *
+ * This file is part of FALCON 
+ * (see https://github.com/falkenber9/falcon).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ */
+#include "falcon/util/RNTIActivityEstimator.h"
+#include "falcon/util/Histogram.h"
+
+#include <cmath>
+#include <algorithm>
+
+// renormalize the weights before float counters lose range
+#define DECAY_MAX_WEIGHT 1e18
+
+static const uint32_t hashMultiplier[] = {
+  0x9E3779B1, 0x85EBCA77, 0xC2B2AE3D, 0x27D4EB2F,
+  0x165667B1, 0xD3A2646D, 0xFD7046C5, 0xB55A4F09
+};
+#define DECAY_MAX_DEPTH (sizeof(hashMultiplier) / sizeof(hashMultiplier[0]))
+
+RNTIActivityEstimator::~RNTIActivityEstimator() {
+
+}
+
+std::unique_ptr<RNTIActivityEstimator> RNTIActivityEstimator::create(const std::string& name,
+                                                                     uint32_t itemCount,
+                                                                     uint32_t valueRange,
+                                                                     bool runLengthEncoded,
+                                                                     uint32_t denseRange) {
+  if(name == "histogram") {
+    return std::unique_ptr<RNTIActivityEstimator>(new Histogram(itemCount, valueRange, runLengthEncoded, denseRange));
+  }
+  if(name == "decay") {
+    return std::unique_ptr<RNTIActivityEstimator>(new DecayingActivityEstimator(itemCount, valueRange, valueRange, 1));
+  }
+  if(name == "sketch") {
+    return std::unique_ptr<RNTIActivityEstimator>(new DecayingActivityEstimator(itemCount, valueRange,
+                                                                                RNTI_ACTIVITY_SKETCH_WIDTH,
+                                                                                RNTI_ACTIVITY_SKETCH_DEPTH));
+  }
+  return nullptr;
+}
+
+DecayingActivityEstimator::DecayingActivityEstimator(uint32_t itemCount, uint32_t valueRange, uint32_t width, uint32_t depth) :
+  itemCount(std::max(itemCount, 1u)),
+  valueRange(valueRange),
+  width(2),
+  depth(std::min<uint32_t>(std::max(depth, 1u), DECAY_MAX_DEPTH)),
+  shift(31),
+  exact(width >= valueRange),
+  counters(),
+  growth(std::exp(1.0 / this->itemCount)),
+  weight(1.0),
+  nof_items(0)
+{
+  if(exact) {
+    this->width = valueRange;
+    this->depth = 1;
+  }
+  else {
+    // power of two for multiply-shift hashing
+    while(this->width < width && shift > 1) {
+      this->width <<= 1;
+      shift--;
+    }
+  }
+  counters.resize(static_cast<size_t>(this->width) * this->depth, 0.0f);
+}
+
+DecayingActivityEstimator::~DecayingActivityEstimator() {
+
+}
+
+void DecayingActivityEstimator::add(uint16_t item) {
+  add(item, 1);
+}
+
+void DecayingActivityEstimator::add(uint16_t item, uint32_t nTimes) {
+  if(nTimes == 0) {
+    return;
+  }
+  // sum of the weights of nTimes consecutive items
+  double gn = std::pow(growth, static_cast<double>(nTimes));
+  float inc = static_cast<float>(weight * (gn - 1.0) / (growth - 1.0));
+  if(exact) {
+    counters[item] += inc;
+  }
+  else {
+    // conservative update: raise only the counters below the new estimate
+    float target = counters[index(item, 0)];
+    for(uint32_t row = 1; row < depth; row++) {
+      target = std::min(target, counters[index(item, row)]);
+    }
+    target += inc;
+    for(uint32_t row = 0; row < depth; row++) {
+      float& c = counters[index(item, row)];
+      c = std::max(c, target);
+    }
+  }
+  weight *= gn;
+  nof_items = static_cast<uint32_t>(std::min<uint64_t>(itemCount, static_cast<uint64_t>(nof_items) + nTimes));
+  if(weight > DECAY_MAX_WEIGHT) {
+    renormalize();
+  }
+}
+
+uint32_t DecayingActivityEstimator::getFrequency(uint16_t item) const {
+  return static_cast<uint32_t>(estimate(item) + 0.5f);
+}
+
+void DecayingActivityEstimator::accumulate(uint32_t* buf) const {
+  for(uint32_t i=0; i<valueRange; i++) {
+    buf[i] += getFrequency(static_cast<uint16_t>(i));
+  }
+}
+
+bool DecayingActivityEstimator::ready() const {
+  return nof_items >= itemCount;
+}
+
+size_t DecayingActivityEstimator::getMemorySize() const {
+  return counters.size() * sizeof(float);
+}
+
+const char* DecayingActivityEstimator::getName() const {
+  return exact ? "decay" : "sketch";
+}
+
+uint32_t DecayingActivityEstimator::getWidth() const {
+  return width;
+}
+
+uint32_t DecayingActivityEstimator::getDepth() const {
+  return depth;
+}
+
+uint32_t DecayingActivityEstimator::index(uint16_t item, uint32_t row) const {
+  return row * width + ((static_cast<uint32_t>(item) * hashMultiplier[row]) >> shift);
+}
+
+// the latest item has weight 1
+float DecayingActivityEstimator::estimate(uint16_t item) const {
+  float c;
+  if(exact) {
+    c = counters[item];
+  }
+  else {
+    c = counters[index(item, 0)];
+    for(uint32_t row = 1; row < depth; row++) {
+      c = std::min(c, counters[index(item, row)]);
+    }
+  }
+  return static_cast<float>(c * growth / weight);
+}
+
+void DecayingActivityEstimator::renormalize() {
+  float scale = static_cast<float>(1.0 / weight);
+  for(float& c : counters) {
+    c *= scale;
+  }
+  weight = 1.0;
+}
@@ -22,6 +22,15 @@
 #include <iostream>
 
 #include "falcon/util/RNTIManager.h"
+#include "falcon/util/RNTISnapshot.h"
+
+#include <chrono>
+#include <algorithm>
+#include <stdio.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 
 using namespace std;
 
@@ -104,16 +113,8 @@ void rnti_manager_get_histogram_summary(void* h, uint32_t* buf) {
 }
 
 uint32_t rnti_manager_get_active_set(void* h, rnti_manager_active_set_t* buf, uint32_t buf_sz) {
-  uint32_t i = 0;
-  if(h) {
-    RNTIManager* rm = static_cast<RNTIManager*>(h);
-    std::vector<rnti_manager_active_set_t> activeSet = rm->getActiveSet();
-    while(i < activeSet.size() && i < buf_sz) {
-      buf[i] = activeSet[i];
-      i++;
-    }
-  }
-  return i;
+  if(h) return static_cast<RNTIManager*>(h)->getActiveSet(buf, buf_sz);
+  return 0;
 }
 
 void rnti_manager_print_active_set(void* h) {
@@ -128,22 +129,119 @@ const char* rnti_manager_activation_reason_string(rnti_manager_activation_reason
 /// C++ class functions
 ////////////////////////
 
-RNTIManager::RNTIManager(uint32_t nformats, uint32_t maxCandidatesPerStepPerFormat) :
+// Per-RNTI state word:
+//   bits  0..15  last seen (lower 16 bits of the timestamp)
+//   bits 16..23  associated format index
+//   bits 24..30  activation reason
+//   bit  31      active
+// The full last-seen timestamp is reconstructed relative to the current time.
+// This is unambiguous for active RNTIs, since the timer wheel removes them
+// shortly after their lifetime.
+#define STATE_LAST_SEEN_MASK 0xffffu
+#define STATE_FORMAT_SHIFT 16
+#define STATE_REASON_SHIFT 24
+#define STATE_ACTIVE_BIT (1u << 31)
+
+#if RRC_INACTIVITY_TIMER_MS + 2 * RNTI_TIMER_WHEEL_RESOLUTION >= 32768
+#error "RRC_INACTIVITY_TIMER_MS exceeds the range of the last-seen field"
+#endif
+
+static inline rnti_state_t packState(bool active, ActivationReason reason, uint32_t formatIdx, uint32_t lastSeen) {
+  return (active ? STATE_ACTIVE_BIT : 0) |
+      (static_cast<rnti_state_t>(reason & 0x7f) << STATE_REASON_SHIFT) |
+      (static_cast<rnti_state_t>(formatIdx & 0xff) << STATE_FORMAT_SHIFT) |
+      (lastSeen & STATE_LAST_SEEN_MASK);
+}
+
+// inactive state, keeps last seen
+static inline rnti_state_t deactivatedState(rnti_state_t state) {
+  return state & STATE_LAST_SEEN_MASK;
+}
+
+static inline bool stateActive(rnti_state_t state) {
+  return (state & STATE_ACTIVE_BIT) != 0;
+}
+
+static inline ActivationReason stateReason(rnti_state_t state) {
+  return static_cast<ActivationReason>((state >> STATE_REASON_SHIFT) & 0x7f);
+}
+
+static inline uint32_t stateFormatIdx(rnti_state_t state) {
+  return (state >> STATE_FORMAT_SHIFT) & 0xff;
+}
+
+static inline uint32_t stateLastSeen(rnti_state_t state, uint32_t now) {
+  int16_t diff = static_cast<int16_t>(static_cast<uint16_t>(state & STATE_LAST_SEEN_MASK) - static_cast<uint16_t>(now));
+  return now + static_cast<uint32_t>(static_cast<int32_t>(diff));
+}
+
+// most recent of two timestamps (tolerates wrap-around)
+static inline uint32_t latest(uint32_t a, uint32_t b) {
+  return static_cast<int32_t>(a - b) > 0 ? a : b;
+}
+
+RNTICandidateDelta::RNTICandidateDelta() :
+  candidates()
+{
+
+}
+
+void RNTICandidateDelta::add(uint16_t rnti, uint32_t formatIdx) {
+  if(formatIdx >= candidates.size()) {
+    candidates.resize(formatIdx + 1);
+  }
+  candidates[formatIdx].push_back(rnti);
+}
+
+void RNTICandidateDelta::append(const RNTICandidateDelta& other) {
+  if(other.candidates.size() > candidates.size()) {
+    candidates.resize(other.candidates.size());
+  }
+  for(uint32_t i=0; i<other.candidates.size(); i++) {
+    candidates[i].insert(candidates[i].end(), other.candidates[i].begin(), other.candidates[i].end());
+  }
+}
+
+void RNTICandidateDelta::clear() {
+  for(vector<uint16_t>& c : candidates) {
+    c.clear();
+  }
+}
+
+uint32_t RNTICandidateDelta::getNofFormats() const {
+  return static_cast<uint32_t>(candidates.size());
+}
+
+const std::vector<uint16_t>& RNTICandidateDelta::getCandidates(uint32_t formatIdx) const {
+  return candidates[formatIdx];
+}
+
+RNTIManager::RNTIManager(uint32_t nformats, uint32_t maxCandidatesPerStepPerFormat, uint32_t histogramDenseRange) :
   nformats(nformats),
-  histograms(nformats, Histogram(RNTI_HISTORY_DEPTH, RNTI_HISTOGRAM_ELEMENT_COUNT)),
+  histograms(),
+  histogramMutex(new std::mutex[nformats]),
+  histogramDenseRange(histogramDenseRange),
   evergreen(nformats, vector<Interval>()),
   forbidden(nformats, vector<Interval>()),
-  active(RNTI_HISTOGRAM_ELEMENT_COUNT, false),
+  state(new std::atomic<rnti_state_t>[RNTI_HISTOGRAM_ELEMENT_COUNT]),
   activeSet(),
-  lastSeen(RNTI_HISTOGRAM_ELEMENT_COUNT, 0),
-  assocFormatIdx(RNTI_HISTOGRAM_ELEMENT_COUNT, 0),
+  activeSetIndex(RNTI_HISTOGRAM_ELEMENT_COUNT, 0),
+  timerWheel(RNTI_TIMER_WHEEL_NOF_SLOTS),
+  timerWheelTick(0),
   timestamp(0),
+  lastTti(-1),
   lifetime(RRC_INACTIVITY_TIMER_MS),
   threshold(RNTI_HISTOGRAM_THRESHOLD),
   maxCandidatesPerStepPerFormat(maxCandidatesPerStepPerFormat),
-  remainingCandidates(nformats, static_cast<int32_t>(maxCandidatesPerStepPerFormat))
+  remainingCandidates(new std::atomic<int32_t>[nformats])
 {
-
+  for(uint32_t i=0; i<RNTI_HISTOGRAM_ELEMENT_COUNT; i++) {
+    state[i].store(packState(false, RM_ACT_UNSET, 0, 0), std::memory_order_relaxed);
+  }
+  for(uint32_t i=0; i<nformats; i++) {
+    remainingCandidates[i].store(static_cast<int32_t>(maxCandidatesPerStepPerFormat), std::memory_order_relaxed);
+  }
+  setActivityEstimator(RNTI_DEFAULT_ACTIVITY_ESTIMATOR);
 }
 
 RNTIManager::~RNTIManager() {
@@ -158,8 +256,42 @@ void RNTIManager::addForbidden(uint16_t rntiStart, uint16_t rntiEnd, uint32_t fo
   forbidden[formatIdx].push_back(Interval(rntiStart, rntiEnd));
 }
 
+bool RNTIManager::setActivityEstimator(const std::string& name) {
+  std::vector<std::unique_ptr<RNTIActivityEstimator> > estimators;
+  for(uint32_t i=0; i<nformats; i++) {
+    std::unique_ptr<RNTIActivityEstimator> e(RNTIActivityEstimator::create(name,
+                                                                          RNTI_HISTORY_DEPTH,
+                                                                          RNTI_HISTOGRAM_ELEMENT_COUNT,
+                                                                          RNTI_HISTORY_RUN_LENGTH_ENCODED,
+                                                                          histogramDenseRange));
+    if(!e) {
+      return false;
+    }
+    estimators.push_back(std::move(e));
+  }
+  histograms.resize(nformats);
+  for(uint32_t i=0; i<nformats; i++) {
+    std::lock_guard<std::mutex> lock(histogramMutex[i]);
+    histograms[i] = std::move(estimators[i]);
+  }
+  return true;
+}
+
+const char* RNTIManager::getActivityEstimatorName() const {
+  return nformats > 0 ? histograms[0]->getName() : RNTI_DEFAULT_ACTIVITY_ESTIMATOR;
+}
+
+void RNTIManager::setThreshold(uint32_t threshold) {
+  this->threshold = threshold;
+}
+
+uint32_t RNTIManager::getThreshold() const {
+  return threshold;
+}
+
 void RNTIManager::addCandidate(uint16_t rnti, uint32_t formatIdx) {
-  histograms[formatIdx].add(rnti);
+  std::lock_guard<std::mutex> lock(histogramMutex[formatIdx]);
+  histograms[formatIdx]->add(rnti);
   remainingCandidates[formatIdx]--;
 }
 
@@ -195,50 +327,55 @@ bool RNTIManager::validate(uint16_t rnti, uint32_t formatIdx) {
 bool RNTIManager::validateAndRefresh(uint16_t rnti, uint32_t formatIdx) {
   bool result = validate(rnti, formatIdx);
   if(result) {
-    lastSeen[rnti] = timestamp;
+    refreshRNTI(rnti);
   }
   return result;
 }
 
 void RNTIManager::activateAndRefresh(uint16_t rnti, uint32_t formatIdx, ActivationReason reason) {
-  activateRNTI(rnti, reason);
-  lastSeen[rnti] = timestamp;
-  assocFormatIdx[rnti] = formatIdx;
+  activateRNTI(rnti, reason, formatIdx, true);
 }
 
 uint32_t RNTIManager::getFrequency(uint16_t rnti, uint32_t formatIdx) {
-  return histograms[formatIdx].getFrequency(rnti);
+  std::lock_guard<std::mutex> lock(histogramMutex[formatIdx]);
+  return histograms[formatIdx]->getFrequency(rnti);
 }
 
 uint32_t RNTIManager::getAssociatedFormatIdx(uint16_t rnti) {
-  return assocFormatIdx[rnti];
+  return stateFormatIdx(state[rnti].load(std::memory_order_relaxed));
 }
 
 ActivationReason RNTIManager::getActivationReason(uint16_t rnti) {
-  for(list<RNTIActiveSetItem>::iterator it = activeSet.begin(); it != activeSet.end(); it++) {
-    if(it->rnti == rnti) return it->reason;
-  }
-  return RM_ACT_UNSET;
+  rnti_state_t s = state[rnti].load(std::memory_order_relaxed);
+  return stateActive(s) ? stateReason(s) : RM_ACT_UNSET;
 }
 
 vector<rnti_manager_active_set_t> RNTIManager::getActiveSet() {
-  cleanExpired();
-  vector<rnti_manager_active_set_t> result(activeSet.size());
-  uint32_t index = 0;
-  for(list<RNTIActiveSetItem>::iterator it = activeSet.begin(); it != activeSet.end(); it++) {
-    result[index].rnti = it->rnti;
-    result[index].reason = it->reason;
-    result[index].last_seen = timestamp - lastSeen[it->rnti];
-    result[index].assoc_format_idx = getAssociatedFormatIdx(it->rnti);
-    result[index].frequency = getFrequency(result[index].rnti, result[index].assoc_format_idx);
-    if(result[index].assoc_format_idx != 0) {
-      result[index].frequency += getFrequency(result[index].rnti, 0);
-    }
-    index++;
-  }
+  vector<rnti_manager_active_set_t> result;
+  getActiveSet(result);
   return result;
 }
 
+void RNTIManager::getActiveSet(vector<rnti_manager_active_set_t>& result) {
+  result.clear();
+  forEachActive([&result](const rnti_manager_active_set_t& entry) { result.push_back(entry); });
+}
+
+uint32_t RNTIManager::getActiveSet(rnti_manager_active_set_t* buf, uint32_t buf_sz) {
+  uint32_t n = 0;
+  forEachActive([&n, buf, buf_sz](const rnti_manager_active_set_t& entry) {
+    if(n < buf_sz) {
+      buf[n++] = entry;
+    }
+  });
+  return n;
+}
+
+uint32_t RNTIManager::getNofActive() {
+  std::lock_guard<std::mutex> lock(activeSetMutex);
+  return static_cast<uint32_t>(activeSet.size());
+}
+
 void RNTIManager::printActiveSet() {
   std::vector<rnti_manager_active_set_t> activeSet = getActiveSet();
   std::vector<rnti_manager_active_set_t>::size_type n_active = activeSet.size();
@@ -281,10 +418,8 @@ void RNTIManager::getHistogramSummary(uint32_t *buf)
 {
   memset(buf, 0, RNTI_HISTOGRAM_ELEMENT_COUNT*sizeof(uint32_t));
   for(uint32_t i=0; i<nformats; i++) {
-    const uint32_t* histData = histograms[i].getFrequencyAll();
-    for(uint32_t j=0; j<RNTI_HISTOGRAM_ELEMENT_COUNT; j++) {
-      buf[j] += histData[j];
-    }
+    std::lock_guard<std::mutex> lock(histogramMutex[i]);
+    histograms[i]->accumulate(buf);
   }
 }
 
@@ -305,12 +440,14 @@ bool RNTIManager::isForbidden(uint16_t rnti, uint32_t formatIdx) const {
 }
 
 RMValidationResult_t RNTIManager::validateByActiveList(uint16_t rnti, uint32_t formatIdx) {
-  if(active[rnti]) {  // active RNTI
-    if(!isExpired(rnti)) {   // lifetime check
+  rnti_state_t s = state[rnti].load(std::memory_order_relaxed);
+  if(stateActive(s)) {  // active RNTI
+    if(!isExpired(s)) {   // lifetime check
       if(formatIdx == FORMAT_INDEX_UPLINK) return RMV_TRUE; // always accept uplink
 
-      if(assocFormatIdx[rnti] != ASSOC_FORMAT_INDEX_UNCERTAIN) {  // downlink format locked?
-        if(assocFormatIdx[rnti] == formatIdx) {
+      uint32_t assocFormatIdx = stateFormatIdx(s);
+      if(assocFormatIdx != ASSOC_FORMAT_INDEX_UNCERTAIN) {  // downlink format locked?
+        if(assocFormatIdx == formatIdx) {
           // active + locked + match
           return RMV_TRUE;
         }
@@ -324,7 +461,7 @@ RMValidationResult_t RNTIManager::validateByActiveList(uint16_t rnti, uint32_t f
     }
     else {
       // lifetime expired
-      deactivateRNTI(rnti);
+      deactivateRNTI(rnti, s);
     }
   }
   return RMV_UNCERTAIN;
@@ -339,18 +476,11 @@ bool RNTIManager::validateByHistogram(uint16_t rnti, uint32_t formatIdx) {
     return false;
   }
 
-  uint32_t ulFreq = histograms[FORMAT_INDEX_UPLINK].getFrequency(rnti);
-  uint32_t dlFreq = likelyDlFormatIdx != ASSOC_FORMAT_INDEX_UNCERTAIN ? histograms[likelyDlFormatIdx].getFrequency(rnti) : 0;
+  uint32_t ulFreq = getFrequency(rnti, FORMAT_INDEX_UPLINK);
+  uint32_t dlFreq = likelyDlFormatIdx != ASSOC_FORMAT_INDEX_UNCERTAIN ? getFrequency(rnti, likelyDlFormatIdx) : 0;
   if(ulFreq + dlFreq > threshold) {   // exceeds threshold?
-    activateRNTI(rnti, RM_ACT_HISTOGRAM);
-    if(dlFreq > threshold) {    // dl format certain?
-      // lock dl format
-      assocFormatIdx[rnti] = likelyDlFormatIdx;
-    }
-    else {
-      // dl format is still uncertain
-      assocFormatIdx[rnti] = ASSOC_FORMAT_INDEX_UNCERTAIN;
-    }
+    // lock dl format if certain, otherwise it is still uncertain
+    activateRNTI(rnti, RM_ACT_HISTOGRAM, dlFreq > threshold ? likelyDlFormatIdx : ASSOC_FORMAT_INDEX_UNCERTAIN, false);
     return true;  // accept
   }
 
@@ -364,7 +494,7 @@ uint32_t RNTIManager::getLikelyDlFormatIdx(uint16_t rnti) {
   uint32_t curFreq = 0;
   // start here from formatIdx 1 (FORMAT_INDEX_FIRST_DOWNLINK), skip uplink
   for(uint32_t formatIdx=FORMAT_INDEX_FIRST_DOWNLINK; formatIdx<nformats; formatIdx++) {
-    curFreq = histograms[formatIdx].getFrequency(rnti);
+    curFreq = getFrequency(rnti, formatIdx);
     if(curFreq > maxFreq) {
       maxFreq = curFreq;
       result = formatIdx;
@@ -373,52 +503,174 @@ uint32_t RNTIManager::getLikelyDlFormatIdx(uint16_t rnti) {
   return result;
 }
 
-void RNTIManager::activateRNTI(uint16_t rnti, ActivationReason reason) {
-  if(!active[rnti]) {
-    active[rnti] = true;
-    activeSet.push_back(RNTIActiveSetItem(rnti, reason));
+void RNTIManager::activateRNTI(uint16_t rnti, ActivationReason reason, uint32_t formatIdx, bool refresh) {
+  uint32_t now = timestamp.load(std::memory_order_relaxed);
+  rnti_state_t s = state[rnti].load(std::memory_order_relaxed);
+
+  // fast path: already active, only update format and timestamp
+  while(stateActive(s)) {
+    uint32_t lastSeen = refresh ? latest(stateLastSeen(s, now), now) : stateLastSeen(s, now);
+    if(state[rnti].compare_exchange_weak(s, packState(true, stateReason(s), formatIdx, lastSeen))) {
+      return;
+    }
+  }
+
+  // activation modifies the active set
+  std::lock_guard<std::mutex> lock(activeSetMutex);
+  s = state[rnti].load(std::memory_order_relaxed);
+  bool wasActive;
+  rnti_state_t desired;
+  do {
+    wasActive = stateActive(s);
+    // the last-seen field of an inactive RNTI is stale and may be rebuilt as a time in the future
+    uint32_t lastSeen = now;
+    if(wasActive) {
+      lastSeen = refresh ? latest(stateLastSeen(s, now), now) : stateLastSeen(s, now);
+    }
+    desired = packState(true, wasActive ? stateReason(s) : reason, formatIdx, lastSeen);
+  } while(!state[rnti].compare_exchange_weak(s, desired));
+  if(!wasActive) {
+    insertActiveSet(rnti, reason, stateLastSeen(desired, now));
   }
 }
 
-void RNTIManager::deactivateRNTI(uint16_t rnti) {
-  if(active[rnti]) {
-    active[rnti] = false;
-    assocFormatIdx[rnti] = 0;
-    activeSet.remove(RNTIActiveSetItem(rnti));
+void RNTIManager::refreshRNTI(uint16_t rnti) {
+  uint32_t now = timestamp.load(std::memory_order_relaxed);
+  rnti_state_t s = state[rnti].load(std::memory_order_relaxed);
+  while(latest(stateLastSeen(s, now), now) != stateLastSeen(s, now)) {
+    rnti_state_t desired = (s & ~STATE_LAST_SEEN_MASK) | (now & STATE_LAST_SEEN_MASK);
+    if(state[rnti].compare_exchange_weak(s, desired)) {
+      break;
+    }
   }
 }
 
-bool RNTIManager::isExpired(uint16_t rnti) const {
+// deactivates rnti, unless its state has changed since it was found expired
+void RNTIManager::deactivateRNTI(uint16_t rnti, rnti_state_t expected) {
+  std::lock_guard<std::mutex> lock(activeSetMutex);
+  if(state[rnti].compare_exchange_strong(expected, deactivatedState(expected))) {
+    removeActiveSet(rnti);
+  }
+}
+
+bool RNTIManager::isExpired(rnti_state_t state) const {
   bool result = true;
-  if(active[rnti]) {
-    if(timestamp - lastSeen[rnti] < lifetime) {
+  if(stateActive(state)) {
+    uint32_t now = timestamp.load(std::memory_order_relaxed);
+    if(static_cast<int32_t>(now - stateLastSeen(state, now)) < static_cast<int32_t>(lifetime)) {
       result = false;
     }
   }
   return result;
 }
 
-void RNTIManager::cleanExpired() {
-  list<RNTIActiveSetItem>::iterator it = activeSet.begin();
-  while(it != activeSet.end()) {
-    if(isExpired(it->rnti)) {
-      it = activeSet.erase(it);
-    }
-    else {
-      ++it;
+// Fills entry; returns false if the RNTI has expired but has not been removed yet.
+// activeSetMutex must be held
+bool RNTIManager::getActiveSetEntry(const RNTIActiveSetItem& item, uint32_t now, rnti_manager_active_set_t& entry) {
+  rnti_state_t s = state[item.rnti].load(std::memory_order_relaxed);
+  if(isExpired(s)) {
+    return false;
+  }
+  entry.rnti = item.rnti;
+  entry.reason = item.reason;
+  entry.last_seen = now - stateLastSeen(s, now);
+  entry.assoc_format_idx = stateFormatIdx(s);
+  entry.frequency = getFrequency(item.rnti, entry.assoc_format_idx);
+  if(entry.assoc_format_idx != 0) {
+    entry.frequency += getFrequency(item.rnti, 0);
+  }
+  return true;
+}
+
+bool RNTIManager::isInActiveSet(uint16_t rnti) const {
+  uint16_t idx = activeSetIndex[rnti];
+  return idx < activeSet.size() && activeSet[idx].rnti == rnti;
+}
+
+void RNTIManager::insertActiveSet(uint16_t rnti, ActivationReason reason, uint32_t lastSeen) {
+  activeSetIndex[rnti] = static_cast<uint16_t>(activeSet.size());
+  activeSet.push_back(RNTIActiveSetItem(rnti, reason));
+  scheduleExpiry(activeSet.back(), lastSeen + lifetime);
+}
+
+// swap with the last item
+void RNTIManager::removeActiveSet(uint16_t rnti) {
+  if(!isInActiveSet(rnti)) {
+    return;
+  }
+  uint16_t idx = activeSetIndex[rnti];
+  activeSet[idx] = activeSet.back();
+  activeSetIndex[activeSet[idx].rnti] = idx;
+  activeSet.pop_back();
+}
+
+void RNTIManager::scheduleExpiry(RNTIActiveSetItem& item, uint32_t deadline) {
+  // never schedule into a tick that has already been processed
+  uint32_t earliest = timerWheelTick * RNTI_TIMER_WHEEL_RESOLUTION;
+  if(static_cast<int32_t>(deadline - earliest) < 0) {
+    deadline = earliest;
+  }
+  item.deadline = deadline;
+  TimerWheelEntry entry;
+  entry.rnti = item.rnti;
+  entry.deadline = deadline;
+  timerWheel[(deadline / RNTI_TIMER_WHEEL_RESOLUTION) % RNTI_TIMER_WHEEL_NOF_SLOTS].push_back(entry);
+}
+
+// Checks all RNTIs whose deadline has passed. Refreshed RNTIs are rescheduled,
+// expired RNTIs are removed. activeSetMutex must be held
+void RNTIManager::processTimerWheel() {
+  uint32_t now = timestamp.load(std::memory_order_relaxed);
+  while(static_cast<int32_t>(now - (timerWheelTick + 1) * RNTI_TIMER_WHEEL_RESOLUTION) >= 0) {
+    vector<TimerWheelEntry>& slot = timerWheel[timerWheelTick % RNTI_TIMER_WHEEL_NOF_SLOTS];
+    size_t n = slot.size();
+    size_t keep = 0;
+    for(size_t i = 0; i < n; i++) {
+      TimerWheelEntry entry = slot[i];
+      if(!isInActiveSet(entry.rnti) || activeSet[activeSetIndex[entry.rnti]].deadline != entry.deadline) {
+        continue;   // outdated
+      }
+      // wrap-aware: deadline / RNTI_TIMER_WHEEL_RESOLUTION wraps earlier than timerWheelTick
+      if(static_cast<int32_t>(entry.deadline - timerWheelTick * RNTI_TIMER_WHEEL_RESOLUTION) >= RNTI_TIMER_WHEEL_RESOLUTION) {
+        slot[keep++] = entry;   // due in a later round
+        continue;
+      }
+      rnti_state_t s = state[entry.rnti].load(std::memory_order_relaxed);
+      bool expired = false;
+      while(!expired && isExpired(s)) {
+        expired = state[entry.rnti].compare_exchange_weak(s, deactivatedState(s));
+      }
+      if(expired) {
+        removeActiveSet(entry.rnti);
+      }
+      else {
+        // refreshed meanwhile (may append to this slot)
+        scheduleExpiry(activeSet[activeSetIndex[entry.rnti]], stateLastSeen(s, now) + lifetime);
+      }
     }
+    slot.erase(slot.begin() + static_cast<long>(keep), slot.begin() + static_cast<long>(n));
+    timerWheelTick++;
   }
 }
 
 void RNTIManager::stepTime() {
   // add padding to histograms
   for(uint32_t i=0; i<nformats; i++) {
-    if(remainingCandidates[i] > 0) {
-      histograms[i].add(ILLEGAL_RNTI, static_cast<uint32_t>(remainingCandidates[i]));
+    std::lock_guard<std::mutex> lock(histogramMutex[i]);
+    int32_t remaining = remainingCandidates[i].exchange(static_cast<int32_t>(maxCandidatesPerStepPerFormat)); // reset
+    if(remaining > 0) {
+      histograms[i]->add(ILLEGAL_RNTI, static_cast<uint32_t>(remaining));
+    }
+  }
+  {
+    std::lock_guard<std::mutex> lock(timeMutex);
+    timestamp++;
+    if(lastTti >= 0) {
+      lastTti = (lastTti + 1) % RNTI_MANAGER_NOF_TTI;
     }
-    remainingCandidates[i] = static_cast<int32_t>(maxCandidatesPerStepPerFormat); // reset
   }
-  timestamp++;
+  std::lock_guard<std::mutex> lock(activeSetMutex);
+  processTimerWheel();
 }
 
 void RNTIManager::stepTime(uint32_t nSteps) {
@@ -426,3 +678,204 @@ void RNTIManager::stepTime(uint32_t nSteps) {
     stepTime();
   }
 }
+
+void RNTIManager::commitSubframe(uint32_t tti, RNTICandidateDelta& delta) {
+  // one step per elapsed subframe, so that skipped subframes age the window as well;
+  // beyond the window length, padding has no further effect
+  uint32_t nof_steps = advanceTo(tti);
+  uint64_t nof_items = std::min<uint64_t>(static_cast<uint64_t>(nof_steps) * maxCandidatesPerStepPerFormat, RNTI_HISTORY_DEPTH);
+  for(uint32_t i=0; i<nformats; i++) {
+    uint32_t nof_candidates = 0;
+    std::lock_guard<std::mutex> lock(histogramMutex[i]);
+    if(i < delta.getNofFormats()) {
+      const vector<uint16_t>& candidates = delta.getCandidates(i);
+      for(uint16_t rnti : candidates) {
+        histograms[i]->add(rnti);
+      }
+      nof_candidates = static_cast<uint32_t>(candidates.size());
+    }
+    // padding; none for late subframes
+    if(nof_candidates < nof_items) {
+      histograms[i]->add(ILLEGAL_RNTI, static_cast<uint32_t>(nof_items - nof_candidates));
+    }
+  }
+  delta.clear();
+  std::lock_guard<std::mutex> lock(activeSetMutex);
+  processTimerWheel();
+}
+
+uint32_t RNTIManager::getTimestamp() const {
+  return timestamp.load(std::memory_order_relaxed);
+}
+
+static int64_t wallclockMs() {
+  return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+bool RNTIManager::saveSnapshot(const std::string& filename, uint32_t tag) {
+  vector<rnti_manager_active_set_t> active;
+  getActiveSet(active);
+  vector<RNTISnapshotFrequency> frequencies;
+  vector<uint32_t> buf(RNTI_HISTOGRAM_ELEMENT_COUNT);
+  for(uint32_t i=0; i<nformats; i++) {
+    std::fill(buf.begin(), buf.end(), 0);
+    {
+      std::lock_guard<std::mutex> lock(histogramMutex[i]);
+      histograms[i]->accumulate(buf.data());
+    }
+    for(uint32_t rnti=ILLEGAL_RNTI+1; rnti<RNTI_HISTOGRAM_ELEMENT_COUNT; rnti++) {
+      if(buf[rnti] > 0) {
+        RNTISnapshotFrequency f;
+        f.rnti = static_cast<uint16_t>(rnti);
+        f.format_idx = static_cast<uint8_t>(i);
+        f.reserved = 0;
+        f.count = buf[rnti];
+        frequencies.push_back(f);
+      }
+    }
+  }
+
+  RNTISnapshotHeader header;
+  header.magic = RNTI_SNAPSHOT_MAGIC;
+  header.version = RNTI_SNAPSHOT_VERSION;
+  header.header_size = sizeof(RNTISnapshotHeader);
+  header.tag = tag;
+  header.nof_formats = nformats;
+  header.wallclock_ms = wallclockMs();
+  header.window_ms = RNTI_HISTORY_DEPTH_MSEC;
+  header.nof_active = static_cast<uint32_t>(active.size());
+  header.nof_frequencies = static_cast<uint32_t>(frequencies.size());
+
+  std::string tmpname = filename + ".tmp";
+  FILE* file = fopen(tmpname.c_str(), "wb");
+  if(file == nullptr) {
+    return false;
+  }
+  bool ok = fwrite(&header, sizeof(header), 1, file) == 1;
+  for(const rnti_manager_active_set_t& a : active) {
+    RNTISnapshotActive entry;
+    entry.rnti = a.rnti;
+    entry.format_idx = static_cast<uint8_t>(a.assoc_format_idx);
+    entry.reason = static_cast<uint8_t>(a.reason);
+    entry.age_ms = a.last_seen;
+    ok = ok && fwrite(&entry, sizeof(entry), 1, file) == 1;
+  }
+  if(!frequencies.empty()) {
+    ok = ok && fwrite(frequencies.data(), sizeof(RNTISnapshotFrequency), frequencies.size(), file) == frequencies.size();
+  }
+  ok = (fclose(file) == 0) && ok;
+  // replace the previous snapshot atomically
+  if(!ok || rename(tmpname.c_str(), filename.c_str()) != 0) {
+    remove(tmpname.c_str());
+    return false;
+  }
+  return true;
+}
+
+bool RNTIManager::loadSnapshot(const std::string& filename, uint32_t tag, int64_t ageMs) {
+  int fd = open(filename.c_str(), O_RDONLY);
+  if(fd < 0) {
+    return false;
+  }
+  struct stat st;
+  if(fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(RNTISnapshotHeader)) {
+    close(fd);
+    return false;
+  }
+  size_t size = static_cast<size_t>(st.st_size);
+  void* map = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if(map == MAP_FAILED) {
+    return false;
+  }
+  const uint8_t* data = static_cast<const uint8_t*>(map);
+  const RNTISnapshotHeader* header = reinterpret_cast<const RNTISnapshotHeader*>(data);
+  if(header->magic != RNTI_SNAPSHOT_MAGIC ||
+     header->version > RNTI_SNAPSHOT_VERSION ||
+     header->header_size < sizeof(RNTISnapshotHeader) ||
+     header->tag != tag ||
+     header->nof_formats != nformats ||
+     size < header->header_size +
+            static_cast<size_t>(header->nof_active) * sizeof(RNTISnapshotActive) +
+            static_cast<size_t>(header->nof_frequencies) * sizeof(RNTISnapshotFrequency)) {
+    munmap(map, size);
+    return false;
+  }
+  if(ageMs < 0) {
+    ageMs = std::max<int64_t>(0, wallclockMs() - header->wallclock_ms);
+  }
+  const RNTISnapshotActive* active = reinterpret_cast<const RNTISnapshotActive*>(data + header->header_size);
+  const RNTISnapshotFrequency* frequencies = reinterpret_cast<const RNTISnapshotFrequency*>(active + header->nof_active);
+
+  // active RNTIs that are still alive after the downtime
+  {
+    std::lock_guard<std::mutex> lock(activeSetMutex);
+    uint32_t now = timestamp.load(std::memory_order_relaxed);
+    for(uint32_t i=0; i<header->nof_active; i++) {
+      const RNTISnapshotActive& a = active[i];
+      int64_t age = ageMs + a.age_ms;
+      if(age >= lifetime || a.format_idx >= nformats || a.rnti == ILLEGAL_RNTI) {
+        continue;
+      }
+      rnti_state_t s = state[a.rnti].load(std::memory_order_relaxed);
+      if(stateActive(s)) {
+        continue;
+      }
+      uint32_t lastSeen = now - static_cast<uint32_t>(age);
+      ActivationReason reason = static_cast<ActivationReason>(a.reason);
+      if(state[a.rnti].compare_exchange_strong(s, packState(true, reason, a.format_idx, lastSeen))) {
+        insertActiveSet(a.rnti, reason, lastSeen);
+      }
+    }
+  }
+
+  // frequencies of the part of the window that has not passed yet
+  if(ageMs < header->window_ms) {
+    uint64_t remaining = header->window_ms - static_cast<uint64_t>(ageMs);
+    for(uint32_t i=0; i<header->nof_frequencies; i++) {
+      const RNTISnapshotFrequency& f = frequencies[i];
+      uint32_t count = static_cast<uint32_t>((f.count * remaining + header->window_ms / 2) / header->window_ms);
+      if(f.format_idx < nformats && count > 0) {
+        std::lock_guard<std::mutex> lock(histogramMutex[f.format_idx]);
+        histograms[f.format_idx]->add(f.rnti, count);
+      }
+    }
+    // the passed part of the window follows as padding, so that the restored counts
+    // age out with the remaining part instead of a full window
+    uint64_t passed = RNTI_HISTORY_DEPTH * static_cast<uint64_t>(ageMs) / header->window_ms;
+    for(uint32_t i=0; i<nformats; i++) {
+      std::lock_guard<std::mutex> lock(histogramMutex[i]);
+      if(passed > 0) {
+        histograms[i]->add(ILLEGAL_RNTI, static_cast<uint32_t>(passed));
+      }
+    }
+  }
+  munmap(map, size);
+  return true;
+}
+
+size_t RNTIManager::getMemorySize() {
+  size_t result = RNTI_HISTOGRAM_ELEMENT_COUNT * (sizeof(rnti_state_t) + sizeof(uint16_t));
+  for(uint32_t i=0; i<nformats; i++) {
+    std::lock_guard<std::mutex> lock(histogramMutex[i]);
+    result += histograms[i]->getMemorySize();
+  }
+  return result;
+}
+
+uint32_t RNTIManager::advanceTo(uint32_t tti) {
+  std::lock_guard<std::mutex> lock(timeMutex);
+  tti %= RNTI_MANAGER_NOF_TTI;
+  if(lastTti < 0) {
+    timestamp++;
+    lastTti = static_cast<int32_t>(tti);
+    return 1;
+  }
+  uint32_t diff = (tti + RNTI_MANAGER_NOF_TTI - static_cast<uint32_t>(lastTti)) % RNTI_MANAGER_NOF_TTI;
+  if(diff > 0 && diff < RNTI_MANAGER_NOF_TTI / 2) {
+    timestamp += diff;
+    lastTti = static_cast<int32_t>(tti);
+    return diff;
+  }
+  return 0;
+}
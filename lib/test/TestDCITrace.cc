@@ -0,0 +1,159 @@
+/*
+ * Copyright (c) 2019 Robert Falkenberg.
+ *
+ * This file is part of FALCON 
+ * (see https://github.com/falkenber9/falcon).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ */
+#include "falcon/common/DCITrace.h"
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <cstring>
+#include <cstdio>
+#include <unistd.h>
+
+// this code makes use of assert(EXPRESSION).
+// Since it drops EXPRESSION if NDEBUG is defined,
+// i.e. in release mode, we undefine it here...
+#undef NDEBUG
+#include <assert.h>
+
+using namespace std;
+
+static DCITraceRecord makeRecord(uint16_t rnti, uint8_t direction, uint32_t nof_bits) {
+  DCITraceRecord record;
+  memset(&record, 0, sizeof(record));
+  record.rnti = rnti;
+  record.direction = direction;
+  record.format = direction == DCI_TRACE_DIR_DL ? 2 : 0;
+  record.mcs_idx = 17;
+  record.nof_prb = 25;
+  record.tbs = 9912;
+  record.tbs0 = -1;
+  record.tbs1 = -1;
+  record.ndi = 1;
+  record.ndi_1 = -1;
+  record.harq_process = 3;
+  record.ncce = 8;
+  record.L = 2;
+  record.histval = 42;
+  uint8_t bits[8*DCI_TRACE_MAX_PAYLOAD_BYTES];
+  for(uint32_t i = 0; i < nof_bits; i++) {
+    bits[i] = (i % 3) == 0;
+  }
+  DCITracePackPayload(record, bits, nof_bits);
+  return record;
+}
+
+void testPayload() {
+  cout << "Testing payload packing" << endl;
+  DCITraceRecord record = makeRecord(1, DCI_TRACE_DIR_DL, 10);
+  // 1001001001 -> 0x92 0x40
+  assert(record.nof_bits == 10);
+  assert(record.payload[0] == 0x92);
+  assert(record.payload[1] == 0x40);
+  assert(record.payload[2] == 0);
+}
+
+void testRoundTrip(const string& filename) {
+  cout << "Testing write/read round trip" << endl;
+  const uint32_t nof_subframes = 5000;  // exceeds the writer buffer below
+  {
+    DCITraceWriter writer(1024);
+    assert(writer.open(filename));
+    vector<DCITraceRecord> records;
+    for(uint32_t sf = 0; sf < nof_subframes; sf++) {
+      DCITraceSubframeHeader header;
+      memset(&header, 0, sizeof(header));
+      header.tv_sec = 1500000000 + sf / 1000;
+      header.tv_usec = (sf % 1000) * 1000;
+      header.sfn = static_cast<uint16_t>((sf / 10) % 1024);
+      header.sf_idx = static_cast<uint8_t>(sf % 10);
+      header.cfi = 2;
+      if(sf % 100 == 99) {
+        header.flags = DCI_TRACE_FLAG_GAP;
+        header.gap_reason = 1;
+        writer.writeSubframe(header, nullptr);
+        continue;
+      }
+      records.clear();
+      for(uint32_t i = 0; i < sf % 4; i++) {
+        records.push_back(makeRecord(static_cast<uint16_t>(sf + i), i % 2 ? DCI_TRACE_DIR_UL : DCI_TRACE_DIR_DL, 27 + i));
+      }
+      header.nof_dci = static_cast<uint16_t>(records.size());
+      writer.writeSubframe(header, records.data());
+    }
+    assert(writer.getNofSubframes() == nof_subframes);
+    writer.close();
+  }
+
+  DCITraceReader reader;
+  assert(reader.open(filename));
+  assert(reader.getFileHeader().version == DCI_TRACE_VERSION);
+  DCITraceSubframeHeader header;
+  vector<DCITraceRecord> records;
+  uint32_t sf = 0;
+  while(reader.next(header, records)) {
+    assert(header.sf_idx == sf % 10);
+    assert(header.sfn == (sf / 10) % 1024);
+    if(sf % 100 == 99) {
+      assert(header.flags == DCI_TRACE_FLAG_GAP);
+      assert(records.empty());
+    }
+    else {
+      assert(header.flags == 0);
+      assert(records.size() == sf % 4);
+      for(uint32_t i = 0; i < records.size(); i++) {
+        DCITraceRecord expected = makeRecord(static_cast<uint16_t>(sf + i), i % 2 ? DCI_TRACE_DIR_UL : DCI_TRACE_DIR_DL, 27 + i);
+        assert(memcmp(&expected, &records[i], sizeof(DCITraceRecord)) == 0);
+      }
+    }
+    sf++;
+  }
+  assert(sf == nof_subframes);
+}
+
+void testText(const string& filename) {
+  cout << "Testing text conversion" << endl;
+  DCITraceSubframeHeader header;
+  memset(&header, 0, sizeof(header));
+  header.tv_sec = 1500000000;
+  header.tv_usec = 1234;
+  header.sfn = 12;
+  header.sf_idx = 3;
+  header.cfi = 2;
+  DCITraceRecord record = makeRecord(4711, DCI_TRACE_DIR_DL, 10);
+
+  FILE* f = fopen(filename.c_str(), "w+");
+  assert(f != nullptr);
+  DCITracePrintText(f, header, record);
+  rewind(f);
+  char line[256];
+  assert(fgets(line, sizeof(line), f) != nullptr);
+  fclose(f);
+  assert(string(line) == "1500000000.001234\t0012\t3\t4711\t1\t17\t25\t9912\t-1\t-1\t3\t1\t-1\t3\t8\t2\t2\t42\t10\t9240\n");
+}
+
+int main(int argc, char** argv) {
+  string filename = "TestDCITrace-" + to_string(getpid()) + ".bin";
+  testPayload();
+  testRoundTrip(filename);
+  testText(filename);
+  unlink(filename.c_str());
+  cout << "OK" << endl;
+}
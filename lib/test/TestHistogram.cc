@@ -0,0 +1,110 @@
+/*
+ * Copyright (c) 2019 Robert Falkenberg.
+ *
+ * This file is part of FALCON 
+ * (see https://github.com/falkenber9/falcon).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ */
+#include "falcon/util/Histogram.h"
+
+#include <iostream>
+#include <vector>
+#include <deque>
+#include <cstdlib>
+
+// this code makes use of assert(EXPRESSION).
+// Since it drops EXPRESSION if NDEBUG is defined,
+// i.e. in release mode, we undefine it here...
+#undef NDEBUG
+#include <assert.h>
+
+using namespace std;
+
+#define ITEM_COUNT 1000
+#define VALUE_RANGE 64
+
+// Sliding window of the last ITEM_COUNT items, one item at a time
+class ReferenceHistogram {
+public:
+  ReferenceHistogram() : counts(VALUE_RANGE, 0), nofAdded(0) {}
+  void add(uint16_t item, uint32_t nTimes) {
+    for(uint32_t i = 0; i < nTimes; i++) {
+      window.push_back(item);
+      counts[item]++;
+      if(window.size() > ITEM_COUNT) {
+        counts[window.front()]--;
+        window.pop_front();
+      }
+      nofAdded++;
+    }
+  }
+  bool ready() const { return nofAdded >= ITEM_COUNT; }
+  vector<uint32_t> counts;
+private:
+  deque<uint16_t> window;
+  uint64_t nofAdded;
+};
+
+void testEquivalence(bool runLengthEncoded, uint32_t denseRange) {
+  cout << "Testing " << (runLengthEncoded ? "run-length encoded" : "plain") << " history, "
+       << (denseRange < VALUE_RANGE ? "hashed" : "dense") << " counters" << endl;
+  srand(1234);
+  Histogram hist(ITEM_COUNT, VALUE_RANGE, runLengthEncoded, denseRange);
+  ReferenceHistogram ref;
+  assert(hist.isRunLengthEncoded() == runLengthEncoded);
+  assert(hist.getDenseRange() == min<uint32_t>(denseRange, VALUE_RANGE));
+  for(uint32_t step = 0; step < 5000; step++) {
+    // a few candidates followed by padding, like RNTIManager::commitSubframe()
+    uint32_t nof_candidates = static_cast<uint32_t>(rand() % 8);
+    for(uint32_t i = 0; i < nof_candidates; i++) {
+      uint16_t item = static_cast<uint16_t>(1 + rand() % (VALUE_RANGE - 1));
+      hist.add(item);
+      ref.add(item, 1);
+    }
+    uint32_t padding = static_cast<uint32_t>(rand() % 100);
+    if(step % 1000 == 999) {
+      padding = 2 * ITEM_COUNT + 17;  // exceeds the window
+    }
+    hist.add(0, padding);
+    ref.add(0, padding);
+
+    assert(hist.ready() == ref.ready());
+    for(uint16_t v = 0; v < VALUE_RANGE; v++) {
+      assert(hist.getFrequency(v) == ref.counts[v]);
+    }
+  }
+  vector<uint32_t> sum(VALUE_RANGE, 0);
+  hist.accumulate(sum.data());
+  assert(sum == ref.counts);
+}
+
+void testSaturation() {
+  cout << "Testing saturating counters" << endl;
+  Histogram hist(2 * HISTOGRAM_MAX_COUNT, VALUE_RANGE, true, 1);
+  hist.add(5, HISTOGRAM_MAX_COUNT + 10);
+  assert(hist.getFrequency(5) == HISTOGRAM_MAX_COUNT);
+  hist.add(0, 2 * HISTOGRAM_MAX_COUNT);
+  assert(hist.getFrequency(5) == 0);
+}
+
+int main(int argc, char** argv) {
+  testEquivalence(false, HISTOGRAM_DENSE_ALL);
+  testEquivalence(true, HISTOGRAM_DENSE_ALL);
+  testEquivalence(false, 8);
+  testEquivalence(true, 1);
+  testSaturation();
+  cout << "OK" << endl;
+}
@@ -0,0 +1,149 @@
+/*
+ * Copyright (c) 2019 Robert Falkenberg.
+ *
+ * This file is part of FALCON
+ * (see https://github.com/falkenber9/falcon).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ */
+#include "falcon/phy/falcon_phch/falcon_viterbi.h"
+
+#include <iostream>
+#include <random>
+#include <cstring>
+
+// this code makes use of assert(EXPRESSION).
+// Since it drops EXPRESSION if NDEBUG is defined,
+// i.e. in release mode, we undefine it here...
+#undef NDEBUG
+#include <assert.h>
+
+using namespace std;
+
+#define NOF_TRIALS 500
+#define NOF_BITS (27 + 16)    // DCI format 1A (20 MHz) including CRC
+#define MIN_RELIABILITY 0.75f
+
+static mt19937 gen(1);
+
+static void randomMessage(uint8_t* msg, uint32_t nof_bits) {
+  uniform_int_distribution<int> bit(0, 1);
+  for(uint32_t i = 0; i < nof_bits; i++) {
+    msg[i] = static_cast<uint8_t>(bit(gen));
+  }
+}
+
+// BPSK soft bits (positive: 1) with gaussian noise
+static void modulate(const uint8_t* coded, float* llr, uint32_t nof_coded, float sigma) {
+  normal_distribution<float> noise(0, sigma);
+  for(uint32_t i = 0; i < nof_coded; i++) {
+    llr[i] = (coded[i] ? 1.0f : -1.0f) + noise(gen);
+  }
+}
+
+struct Buffers {
+  uint8_t data[FALCON_VITERBI_MAX_LIST][FALCON_VITERBI_MAX_BITS];
+  uint8_t* list[FALCON_VITERBI_MAX_LIST];
+  float reliability[FALCON_VITERBI_MAX_LIST];
+  Buffers() {
+    for(uint32_t i = 0; i < FALCON_VITERBI_MAX_LIST; i++) {
+      list[i] = data[i];
+    }
+  }
+};
+
+// error-free input decodes exactly, with and without early termination
+void testNoiseless(falcon_viterbi_t* q) {
+  uint8_t msg[NOF_BITS];
+  uint8_t coded[3 * NOF_BITS];
+  float llr[3 * NOF_BITS];
+  Buffers b;
+  for(uint32_t trial = 0; trial < NOF_TRIALS; trial++) {
+    randomMessage(msg, NOF_BITS);
+    falcon_viterbi_encode(msg, coded, NOF_BITS);
+    modulate(coded, llr, 3 * NOF_BITS, 0);
+    int n = falcon_viterbi_decode_list(q, llr, NOF_BITS, MIN_RELIABILITY, b.list, b.reliability, 1);
+    assert(n == 1);
+    assert(memcmp(b.data[0], msg, NOF_BITS) == 0);
+    assert(b.reliability[0] > 0.999f);
+  }
+}
+
+// moderate noise: the best survivor is the transmitted message, nothing is abandoned
+void testNoisy(falcon_viterbi_t* q) {
+  uint8_t msg[NOF_BITS];
+  uint8_t coded[3 * NOF_BITS];
+  float llr[3 * NOF_BITS];
+  Buffers b;
+  uint32_t nof_correct = 0;
+  for(uint32_t trial = 0; trial < NOF_TRIALS; trial++) {
+    randomMessage(msg, NOF_BITS);
+    falcon_viterbi_encode(msg, coded, NOF_BITS);
+    modulate(coded, llr, 3 * NOF_BITS, 0.5f);
+    int n = falcon_viterbi_decode_list(q, llr, NOF_BITS, MIN_RELIABILITY, b.list, b.reliability, 4);
+    assert(n >= 1 && n <= 4);
+    for(int i = 1; i < n; i++) {
+      assert(b.reliability[i] <= b.reliability[i - 1]);
+    }
+    if(memcmp(b.data[0], msg, NOF_BITS) == 0) {
+      nof_correct++;
+    }
+  }
+  assert(nof_correct == NOF_TRIALS);
+}
+
+// noise only: most decodings are abandoned early
+void testEarlyTermination(falcon_viterbi_t* q) {
+  normal_distribution<float> noise(0, 1);
+  float llr[3 * NOF_BITS];
+  Buffers b;
+  uint32_t nof_abandoned = 0;
+  uint32_t nof_early_terminations = q->nof_early_terminations;
+  for(uint32_t trial = 0; trial < NOF_TRIALS; trial++) {
+    for(uint32_t i = 0; i < 3 * NOF_BITS; i++) {
+      llr[i] = noise(gen);
+    }
+    if(falcon_viterbi_decode_list(q, llr, NOF_BITS, MIN_RELIABILITY, b.list, b.reliability, 1) == 0) {
+      nof_abandoned++;
+    }
+    // without a bound, there is always a result
+    assert(falcon_viterbi_decode_list(q, llr, NOF_BITS, 0, b.list, b.reliability, 1) == 1);
+  }
+  cout << "Abandoned " << nof_abandoned << " of " << NOF_TRIALS << " noise-only decodings" << endl;
+  assert(nof_abandoned > NOF_TRIALS / 4);
+  assert(q->nof_early_terminations - nof_early_terminations == nof_abandoned);
+}
+
+void testInvalidInputs(falcon_viterbi_t* q) {
+  float llr[3 * NOF_BITS] = {0};
+  Buffers b;
+  assert(falcon_viterbi_decode_list(q, llr, 0, 0, b.list, b.reliability, 1) < 0);
+  assert(falcon_viterbi_decode_list(q, llr, FALCON_VITERBI_MAX_BITS + 1, 0, b.list, b.reliability, 1) < 0);
+  assert(falcon_viterbi_decode_list(q, llr, NOF_BITS, 0, b.list, b.reliability, 0) < 0);
+}
+
+int main(int argc, char** argv) {
+  falcon_viterbi_t* q = new falcon_viterbi_t;
+  falcon_viterbi_init(q);
+
+  testNoiseless(q);
+  testNoisy(q);
+  testEarlyTermination(q);
+  testInvalidInputs(q);
+
+  delete q;
+  cout << "All tests passed" << endl;
+  return 0;
+}
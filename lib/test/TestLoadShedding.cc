@@ -0,0 +1,151 @@
+/*
+ * Copyright (c) 2019 Robert Falkenberg.
+ *
+ * This file is part of FALCON
+ * (see https://github.com/falkenber9/falcon).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ */
+#include "eye/phy/LoadShedding.h"
+
+#include <iostream>
+
+// this code makes use of assert(EXPRESSION).
+// Since it drops EXPRESSION if NDEBUG is defined,
+// i.e. in release mode, we undefine it here...
+#undef NDEBUG
+#include <assert.h>
+
+using namespace std;
+
+#define NOF_BUFFERS 4
+#define HOLD_SUBFRAMES 20
+// minimum load reported by Phy: the subframe just handed over
+#define IDLE 1
+
+static LoadSheddingInput load(uint32_t nof_pending, double decode_time_us) {
+  LoadSheddingInput input;
+  input.nof_pending = nof_pending;
+  input.nof_buffers = NOF_BUFFERS;
+  input.nof_worker_threads = 1;
+  input.decode_time_us = decode_time_us;
+  return input;
+}
+
+void testCreate() {
+  cout << "Testing policy names" << endl;
+  assert(string(LoadSheddingPolicy::create("none")->getName()) == "none");
+  assert(string(LoadSheddingPolicy::create("adaptive")->getName()) == "adaptive");
+  assert(LoadSheddingPolicy::create("unknown") == nullptr);
+  NoLoadShedding none;
+  assert(none.update(load(NOF_BUFFERS, 5000)) == LOAD_SHEDDING_NONE);
+}
+
+// full buffers raise the level at once, then by one step every NOF_BUFFERS subframes up to the last level
+void testEscalation() {
+  cout << "Testing escalation" << endl;
+  AdaptiveLoadShedding policy(0.5, 0.2, 0.9, HOLD_SUBFRAMES);
+  for(uint32_t i = 0; i < 100; i++) {
+    assert(policy.update(load(IDLE, 100)) == LOAD_SHEDDING_NONE);
+  }
+  assert(policy.update(load(NOF_BUFFERS, 100)) == LOAD_SHEDDING_SKIP_SECONDARY);
+  for(uint32_t level = LOAD_SHEDDING_LIMIT_DEPTH; level < LOAD_SHEDDING_NOF_LEVELS; level++) {
+    for(uint32_t i = 1; i < NOF_BUFFERS; i++) {
+      assert(policy.update(load(NOF_BUFFERS, 100)) == level - 1);
+    }
+    assert(policy.update(load(NOF_BUFFERS, 100)) == level);
+  }
+  for(uint32_t i = 0; i < 100; i++) {
+    assert(policy.update(load(NOF_BUFFERS, 100)) == LOAD_SHEDDING_ACTIVE_SET_ONLY);
+  }
+}
+
+// workers slower than real time escalate even with free buffers
+void testUtilization() {
+  cout << "Testing escalation by decode time" << endl;
+  AdaptiveLoadShedding policy(0.5, 0.2, 0.9, HOLD_SUBFRAMES);
+  for(uint32_t i = 1; i < NOF_BUFFERS; i++) {
+    assert(policy.update(load(IDLE, 950)) == LOAD_SHEDDING_NONE);
+  }
+  assert(policy.update(load(IDLE, 950)) == LOAD_SHEDDING_SKIP_SECONDARY);
+  // below the limit, but not calm: no change
+  for(uint32_t i = 0; i < 2 * HOLD_SUBFRAMES; i++) {
+    assert(policy.update(load(2, 100)) == LOAD_SHEDDING_SKIP_SECONDARY);
+  }
+}
+
+// the level is lowered by one step after HOLD_SUBFRAMES calm subframes; load restarts the calm period
+void testDeescalation() {
+  cout << "Testing de-escalation" << endl;
+  AdaptiveLoadShedding policy(0.5, 0.2, 0.9, HOLD_SUBFRAMES);
+  for(uint32_t i = 0; i < NOF_BUFFERS * LOAD_SHEDDING_NOF_LEVELS; i++) {
+    policy.update(load(NOF_BUFFERS, 100));
+  }
+  assert(policy.update(load(NOF_BUFFERS, 100)) == LOAD_SHEDDING_ACTIVE_SET_ONLY);
+
+  for(uint32_t i = 1; i < HOLD_SUBFRAMES; i++) {
+    assert(policy.update(load(IDLE, 100)) == LOAD_SHEDDING_ACTIVE_SET_ONLY);
+  }
+  // a load peak restarts the calm period without escalating (already at the last level)
+  assert(policy.update(load(NOF_BUFFERS, 100)) == LOAD_SHEDDING_ACTIVE_SET_ONLY);
+  for(int32_t level = LOAD_SHEDDING_ACTIVE_SET_ONLY; level > LOAD_SHEDDING_NONE; level--) {
+    for(uint32_t i = 1; i < HOLD_SUBFRAMES; i++) {
+      assert(policy.update(load(IDLE, 100)) == level);
+    }
+    assert(policy.update(load(IDLE, 100)) == level - 1);
+  }
+  for(uint32_t i = 0; i < 2 * HOLD_SUBFRAMES; i++) {
+    assert(policy.update(load(IDLE, 100)) == LOAD_SHEDDING_NONE);
+  }
+}
+
+// idle pipelines as reported by Phy (-K buffers, one held by the receiver) never escalate and always recover
+void testIdlePhy() {
+  cout << "Testing idle pipelines of all sizes" << endl;
+  for(uint32_t nof_subframe_buffers = 2; nof_subframe_buffers <= 32; nof_subframe_buffers++) {
+    AdaptiveLoadShedding policy(0.5, 0.2, 0.9, HOLD_SUBFRAMES);
+    LoadSheddingInput input;
+    input.nof_buffers = nof_subframe_buffers - 1;
+    input.nof_worker_threads = 1;
+    input.decode_time_us = 100;
+    input.nof_pending = IDLE;
+    for(uint32_t i = 0; i < 10 * HOLD_SUBFRAMES; i++) {
+      assert(policy.update(input) == LOAD_SHEDDING_NONE);
+    }
+    input.nof_pending = input.nof_buffers;
+    input.decode_time_us = 5000;
+    for(uint32_t i = 0; i < 10 * HOLD_SUBFRAMES; i++) {
+      policy.update(input);
+    }
+    assert(policy.update(input) == LOAD_SHEDDING_ACTIVE_SET_ONLY);
+    input.nof_pending = IDLE;
+    input.decode_time_us = 100;
+    for(uint32_t i = 0; i < LOAD_SHEDDING_NOF_LEVELS * HOLD_SUBFRAMES; i++) {
+      policy.update(input);
+    }
+    assert(policy.update(input) == LOAD_SHEDDING_NONE);
+  }
+}
+
+int main(int argc, char** argv) {
+  testCreate();
+  testEscalation();
+  testUtilization();
+  testDeescalation();
+  testIdlePhy();
+
+  cout << "All tests passed" << endl;
+  return 0;
+}
@@ -0,0 +1,152 @@
+/*
+ * Copyright (c) 2019 Robert Falkenberg.
+ *
+ * This file is part of FALCON 
+ * (see https://github.com/falkenber9/falcon).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ */
+#include "falcon/common/LockFreeQueue.h"
+
+#include <iostream>
+#include <vector>
+#include <thread>
+#include <atomic>
+
+// this code makes use of assert(EXPRESSION).
+// Since it drops EXPRESSION if NDEBUG is defined,
+// i.e. in release mode, we undefine it here...
+#undef NDEBUG
+#include <assert.h>
+
+using namespace std;
+
+void testBounds() {
+  cout << "Testing capacity and order" << endl;
+  LockFreeQueue<uint32_t> q(5);
+  assert(q.capacity() == 8);
+  vector<uint32_t> values(9);
+  for(uint32_t i = 0; i < 8; i++) {
+    values[i] = i;
+    assert(q.enqueue(&values[i]));
+  }
+  assert(!q.enqueue(&values[8]));
+  assert(q.size() == 8);
+  for(uint32_t i = 0; i < 8; i++) {
+    uint32_t* v = q.dequeueImmediate();
+    assert(v == &values[i]);
+  }
+  assert(q.dequeueImmediate() == nullptr);
+  assert(q.empty());
+}
+
+void testCancel() {
+  cout << "Testing cancel of parked consumer" << endl;
+  LockFreeQueue<uint32_t> q(4, 10);
+  uint32_t* result = reinterpret_cast<uint32_t*>(1);
+  thread consumer([&]() { result = q.dequeue(); });
+  this_thread::sleep_for(chrono::milliseconds(50));
+  q.cancel();
+  consumer.join();
+  assert(result == nullptr);
+}
+
+void testWaitEmpty() {
+  cout << "Testing wait for empty queue" << endl;
+  LockFreeQueue<uint32_t> q(4, 10);
+  uint32_t values[3];
+  assert(q.waitEmpty());
+  for(uint32_t i = 0; i < 3; i++) {
+    assert(q.enqueue(&values[i]));
+  }
+  thread consumer([&]() {
+    for(uint32_t i = 0; i < 3; i++) {
+      this_thread::sleep_for(chrono::milliseconds(10));
+      assert(q.dequeue() == &values[i]);
+    }
+  });
+  assert(q.waitEmpty());
+  consumer.join();
+
+  // canceled while waiting
+  assert(q.enqueue(&values[0]));
+  thread canceler([&]() {
+    this_thread::sleep_for(chrono::milliseconds(20));
+    q.cancel();
+  });
+  assert(!q.waitEmpty());
+  canceler.join();
+}
+
+void testConcurrent() {
+  cout << "Testing concurrent producers and consumers" << endl;
+  const uint32_t nof_producers = 4;
+  const uint32_t nof_consumers = 4;
+  const uint32_t nof_items = 100000;
+  // few elements circulate between two queues, like workers between avail and pending
+  LockFreeQueue<uint32_t> avail(16, 100);
+  LockFreeQueue<uint32_t> pending(16, 100);
+  vector<uint32_t> handles(16);
+  for(auto& h : handles) {
+    assert(avail.enqueue(&h));
+  }
+  atomic<uint64_t> sum(0);
+  atomic<uint32_t> consumed(0);
+
+  vector<thread> consumers;
+  for(uint32_t i = 0; i < nof_consumers; i++) {
+    consumers.push_back(thread([&]() {
+      uint32_t* h;
+      while((h = pending.dequeue()) != nullptr) {
+        sum += *h;
+        consumed++;
+        assert(avail.enqueue(h));
+      }
+    }));
+  }
+  vector<thread> producers;
+  for(uint32_t p = 0; p < nof_producers; p++) {
+    producers.push_back(thread([&, p]() {
+      for(uint32_t i = p; i < nof_items; i += nof_producers) {
+        uint32_t* h = avail.dequeue();
+        assert(h != nullptr);
+        *h = i;
+        assert(pending.enqueue(h));
+      }
+    }));
+  }
+  for(auto& t : producers) {
+    t.join();
+  }
+  pending.waitEmpty();
+  while(consumed.load() < nof_items) {
+    this_thread::yield();
+  }
+  pending.cancel();
+  for(auto& t : consumers) {
+    t.join();
+  }
+  assert(consumed.load() == nof_items);
+  assert(sum.load() == static_cast<uint64_t>(nof_items) * (nof_items - 1) / 2);
+  assert(avail.size() == handles.size());
+}
+
+int main(int argc, char** argv) {
+  testBounds();
+  testCancel();
+  testWaitEmpty();
+  testConcurrent();
+  cout << "OK" << endl;
+}
@@ -0,0 +1,159 @@
+/*
+ * Copyright (c) 2019 Robert Falkenberg.
+ *
+ * This file is part of FALCON
+ * (see https://github.com/falkenber9/falcon).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ */
+#include "falcon/phy/falcon_phch/falcon_occupancy_gate.h"
+
+#include <iostream>
+#include <cstdio>
+#include <cstring>
+#include <cmath>
+#include <string>
+#include <unistd.h>
+
+// this code makes use of assert(EXPRESSION).
+// Since it drops EXPRESSION if NDEBUG is defined,
+// i.e. in release mode, we undefine it here...
+#undef NDEBUG
+#include <assert.h>
+
+using namespace std;
+
+static string modelFile() {
+  char name[] = "/tmp/TestOccupancyGateXXXXXX";
+  int fd = mkstemp(name);
+  assert(fd >= 0);
+  close(fd);
+  return name;
+}
+
+static void writeFile(const string& filename, const char* content) {
+  FILE* f = fopen(filename.c_str(), "w");
+  assert(f != nullptr);
+  fputs(content, f);
+  fclose(f);
+}
+
+static falcon_dci_location_t location(uint32_t L, float power, float spread, float relative_power) {
+  falcon_dci_location_t loc;
+  memset(&loc, 0, sizeof(loc));
+  loc.L = L;
+  loc.power = power;
+  loc.spread = spread;
+  loc.relative_power = relative_power;
+  return loc;
+}
+
+// the built-in model separates clean QPSK (small spread) from noise
+void testDefaultModel() {
+  cout << "Testing built-in model" << endl;
+  falcon_occupancy_gate_t gate;
+  falcon_occupancy_gate_init(&gate);
+  for(uint32_t l = 0; l < FALCON_OCCUPANCY_NOF_LEVELS; l++) {
+    falcon_dci_location_t dci = location(l, 1, 0.05f, 1);
+    falcon_dci_location_t noise = location(l, 1, 0.57f, 1);
+    assert(falcon_occupancy_gate_predict(&gate, &dci) > 0.9f);
+    assert(falcon_occupancy_gate_predict(&gate, &noise) < 0.5f);
+  }
+}
+
+// model files: comments are skipped, each level has its own weights
+void testLoad() {
+  cout << "Testing model file parsing" << endl;
+  string filename = modelFile();
+  writeFile(filename,
+            "# l w_bias w_power w_spread w_relative_power\n"
+            "0 1 0 0 0\n"
+            "\n"
+            "1 -1 0 0 0\n"
+            "# comment between levels\n"
+            "2 0 2 0 0\n"
+            "3 0 0 0 -3\n");
+  falcon_occupancy_gate_t gate;
+  falcon_occupancy_gate_init(&gate);
+  assert(falcon_occupancy_gate_load(&gate, filename.c_str()) == SRSLTE_SUCCESS);
+  assert(gate.weights[0][0] == 1.0f);
+  assert(gate.weights[1][0] == -1.0f);
+  assert(gate.weights[2][1] == 2.0f);
+  assert(gate.weights[3][3] == -3.0f);
+
+  falcon_dci_location_t loc = location(0, 0.5f, 0.3f, 2);
+  assert(fabsf(falcon_occupancy_gate_predict(&gate, &loc) - 1.0f / (1.0f + expf(-1.0f))) < 1e-6f);
+  loc.L = 2;
+  assert(fabsf(falcon_occupancy_gate_predict(&gate, &loc) - 1.0f / (1.0f + expf(-1.0f))) < 1e-6f);
+  loc.L = 3;
+  assert(fabsf(falcon_occupancy_gate_predict(&gate, &loc) - 1.0f / (1.0f + expf(6.0f))) < 1e-6f);
+
+  // save and load again
+  assert(falcon_occupancy_gate_save(&gate, filename.c_str()) == SRSLTE_SUCCESS);
+  falcon_occupancy_gate_t reloaded;
+  falcon_occupancy_gate_init(&reloaded);
+  assert(falcon_occupancy_gate_load(&reloaded, filename.c_str()) == SRSLTE_SUCCESS);
+  assert(memcmp(&gate, &reloaded, sizeof(gate)) == 0);
+  remove(filename.c_str());
+}
+
+// invalid models are rejected and leave the gate unchanged
+void testLoadInvalid() {
+  cout << "Testing rejection of invalid model files" << endl;
+  falcon_occupancy_gate_t gate;
+  falcon_occupancy_gate_init(&gate);
+  falcon_occupancy_gate_t reference = gate;
+
+  string filename = modelFile();
+  writeFile(filename, "0 1 0 0 0\n1 1 0 0 0\n3 1 0 0 0\n");  // level 2 missing
+  assert(falcon_occupancy_gate_load(&gate, filename.c_str()) == SRSLTE_ERROR);
+  writeFile(filename, "0 1 0 0 0\n1 1 0 0 0\n2 1 0 0 0\n4 1 0 0 0\n");  // level out of range
+  assert(falcon_occupancy_gate_load(&gate, filename.c_str()) == SRSLTE_ERROR);
+  writeFile(filename, "0 1 0 0 0\n1 1 0 0\n2 1 0 0 0\n3 1 0 0 0\n");  // weight missing
+  assert(falcon_occupancy_gate_load(&gate, filename.c_str()) == SRSLTE_ERROR);
+  remove(filename.c_str());
+  assert(falcon_occupancy_gate_load(&gate, filename.c_str()) == SRSLTE_ERROR);
+  assert(memcmp(&gate, &reference, sizeof(gate)) == 0);
+}
+
+// the threshold keeps target_recall of the DCI
+void testThreshold() {
+  cout << "Testing threshold selection" << endl;
+  float occupancy[200];
+  for(uint32_t i = 0; i < 200; i++) {
+    occupancy[i] = static_cast<float>((i * 37) % 200) / 200;  // permutation of 0..199
+  }
+  // 0.5% of 200: the lowest DCI falls below the threshold
+  float threshold = falcon_occupancy_gate_threshold(occupancy, 200, 0.995);
+  assert(threshold == 1.0f / 200);
+  for(uint32_t i = 1; i < 200; i++) {
+    assert(occupancy[i - 1] <= occupancy[i]);
+  }
+  assert(falcon_occupancy_gate_threshold(occupancy, 200, 1.0) == 0.0f);
+  assert(falcon_occupancy_gate_threshold(occupancy, 200, 0.75) == 50.0f / 200);
+  // never above the highest DCI
+  assert(falcon_occupancy_gate_threshold(occupancy, 200, 0.0) == 199.0f / 200);
+  assert(falcon_occupancy_gate_threshold(occupancy, 0, 0.995) == 0.0f);
+}
+
+int main(int argc, char** argv) {
+  testDefaultModel();
+  testLoad();
+  testLoadInvalid();
+  testThreshold();
+
+  cout << "All tests passed" << endl;
+  return 0;
+}
@@ -0,0 +1,305 @@
+/*
+ * Copyright (c) 2019 Robert Falkenberg.
+ *
+ * This file is part of FALCON 
+ * (see https://github.com/falkenber9/falcon).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ */
+#include "falcon/util/RNTIManager.h"
+
+#include <iostream>
+#include <vector>
+#include <thread>
+#include <random>
+#include <stdio.h>
+
+// this code makes use of assert(EXPRESSION).
+// Since it drops EXPRESSION if NDEBUG is defined,
+// i.e. in release mode, we undefine it here...
+#undef NDEBUG
+#include <assert.h>
+
+using namespace std;
+
+#define NOF_FORMATS 3
+#define UL 0
+#define DL 1
+
+void testActivation() {
+  cout << "Testing histogram activation and expiry" << endl;
+  RNTIManager rm(NOF_FORMATS, 10);
+  RNTICandidateDelta delta;
+  uint32_t tti = 0;
+  for(uint32_t i = 0; i <= RNTI_HISTOGRAM_THRESHOLD; i++) {
+    assert(!rm.validate(1234, UL));
+    delta.add(1234, UL);
+    rm.commitSubframe(tti++, delta);
+    assert(delta.getCandidates(UL).empty());
+  }
+  assert(rm.getFrequency(1234, UL) == RNTI_HISTOGRAM_THRESHOLD + 1);
+  assert(rm.validateAndRefresh(1234, UL));
+  assert(rm.getActivationReason(1234) == RM_ACT_HISTOGRAM);
+  assert(rm.getActiveSet().size() == 1);
+
+  // time advances by subframe number, not by calls
+  uint32_t t = rm.getTimestamp();
+  rm.commitSubframe(tti + 99, delta);
+  assert(rm.getTimestamp() == t + 100);
+  // late subframe does not step back
+  rm.commitSubframe(tti + 50, delta);
+  assert(rm.getTimestamp() == t + 100);
+  // sfn wrap-around
+  rm.commitSubframe((tti + 99 + 10) % RNTI_MANAGER_NOF_TTI, delta);
+  assert(rm.getTimestamp() == t + 110);
+
+  // skipped subframes age the window like committed ones
+  assert(rm.getFrequency(1234, UL) == RNTI_HISTOGRAM_THRESHOLD + 1);
+  rm.commitSubframe((tti + 109 + RNTI_HISTORY_DEPTH / 10 / 2) % RNTI_MANAGER_NOF_TTI, delta);
+  assert(rm.getFrequency(1234, UL) == RNTI_HISTOGRAM_THRESHOLD + 1);
+  rm.commitSubframe((tti + 109 + RNTI_HISTORY_DEPTH / 10) % RNTI_MANAGER_NOF_TTI, delta);
+  assert(rm.getFrequency(1234, UL) == 0);
+
+  // expire
+  rm.stepTime(RRC_INACTIVITY_TIMER_MS);
+  assert(rm.getActiveSet().empty());
+  assert(rm.getActivationReason(1234) == RM_ACT_UNSET);
+}
+
+void testExplicitActivation() {
+  cout << "Testing explicit activation and format lock" << endl;
+  RNTIManager rm(NOF_FORMATS, 10);
+  rm.activateAndRefresh(100, DL, RM_ACT_RAR);
+  assert(rm.validate(100, UL));
+  assert(rm.validate(100, DL));
+  assert(rm.getAssociatedFormatIdx(100) == DL);
+  rm.activateAndRefresh(100, DL + 1, RM_ACT_SHORTCUT);
+  assert(rm.getAssociatedFormatIdx(100) == DL + 1);
+  assert(rm.getActivationReason(100) == RM_ACT_RAR);  // first reason persists
+  assert(rm.getActiveSet().size() == 1);
+}
+
+void testActiveSet() {
+  cout << "Testing active set and timer wheel" << endl;
+  RNTIManager rm(NOF_FORMATS, 10);
+  for(uint16_t rnti = 1; rnti <= 300; rnti++) {
+    rm.activateAndRefresh(rnti, DL, RM_ACT_OTHER);
+  }
+  assert(rm.getNofActive() == 300);
+  rm.stepTime(RRC_INACTIVITY_TIMER_MS / 2);
+  // keep every third RNTI alive
+  for(uint16_t rnti = 3; rnti <= 300; rnti += 3) {
+    assert(rm.validateAndRefresh(rnti, UL));
+  }
+  rm.stepTime(RRC_INACTIVITY_TIMER_MS / 2 + RNTI_TIMER_WHEEL_RESOLUTION);
+  // expired without scanning, i.e. without any query of the active set
+  assert(rm.getNofActive() == 100);
+  uint32_t n = 0;
+  rm.forEachActive([&n](const rnti_manager_active_set_t& entry) {
+    assert(entry.rnti % 3 == 0);
+    assert(entry.reason == RM_ACT_OTHER);
+    n++;
+  });
+  assert(n == 100);
+  rnti_manager_active_set_t buf[10];
+  assert(rm.getActiveSet(buf, 10) == 10);
+
+  // reactivation after expiry
+  rm.stepTime(RRC_INACTIVITY_TIMER_MS + RNTI_TIMER_WHEEL_RESOLUTION);
+  assert(rm.getNofActive() == 0);
+  rm.activateAndRefresh(5, DL, RM_ACT_RAR);
+  assert(rm.getNofActive() == 1);
+  assert(rm.getActivationReason(5) == RM_ACT_RAR);
+}
+
+void testLongRun() {
+  cout << "Testing wrap-around of last-seen timestamps" << endl;
+  RNTIManager rm(NOF_FORMATS, 10);
+  rm.activateAndRefresh(42, DL, RM_ACT_OTHER);
+  for(uint32_t i = 0; i < 100; i++) {
+    rm.stepTime(1000);
+    assert(rm.validateAndRefresh(42, UL));
+  }
+  rm.stepTime(5);
+  vector<rnti_manager_active_set_t> activeSet = rm.getActiveSet();
+  assert(activeSet.size() == 1);
+  assert(activeSet[0].last_seen == 5);
+  rm.stepTime(RRC_INACTIVITY_TIMER_MS + RNTI_TIMER_WHEEL_RESOLUTION);
+  assert(rm.getNofActive() == 0);
+  assert(!rm.validate(42, DL));
+
+  // reactivation after a long pause starts a new lifetime
+  rm.stepTime(30000);
+  rm.activateAndRefresh(42, DL, RM_ACT_OTHER);
+  activeSet = rm.getActiveSet();
+  assert(activeSet.size() == 1);
+  assert(activeSet[0].last_seen == 0);
+  rm.stepTime(RRC_INACTIVITY_TIMER_MS + RNTI_TIMER_WHEEL_RESOLUTION);
+  assert(rm.getNofActive() == 0);
+}
+
+void testTimestampWrap() {
+  cout << "Testing wrap-around of the timestamp" << endl;
+  RNTIManager rm(NOF_FORMATS, 10);
+  RNTICandidateDelta delta;
+  uint32_t tti = 0;
+  // jump close to 2^32 in large subframe steps
+  while(rm.getTimestamp() < 0xffffffffu - 2 * RRC_INACTIVITY_TIMER_MS) {
+    tti = (tti + RNTI_MANAGER_NOF_TTI / 2 - 1) % RNTI_MANAGER_NOF_TTI;
+    rm.commitSubframe(tti, delta);
+  }
+  rm.activateAndRefresh(42, DL, RM_ACT_OTHER);
+  for(uint32_t i = 0; i < 4 * RRC_INACTIVITY_TIMER_MS; i += 1000) {
+    rm.stepTime(1000);
+    assert(rm.validateAndRefresh(42, UL));
+  }
+  assert(rm.getTimestamp() < RRC_INACTIVITY_TIMER_MS * 3);
+  rm.activateAndRefresh(43, DL, RM_ACT_OTHER);
+  assert(rm.getNofActive() == 2);
+  rm.stepTime(RRC_INACTIVITY_TIMER_MS + RNTI_TIMER_WHEEL_RESOLUTION);
+  assert(rm.getNofActive() == 0);
+}
+
+void testConcurrent(uint32_t denseRange) {
+  cout << "Testing concurrent workers" << endl;
+  const uint32_t nof_threads = 4;
+  const uint32_t nof_subframes = 2000;
+  RNTIManager rm(NOF_FORMATS, 10, denseRange);
+  vector<thread> threads;
+  for(uint32_t w = 0; w < nof_threads; w++) {
+    threads.push_back(thread([&rm, w]() {
+      RNTICandidateDelta delta;
+      for(uint32_t tti = w; tti < nof_subframes; tti += nof_threads) {
+        uint16_t rnti = static_cast<uint16_t>(1000 + tti % 8);
+        rm.validateAndRefresh(rnti, UL);
+        rm.activateAndRefresh(static_cast<uint16_t>(2000 + w), DL, RM_ACT_OTHER);
+        delta.add(rnti, UL);
+        rm.commitSubframe(tti, delta);
+        rm.getActiveSet();
+      }
+    }));
+  }
+  for(auto& t : threads) {
+    t.join();
+  }
+  for(uint16_t rnti = 1000; rnti < 1008; rnti++) {
+    assert(rm.validate(rnti, UL));
+  }
+  assert(rm.getActiveSet().size() == 8 + nof_threads);
+}
+
+void testActivityEstimator(const string& name) {
+  cout << "Testing activity estimator " << name << endl;
+  RNTIManager rm(NOF_FORMATS, RNTI_PER_SUBFRAME);
+  assert(!rm.setActivityEstimator("unknown"));
+  assert(rm.setActivityEstimator(name));
+  assert(name == rm.getActivityEstimatorName());
+
+  mt19937 gen(1);
+  uniform_int_distribution<uint32_t> anyRnti(RNTI_CRNTI_START, 0xFFF3);
+  RNTICandidateDelta delta;
+  vector<uint16_t> noise;
+  for(uint32_t tti = 0; tti < 2000; tti++) {
+    noise.clear();
+    for(uint32_t i = 0; i < 40; i++) {
+      noise.push_back(static_cast<uint16_t>(anyRnti(gen)));
+      delta.add(noise.back(), UL);
+    }
+    if(tti % 20 == 0) {
+      delta.add(1000, UL);  // 10 times per window
+    }
+    if(tti % 100 == 0) {
+      delta.add(2000, UL);  // 2 times per window
+    }
+    rm.commitSubframe(tti % RNTI_MANAGER_NOF_TTI, delta);
+  }
+  assert(rm.getFrequency(1000, UL) >= 8 && rm.getFrequency(1000, UL) <= 12);
+  assert(rm.validate(1000, UL));
+  assert(!rm.validate(2000, UL));
+  uint32_t nof_false_positives = 0;
+  for(uint16_t rnti : noise) {
+    if(rm.validate(rnti, UL)) {
+      nof_false_positives++;
+    }
+  }
+  assert(nof_false_positives == 0);
+
+  // accept anything seen recently
+  rm.setThreshold(0);
+  assert(rm.getThreshold() == 0);
+  assert(rm.validate(noise.back(), UL));
+}
+
+void testSnapshot() {
+  cout << "Testing snapshot and restore" << endl;
+  const char* filename = "TestRNTIManager.snapshot";
+  RNTIManager rm(NOF_FORMATS, 10);
+  RNTICandidateDelta delta;
+  for(uint32_t tti = 0; tti < 100; tti++) {
+    delta.add(1234, UL);
+    delta.add(1234, DL);
+    rm.commitSubframe(tti, delta);
+  }
+  rm.activateAndRefresh(100, DL, RM_ACT_RAR);
+  rm.stepTime(10);
+  assert(rm.saveSnapshot(filename, 42));
+
+  // other cell
+  RNTIManager other(NOF_FORMATS, 10);
+  assert(!other.loadSnapshot(filename, 43, 0));
+  assert(other.getNofActive() == 0);
+
+  RNTIManager warm(NOF_FORMATS, 10);
+  assert(warm.loadSnapshot(filename, 42, 0));
+  assert(warm.getNofActive() == 1);
+  assert(warm.getActivationReason(100) == RM_ACT_RAR);
+  assert(warm.getAssociatedFormatIdx(100) == DL);
+  assert(warm.getActiveSet()[0].last_seen == 10);
+  assert(warm.getFrequency(1234, UL) == 100);
+  assert(warm.validate(1234, DL));
+
+  // half of the window has passed, active RNTIs are older
+  RNTIManager aged(NOF_FORMATS, 10);
+  assert(aged.loadSnapshot(filename, 42, RNTI_HISTORY_DEPTH_MSEC / 2));
+  assert(aged.getFrequency(1234, UL) == 50);
+  assert(aged.getActiveSet()[0].last_seen == 10 + RNTI_HISTORY_DEPTH_MSEC / 2);
+  // restored frequencies age out with the remaining half of the window
+  aged.stepTime(RNTI_HISTORY_DEPTH / 2 / 10 - 10);
+  assert(aged.getFrequency(1234, UL) == 50);
+  aged.stepTime(10);
+  assert(aged.getFrequency(1234, UL) == 0);
+
+  // expired
+  RNTIManager late(NOF_FORMATS, 10);
+  assert(late.loadSnapshot(filename, 42, RRC_INACTIVITY_TIMER_MS));
+  assert(late.getNofActive() == 0);
+  assert(late.getFrequency(1234, UL) == 0);
+  remove(filename);
+}
+
+int main(int argc, char** argv) {
+  testActivation();
+  testExplicitActivation();
+  testActiveSet();
+  testLongRun();
+  testTimestampWrap();
+  testSnapshot();
+  testActivityEstimator("histogram");
+  testActivityEstimator("decay");
+  testActivityEstimator("sketch");
+  testConcurrent(RNTI_HISTOGRAM_DENSE_RANGE);
+  testConcurrent(RNTI_CRNTI_START);
+  cout << "OK" << endl;
+}
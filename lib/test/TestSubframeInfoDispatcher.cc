@@ -0,0 +1,279 @@
+/*
+ * Copyright (c) 2019 Robert Falkenberg.
+ *
+ * This file is part of FALCON 
+ * (see https://github.com/falkenber9/falcon).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ */
+#include "eye/phy/SubframeInfoDispatcher.h"
+
+#include <iostream>
+#include <vector>
+#include <thread>
+#include <chrono>
+#include <mutex>
+#include <condition_variable>
+
+// this code makes use of assert(EXPRESSION).
+// Since it drops EXPRESSION if NDEBUG is defined,
+// i.e. in release mode, we undefine it here...
+#undef NDEBUG
+#include <assert.h>
+
+using namespace std;
+
+struct Event {
+  uint32_t sfn;
+  uint32_t sf_idx;
+  bool gap;
+  SubframeGapReason reason;
+};
+
+// records results and gaps in the order of consumption; blocks in the first result while closed
+class Recorder : public SubframeInfoConsumer {
+public:
+  Recorder() : closed(false), entered(false) {}
+  virtual void consumeDCICollection(const SubframeInfo& subframeInfo) override {
+    const DCICollection& collection = subframeInfo.getDCICollection();
+    std::unique_lock<std::mutex> lock(m);
+    entered = true;
+    c.notify_all();
+    while(closed) {
+      c.wait(lock);
+    }
+    events.push_back(Event{collection.get_sfn(), collection.get_sf_idx(), false, SUBFRAME_GAP_SKIPPED});
+  }
+  virtual void consumeSubframeGap(uint32_t sfn, uint32_t sf_idx, SubframeGapReason reason) override {
+    std::lock_guard<std::mutex> lock(m);
+    events.push_back(Event{sfn, sf_idx, true, reason});
+  }
+  void close() {
+    std::lock_guard<std::mutex> lock(m);
+    closed = true;
+    entered = false;
+  }
+  void open() {
+    std::lock_guard<std::mutex> lock(m);
+    closed = false;
+    c.notify_all();
+  }
+  void waitEntered() {
+    std::unique_lock<std::mutex> lock(m);
+    while(!entered) {
+      c.wait(lock);
+    }
+  }
+  vector<Event> getEvents() {
+    std::lock_guard<std::mutex> lock(m);
+    return events;
+  }
+private:
+  std::mutex m;
+  std::condition_variable c;
+  bool closed;
+  bool entered;
+  vector<Event> events;
+};
+
+static shared_ptr<SubframeInfo> result(uint32_t sfn, uint32_t sf_idx) {
+  srslte_cell_t cell = {};
+  cell.nof_prb = 6;
+  shared_ptr<SubframeInfo> subframeInfo(new SubframeInfo(cell));
+  subframeInfo->getDCICollection().setSubframe(sfn, sf_idx, 1);
+  return subframeInfo;
+}
+
+static bool isResult(const Event& event, uint32_t sfn, uint32_t sf_idx) {
+  return !event.gap && event.sfn == sfn && event.sf_idx == sf_idx;
+}
+
+static bool isGap(const Event& event, uint32_t sfn, uint32_t sf_idx, SubframeGapReason reason) {
+  return event.gap && event.sfn == sfn && event.sf_idx == sf_idx && event.reason == reason;
+}
+
+// results delivered out of order are consumed in order of (sfn, sf_idx), across the wrap of sfn
+void testResultOrder() {
+  cout << "Testing order of results" << endl;
+  shared_ptr<Recorder> recorder(new Recorder());
+  SubframeInfoDispatcher dispatcher(10);
+  dispatcher.setConsumer(recorder);
+  dispatcher.start();
+  const uint32_t tti[8] = {10235, 10236, 10237, 10238, 10239, 0, 1, 2};
+  for(uint32_t i = 0; i < 8; i++) {
+    dispatcher.announce(tti[i] / 10, tti[i] % 10);
+  }
+  const uint32_t order[8] = {6, 2, 7, 5, 0, 4, 1, 3};
+  for(uint32_t i = 0; i < 8; i++) {
+    dispatcher.deliver(tti[order[i]] / 10, tti[order[i]] % 10, result(tti[order[i]] / 10, tti[order[i]] % 10));
+  }
+  dispatcher.flush();
+  vector<Event> events = recorder->getEvents();
+  assert(events.size() == 8);
+  for(uint32_t i = 0; i < 8; i++) {
+    assert(isResult(events[i], tti[i] / 10, tti[i] % 10));
+  }
+  assert(dispatcher.getStats().nof_dispatched == 8);
+  dispatcher.cancel();
+  dispatcher.wait_thread_finish();
+}
+
+// a slow consumer drops the oldest results, a slow worker is given up as late
+void testWindowOverflow() {
+  cout << "Testing reorder window overflow" << endl;
+  shared_ptr<Recorder> recorder(new Recorder());
+  SubframeInfoDispatcher dispatcher(2);
+  dispatcher.setConsumer(recorder);
+  dispatcher.start();
+
+  recorder->close();
+  dispatcher.announce(0, 0);
+  dispatcher.deliver(0, 0, result(0, 0));
+  recorder->waitEntered();
+  for(uint32_t sf_idx = 1; sf_idx <= 3; sf_idx++) {
+    dispatcher.announce(0, sf_idx);
+    dispatcher.deliver(0, sf_idx, result(0, sf_idx));
+  }
+  recorder->open();
+  dispatcher.flush();
+
+  dispatcher.announce(0, 4);
+  dispatcher.announce(0, 5);
+  dispatcher.announce(0, 6);
+  dispatcher.deliver(0, 5, result(0, 5));
+  dispatcher.deliver(0, 6, result(0, 6));
+  dispatcher.deliver(0, 4, result(0, 4));   // late, discarded
+  dispatcher.flush();
+
+  vector<Event> events = recorder->getEvents();
+  assert(events.size() == 7);
+  assert(isResult(events[0], 0, 0));
+  assert(isGap(events[1], 0, 1, SUBFRAME_GAP_DROPPED));
+  assert(isResult(events[2], 0, 2));
+  assert(isResult(events[3], 0, 3));
+  assert(isGap(events[4], 0, 4, SUBFRAME_GAP_LATE));
+  assert(isResult(events[5], 0, 5));
+  assert(isResult(events[6], 0, 6));
+  SubframeInfoDispatcherStats stats = dispatcher.getStats();
+  assert(stats.nof_dispatched == 5);
+  assert(stats.nof_dropped == 1);
+  assert(stats.nof_late == 1);
+  dispatcher.cancel();
+  dispatcher.wait_thread_finish();
+}
+
+// skipping announced subframes frees their place in the window
+void testSkipAnnounced() {
+  cout << "Testing skip of announced subframes" << endl;
+  shared_ptr<Recorder> recorder(new Recorder());
+  SubframeInfoDispatcher dispatcher(2);
+  dispatcher.setConsumer(recorder);
+  recorder->close();
+  dispatcher.start();
+  dispatcher.announce(0, 0);
+  dispatcher.deliver(0, 0, result(0, 0));
+  recorder->waitEntered();
+  // pending and ready entries turned into gaps
+  for(uint32_t sf_idx = 1; sf_idx < 10; sf_idx++) {
+    dispatcher.announce(0, sf_idx);
+    if(sf_idx % 2 == 0) {
+      dispatcher.deliver(0, sf_idx, result(0, sf_idx));
+    }
+    dispatcher.skip(0, sf_idx);
+  }
+  dispatcher.announce(1, 0);
+  dispatcher.announce(1, 1);
+  dispatcher.deliver(1, 1, result(1, 1));
+  dispatcher.deliver(1, 0, result(1, 0));
+  recorder->open();
+  dispatcher.flush();
+
+  vector<Event> events = recorder->getEvents();
+  assert(events.size() == 12);
+  assert(isResult(events[0], 0, 0));
+  for(uint32_t sf_idx = 1; sf_idx < 10; sf_idx++) {
+    assert(isGap(events[sf_idx], 0, sf_idx, SUBFRAME_GAP_SKIPPED));
+  }
+  assert(isResult(events[10], 1, 0));
+  assert(isResult(events[11], 1, 1));
+  SubframeInfoDispatcherStats stats = dispatcher.getStats();
+  assert(stats.nof_late == 0);
+  assert(stats.nof_dropped == 0);
+  assert(stats.nof_skipped == 9);
+  dispatcher.cancel();
+  dispatcher.wait_thread_finish();
+}
+
+// subframes after the wrap of sfn wait for the pending subframes before it
+void testOrderAcrossWrap() {
+  cout << "Testing order across sfn wrap-around" << endl;
+  shared_ptr<Recorder> recorder(new Recorder());
+  SubframeInfoDispatcher dispatcher(10);
+  dispatcher.setConsumer(recorder);
+  dispatcher.start();
+  dispatcher.announce(1023, 8);
+  dispatcher.announce(1023, 9);
+  dispatcher.announce(0, 0);
+  dispatcher.announce(0, 1);
+  dispatcher.skip(0, 1);
+  dispatcher.skip(0, 0);
+  this_thread::sleep_for(chrono::milliseconds(20));
+  assert(recorder->getEvents().empty());
+  dispatcher.skip(1023, 9);
+  dispatcher.skip(1023, 8);
+  dispatcher.flush();
+  vector<Event> events = recorder->getEvents();
+  assert(events.size() == 4);
+  assert(isGap(events[0], 1023, 8, SUBFRAME_GAP_SKIPPED));
+  assert(isGap(events[1], 1023, 9, SUBFRAME_GAP_SKIPPED));
+  assert(isGap(events[2], 0, 0, SUBFRAME_GAP_SKIPPED));
+  assert(isGap(events[3], 0, 1, SUBFRAME_GAP_SKIPPED));
+  dispatcher.cancel();
+  dispatcher.wait_thread_finish();
+}
+
+// a full window gives up the oldest subframe, not the newest after the wrap
+void testTrimAcrossWrap() {
+  cout << "Testing reorder window across sfn wrap-around" << endl;
+  shared_ptr<Recorder> recorder(new Recorder());
+  SubframeInfoDispatcher dispatcher(2);
+  dispatcher.setConsumer(recorder);
+  dispatcher.start();
+  dispatcher.announce(1023, 9);
+  dispatcher.announce(0, 0);
+  dispatcher.announce(0, 1);
+  dispatcher.deliver(1023, 9, result(1023, 9));   // late, discarded
+  dispatcher.deliver(0, 0, result(0, 0));
+  dispatcher.deliver(0, 1, result(0, 1));
+  dispatcher.flush();
+  vector<Event> events = recorder->getEvents();
+  assert(events.size() == 3);
+  assert(isGap(events[0], 1023, 9, SUBFRAME_GAP_LATE));
+  assert(isResult(events[1], 0, 0));
+  assert(isResult(events[2], 0, 1));
+  assert(dispatcher.getStats().nof_late == 1);
+  dispatcher.cancel();
+  dispatcher.wait_thread_finish();
+}
+
+int main(int argc, char** argv) {
+  testResultOrder();
+  testWindowOverflow();
+  testSkipAnnounced();
+  testOrderAcrossWrap();
+  testTrimAcrossWrap();
+  cout << "All tests passed" << endl;
+  return 0;
+}
@@ -20,6 +20,8 @@
  */
 #include "falcon/common/Settings.h"
 #include "ArgManager.h"
+#include "falcon/phy/falcon_phch/falcon_viterbi.h"
+#include "falcon/util/RNTIManager.h"
 
 #include "srslte/srslte.h"
 
@@ -41,6 +43,7 @@ void ArgManager::defaultArgs(Args& args) {
   args.force_N_id_2 = -1; // Pick the best
   args.input_file_name = "";
   args.dci_file_name = "";
+  args.dci_trace_file_name = "";
   args.stats_file_name = "";
   //args.rnti_list_file = "";
   //args.rnti_list_file_out = "";
@@ -69,10 +72,29 @@ void ArgManager::defaultArgs(Args& args) {
   args.dci_format_split_ratio = DEFAULT_DCI_FORMAT_SPLIT_RATIO;
   args.skip_secondary_meta_formats = false;
   args.enable_shortcut_discovery = true;
+  args.nof_worker_threads = DEFAULT_NOF_WORKER_THREADS;
+  args.nof_search_threads = DEFAULT_NOF_SEARCH_THREADS;
+  args.reorder_buffer_depth = DEFAULT_REORDER_BUFFER_DEPTH;
+  args.nof_subframe_buffers = DEFAULT_NOF_SUBFRAME_BUFFERS;
+  args.rf_thread_prio = DEFAULT_RF_THREAD_PRIO;
+  args.load_shedding_policy = DEFAULT_LOAD_SHEDDING_POLICY;
+  args.rnti_activity_estimator = RNTI_DEFAULT_ACTIVITY_ESTIMATOR;
+  args.rnti_threshold = RNTI_HISTOGRAM_THRESHOLD;
+  args.rnti_snapshot_file_name = "";
+  args.dci_format_set = DEFAULT_DCI_FORMAT_SET;
+  args.max_recursion_depth = DEFAULT_MAX_RECURSION_DEPTH;
+  args.dci_disambiguation_depth = DEFAULT_DCI_DISAMBIGUATION_DEPTH;
+  args.viterbi_min_reliability = DEFAULT_VITERBI_MIN_RELIABILITY;
+  args.list_viterbi_size = DEFAULT_LIST_VITERBI_SIZE;
+  args.occupancy_threshold = DEFAULT_OCCUPANCY_THRESHOLD;
+  args.occupancy_model_file_name = "";
+  args.occupancy_trace_file_name = "";
+  args.enable_targeted_search = DEFAULT_TARGETED_DCI_SEARCH;
+  args.enable_harq_hints = DEFAULT_HARQ_HINTS;
 }
 
 void ArgManager::usage(Args& args, const std::string& prog) {
-  printf("Usage: %s [aAcCdfgHilnoOpPrRsStTvwyY] -f rx_frequency (in Hz) | -i input_file\n", prog.c_str());
+  printf("Usage: %s [aAbcCdefFgGHijkKlLmMnNoOpPqQrRsStTuUvwWxXyYz] -f rx_frequency (in Hz) | -i input_file\n", prog.c_str());
 #ifndef DISABLE_RF
   printf("\t-a RF args [Default %s]\n", args.rf_args.c_str());
   printf("\t-A Number of RX antennas [Default %d]\n", args.rf_nof_rx_ant);
@@ -88,6 +110,7 @@ void ArgManager::usage(Args& args, const std::string& prog) {
   printf("\t-i input_file [Default use RF board]\n");
   printf("\t-w wrap input_file after reading all samples\n");
   printf("\t-D output filename for DCI [default stdout]\n");
+  printf("\t-b output filename for DCI in binary trace format [default none]\n");
   printf("\t-E output filename for statistics [default stdout]\n");
   printf("\t-o offset frequency correction (in Hz) for input file [Default %.1f Hz]\n", args.file_offset_freq);
   printf("\t-O offset samples for input file [Default %d]\n", args.file_offset_time);
@@ -109,6 +132,25 @@ void ArgManager::usage(Args& args, const std::string& prog) {
   printf("\t-s skip decoding of secondary (less frequent) DCI formats\n");
   printf("\t-S split ratio for primary/secondary DCI formats [0.0..1.0, Default %f]\n", args.dci_format_split_ratio);
   printf("\t-T interval to perform dci format split [Default %d ms]\n", args.dci_format_split_update_interval_ms);
+  printf("\t-F DCI formats to search (owl: 0/1/1A/1B/1C/2/2A, falcon: 0/1/1A/1C/2A, siso: 0/1/1A/1B/1C/1D, all) [Default %s]\n", args.dci_format_set.c_str());
+  printf("\t-d max. recursion depth of the DCI search (0: breadth-first) [Default %d]\n", args.max_recursion_depth);
+  printf("\t-m recursion depth of the DCI disambiguation search (0: disabled) [Default %d]\n", args.dci_disambiguation_depth);
+  printf("\t-x abandon DCI decoding below this path reliability, enables list Viterbi (0: disabled, e.g. 0.75) [Default %.2f]\n", args.viterbi_min_reliability);
+  printf("\t-X list Viterbi: number of survivors for the RNTI validation (max. %d) [Default %d]\n", FALCON_VITERBI_MAX_LIST, args.list_viterbi_size);
+  printf("\t-G occupancy gate: min. estimated probability of a DCI to decode a location (0: disabled) [Default %.2f]\n", args.occupancy_threshold);
+  printf("\t-M occupancy gate model, trained by OccupancyGateTrainer [default built-in]\n");
+  printf("\t-Q record occupancy features and labels for OccupancyGateTrainer [default none]\n");
+  printf("\t-u decode the search spaces of active RNTIs before the blind DCI search [Default %s]\n", args.enable_targeted_search ? "enabled" : "disabled");
+  printf("\t-U decode DCI predicted by HARQ timing (8 subframes after a DCI) first [Default %s]\n", args.enable_harq_hints ? "enabled" : "disabled");
+  printf("\t-W number of threads processing subframes in parallel [Default %d]\n", args.nof_worker_threads);
+  printf("\t-j number of threads searching the DCI of one subframe [Default %d]\n", args.nof_search_threads);
+  printf("\t-q depth of the subframe reorder buffer in front of the DCI output [Default %d]\n", args.reorder_buffer_depth);
+  printf("\t-K number of subframe buffers between RF receiver and workers [Default %d]\n", args.nof_subframe_buffers);
+  printf("\t-k real-time priority of the RF receiver thread (0: highest, -1: no real-time) [Default %d]\n", args.rf_thread_prio);
+  printf("\t-L load shedding policy in live mode if workers fall behind (none|adaptive) [Default %s]\n", args.load_shedding_policy.c_str());
+  printf("\t-e RNTI activity estimator (histogram|decay|sketch; sketch uses the least memory) [Default %s]\n", args.rnti_activity_estimator.c_str());
+  printf("\t-N min. frequency of unknown RNTIs within the activity window to accept them [Default %d]\n", args.rnti_threshold);
+  printf("\t-z RNTI snapshot file, restored at startup and written every %d ms and on exit [default none]\n", DEFAULT_RNTI_SNAPSHOT_INTERVAL_MS);
   printf("\t-v [set srslte_verbose to debug, default none]\n");
   //printf("\t-z filename of the output reporting one int per rnti (tot length 64k entries)\n");
   //printf("\t-Z filename of the input reporting one int per rnti (tot length 64k entries)\n");
@@ -117,7 +159,7 @@ void ArgManager::usage(Args& args, const std::string& prog) {
 void ArgManager::parseArgs(Args& args, int argc, char **argv) {
   int opt;
   defaultArgs(args);
-  while ((opt = getopt(argc, argv, "aAcCDEfgHilnpPrRsStTvwyY")) != -1) {
+  while ((opt = getopt(argc, argv, "aAbcCdDeEfFgGHijkKlLmMnNpPqQrRsStTuUvwWxXyYz")) != -1) {
     switch (opt) {
       case 'a':
         args.rf_args = argv[optind];
@@ -137,9 +179,66 @@ void ArgManager::parseArgs(Args& args, int argc, char **argv) {
       case 'w':
         args.file_wrap = true;
         break;
+      case 'F':
+        args.dci_format_set = argv[optind];
+        break;
+      case 'd':
+        args.max_recursion_depth = static_cast<uint32_t>(strtoul(argv[optind], nullptr, 0));
+        break;
+      case 'm':
+        args.dci_disambiguation_depth = static_cast<uint32_t>(strtoul(argv[optind], nullptr, 0));
+        break;
+      case 'x':
+        args.viterbi_min_reliability = strtof(argv[optind], nullptr);
+        break;
+      case 'X':
+        args.list_viterbi_size = static_cast<uint32_t>(strtoul(argv[optind], nullptr, 0));
+        break;
+      case 'G':
+        args.occupancy_threshold = strtof(argv[optind], nullptr);
+        break;
+      case 'M':
+        args.occupancy_model_file_name = argv[optind];
+        break;
+      case 'Q':
+        args.occupancy_trace_file_name = argv[optind];
+        break;
+      case 'u':
+        args.enable_targeted_search = true;
+        break;
+      case 'U':
+        args.enable_harq_hints = true;
+        break;
+      case 'W':
+        args.nof_worker_threads = static_cast<uint32_t>(strtoul(argv[optind], nullptr, 0));
+        break;
+      case 'j':
+        args.nof_search_threads = static_cast<uint32_t>(strtoul(argv[optind], nullptr, 0));
+        break;
+      case 'K':
+        args.nof_subframe_buffers = static_cast<uint32_t>(strtoul(argv[optind], nullptr, 0));
+        break;
+      case 'k':
+        args.rf_thread_prio = static_cast<int>(strtol(argv[optind], nullptr, 0));
+        break;
+      case 'L':
+        args.load_shedding_policy = argv[optind];
+        break;
+      case 'e':
+        args.rnti_activity_estimator = argv[optind];
+        break;
+      case 'N':
+        args.rnti_threshold = static_cast<uint32_t>(strtoul(argv[optind], nullptr, 0));
+        break;
+      case 'z':
+        args.rnti_snapshot_file_name = argv[optind];
+        break;
       case 'D':
         args.dci_file_name = argv[optind];
         break;
+      case 'b':
+        args.dci_trace_file_name = argv[optind];
+        break;
       case 'E':
         args.stats_file_name = argv[optind];
         break;
@@ -176,6 +275,9 @@ void ArgManager::parseArgs(Args& args, int argc, char **argv) {
       case 'T':
         args.dci_format_split_update_interval_ms = static_cast<uint32_t>(strtoul(argv[optind], nullptr, 0));
         break;
+      case 'q':
+        args.reorder_buffer_depth = static_cast<uint32_t>(strtoul(argv[optind], nullptr, 0));
+        break;
       case 'r':
         args.enable_ASCII_PRB_plot = false;
         break;
@@ -35,6 +35,7 @@ struct Args {
   int force_N_id_2;
   std::string input_file_name = "";
   std::string dci_file_name = "";
+  std::string dci_trace_file_name = "";
   std::string stats_file_name = "";
   int file_offset_time;
   double file_offset_freq;
@@ -53,6 +54,25 @@ struct Args {
   double dci_format_split_ratio;
   bool skip_secondary_meta_formats;
   bool enable_shortcut_discovery;
+  uint32_t nof_worker_threads;
+  uint32_t nof_search_threads;
+  uint32_t reorder_buffer_depth;
+  uint32_t nof_subframe_buffers;
+  int rf_thread_prio;
+  std::string load_shedding_policy;
+  std::string rnti_activity_estimator;
+  uint32_t rnti_threshold;
+  std::string rnti_snapshot_file_name;
+  std::string dci_format_set;
+  uint32_t max_recursion_depth;
+  uint32_t dci_disambiguation_depth;
+  float viterbi_min_reliability;
+  uint32_t list_viterbi_size;
+  float occupancy_threshold;
+  std::string occupancy_model_file_name;
+  std::string occupancy_trace_file_name;
+  bool enable_targeted_search;
+  bool enable_harq_hints;
 };
 
 class ArgManager {
@@ -23,6 +23,7 @@
 #include <fstream>
 #include <signal.h>
 #include <unistd.h>
+#include <chrono>
 
 #include "EyeCore.h"
 #include "falcon/common/SubframeBuffer.h"
@@ -30,6 +31,7 @@
 #include "falcon/phy/falcon_rf/rf_imp.h"
 
 #include "falcon/prof/Lifetime.h"
+#include "falcon/common/Settings.h"
 
 #include "srslte/srslte.h"
 // include C-only headers
@@ -66,22 +68,138 @@ bool isEqual(double a, double b, double epsilon) {
     return (diff < epsilon) && (diff > -epsilon);
 }
 
+RFReceiverStats::RFReceiverStats() :
+  nof_received(0),
+  nof_overflows(0),
+  nof_late(0),
+  max_occupancy(0)
+{
+
+}
+
+EyeCore::ReceiverThread::ReceiverThread(std::function<void()> loop) :
+  loop(loop)
+{
+
+}
+
+EyeCore::ReceiverThread::~ReceiverThread() {
+
+}
+
+void EyeCore::ReceiverThread::run_thread() {
+  loop();
+}
+
+EyeCore::SnapshotThread::SnapshotThread(EyeCore& core) :
+  core(core),
+  stopped(false),
+  restorePending(false),
+  restoreTag(0)
+{
+
+}
+
+EyeCore::SnapshotThread::~SnapshotThread() {
+
+}
+
+void EyeCore::SnapshotThread::stop() {
+  std::lock_guard<std::mutex> lock(m);
+  stopped = true;
+  c.notify_all();
+}
+
+void EyeCore::SnapshotThread::restore(uint32_t tag) {
+  std::lock_guard<std::mutex> lock(m);
+  restorePending = true;
+  restoreTag = tag;
+  c.notify_all();
+}
+
+void EyeCore::SnapshotThread::run_thread() {
+  std::unique_lock<std::mutex> lock(m);
+  while(!stopped) {
+    if(!restorePending) {
+      c.wait_for(lock, std::chrono::milliseconds(DEFAULT_RNTI_SNAPSHOT_INTERVAL_MS));
+    }
+    if(stopped) {
+      break;
+    }
+    if(restorePending) {
+      restorePending = false;
+      uint32_t tag = restoreTag;
+      lock.unlock();
+      core.restoreRNTISnapshot(tag);
+      lock.lock();
+    }
+    else {
+      lock.unlock();
+      core.saveRNTISnapshot();
+      lock.lock();
+    }
+  }
+}
+
 EyeCore::EyeCore(const Args& args) :
   go_exit(false),
   args(args),
-  state(DECODE_MIB)
+  state(DECODE_MIB),
+  rxReceived(0),
+  rxOverflows(0),
+  rxLate(0),
+  rxMaxOccupancy(0),
+  snapshotEnabled(false),
+  snapshotTag(0)
 {
+  const DCIFormatSet* formatSet = DCIFormatSet::get(args.dci_format_set);
+  if(formatSet == nullptr) {
+    formatSet = &DCIFormatSet::getDefault();
+    cout << "Unknown DCI format set '" << args.dci_format_set << "', using '" << formatSet->getName() << "'" << endl;
+  }
   phy = new Phy(args.rf_nof_rx_ant,
-                DEFAULT_NOF_WORKERS,
+                args.nof_subframe_buffers,
+                args.nof_worker_threads,
+                args.nof_search_threads,
                 args.dci_file_name,
                 args.stats_file_name,
                 args.skip_secondary_meta_formats,
-                args.dci_format_split_ratio);
+                args.dci_format_split_ratio,
+                *formatSet);
   phy->getCommon().setShortcutDiscovery(args.enable_shortcut_discovery);
+  phy->getCommon().setReorderBufferDepth(args.reorder_buffer_depth);
+  phy->getCommon().setSearchDepth(args.max_recursion_depth, args.dci_disambiguation_depth);
+  phy->getCommon().setListViterbi(args.list_viterbi_size, args.viterbi_min_reliability);
+  if(args.occupancy_model_file_name != "" && !phy->getCommon().loadOccupancyModel(args.occupancy_model_file_name)) {
+    cout << "Could not load occupancy model '" << args.occupancy_model_file_name << "', using built-in model" << endl;
+  }
+  phy->getCommon().setOccupancyThreshold(args.occupancy_threshold);
+  if(args.occupancy_trace_file_name != "" && !phy->getCommon().openOccupancyTrace(args.occupancy_trace_file_name)) {
+    cout << "Could not open occupancy trace '" << args.occupancy_trace_file_name << "'" << endl;
+  }
+  phy->getCommon().setTargetedSearch(args.enable_targeted_search);
+  phy->getCommon().setHarqHints(args.enable_harq_hints);
+  if(!phy->getCommon().getRNTIManager().setActivityEstimator(args.rnti_activity_estimator)) {
+    cout << "Unknown RNTI activity estimator '" << args.rnti_activity_estimator << "', using '"
+         << phy->getCommon().getRNTIManager().getActivityEstimatorName() << "'" << endl;
+  }
+  phy->getCommon().getRNTIManager().setThreshold(args.rnti_threshold);
+  // in file mode the receiver simply waits for the workers, so there is no load to shed
+  if(args.input_file_name == "") {
+    std::unique_ptr<LoadSheddingPolicy> policy(LoadSheddingPolicy::create(args.load_shedding_policy));
+    if(!policy) {
+      cout << "Unknown load shedding policy '" << args.load_shedding_policy << "', using 'none'" << endl;
+      policy = LoadSheddingPolicy::create("none");
+    }
+    phy->setLoadSheddingPolicy(std::move(policy));
+  }
   std::shared_ptr<DCIConsumerList> cons(new DCIConsumerList());
   if(args.dci_file_name != "") {
     cons->addConsumer(static_pointer_cast<SubframeInfoConsumer>(std::shared_ptr<DCIToFile>(new DCIToFile(phy->getCommon().getDCIFile()))));
   }
+  if(args.dci_trace_file_name != "") {
+    cons->addConsumer(static_pointer_cast<SubframeInfoConsumer>(std::shared_ptr<DCIToBinaryFile>(new DCIToBinaryFile(args.dci_trace_file_name))));
+  }
   if(args.enable_ASCII_PRB_plot) {
     cons->addConsumer(static_pointer_cast<SubframeInfoConsumer>(std::shared_ptr<DCIDrawASCII>(new DCIDrawASCII())));
   }
@@ -121,7 +239,6 @@ bool EyeCore::run() {
   //std::unique_ptr<SubframeBuffer> sfb = bufferPool.getAvail();
   //SubframeBuffer sfb(args.rf_nof_rx_ant);
   uint32_t sfn = 0; // system frame number
-  uint32_t skip_cnt = 0;
 
   if(args.cpu_affinity > -1) {
     cpu_set_t cpuset;
@@ -270,7 +387,7 @@ bool EyeCore::run() {
 #endif
   }
 
-  std::shared_ptr<SubframeWorker> worker(phy->getAvail());
+  SubframeWorker* worker(phy->getAvail());
 
   if (srslte_ue_mib_init(&ue_mib, worker->getBuffers(), cell.nof_prb)) {
     cout << "Error initaiting UE MIB decoder" << endl;
@@ -366,142 +483,194 @@ bool EyeCore::run() {
 
   srslte_pbch_decode_reset(&ue_mib.pbch);
 
+  SnapshotThread snapshots(*this);
+  if(args.rnti_snapshot_file_name != "") {
+    snapshots.start();
+  }
+
   //PrintLifetime lt("###>> Search took: ");
   cout << "Entering main loop..." << endl;
-  /* Main loop */
-  while (!go_exit && (sf_cnt < args.nof_subframes || args.nof_subframes == 0)) {
+  /* Main loop, runs on a dedicated (real-time) thread that only acquires and hands over subframes */
+  ReceiverThread receiver([&]() {
+    const bool live = args.input_file_name == "";
+    std::chrono::steady_clock::time_point t_handoff = std::chrono::steady_clock::now();
+    while (!go_exit && (sf_cnt < args.nof_subframes || args.nof_subframes == 0)) {
 
 //    if(sf_cnt % (args.dci_format_split_update_interval_ms) == 0) {
 //      phy->getMetaFormats().update_formats();
 //      //falcon_ue_dl_update_formats(&falcon_ue_dl, args.dci_format_split_ratio);
 //    }
 
-    ret = srslte_ue_sync_zerocopy_multi(&ue_sync, worker->getBuffers());
-    if (ret < 0) {
-      if(ue_sync.file_mode) {
-        cout << "Finished reading samples from file (srslte_ue_sync_work())" << endl;
+      // time spent between two receive calls; longer than a subframe means the RF buffer is filling up
+      std::chrono::steady_clock::time_point t_receive = std::chrono::steady_clock::now();
+      if(live && sf_cnt > 0 && t_receive - t_handoff > std::chrono::microseconds(1000)) {
+        rxLate.fetch_add(1, std::memory_order_relaxed);
       }
-      else {
-        cout << "Error calling srslte_ue_sync_work()" << endl;
+      ret = srslte_ue_sync_zerocopy_multi(&ue_sync, worker->getBuffers());
+      t_handoff = std::chrono::steady_clock::now();
+      if (ret < 0) {
+        if(ue_sync.file_mode) {
+          cout << "Finished reading samples from file (srslte_ue_sync_work())" << endl;
+        }
+        else {
+          cout << "Error calling srslte_ue_sync_work()" << endl;
+        }
+        go_exit = true;
+        break;
       }
-      go_exit = true;
-      break;
-    }
 
 #ifdef CORRECT_SAMPLE_OFFSET
-    float sample_offset = (float) srslte_ue_sync_get_last_sample_offset(&ue_sync)+srslte_ue_sync_get_sfo(&ue_sync)/1000;
-    srslte_ue_dl_set_sample_offset(&ue_dl, sample_offset);
+      float sample_offset = (float) srslte_ue_sync_get_last_sample_offset(&ue_sync)+srslte_ue_sync_get_sfo(&ue_sync)/1000;
+      srslte_ue_dl_set_sample_offset(&ue_dl, sample_offset);
 #endif
 
-    /* srslte_ue_sync_zerocopy_multi returns 1 if successfully read 1 aligned subframe */
-    if (ret == 1) {
-      switch (state) {
-        case DECODE_MIB:
-          if (srslte_ue_sync_get_sfidx(&ue_sync) == 0) {
-            n = srslte_ue_mib_decode(&ue_mib, bch_payload, nullptr, &sfn_offset);
-            if (n < 0) {
-              cout << "Error decoding UE MIB" << endl;
-              go_exit = true;
-            } else if (n == SRSLTE_UE_MIB_FOUND) {
-              srslte_pbch_mib_unpack(bch_payload, &cell, &sfn);
-              //srslte_cell_fprint(stdout, &cell, sfn);
-              cout << "Decoded MIB. SFN: " << sfn <<
-                      ", offset " << sfn_offset << endl;
-              sfn = (sfn + static_cast<uint32_t>(sfn_offset)) % 1024;
-              state = DECODE_PDSCH;
-              RNTIManager& rntiManager = phy->getCommon().getRNTIManager();
+      /* srslte_ue_sync_zerocopy_multi returns 1 if successfully read 1 aligned subframe */
+      if (ret == 1) {
+        {
+          rxReceived.fetch_add(1, std::memory_order_relaxed);
+        }
+        switch (state) {
+          case DECODE_MIB:
+            if (srslte_ue_sync_get_sfidx(&ue_sync) == 0) {
+              n = srslte_ue_mib_decode(&ue_mib, bch_payload, nullptr, &sfn_offset);
+              if (n < 0) {
+                cout << "Error decoding UE MIB" << endl;
+                go_exit = true;
+              } else if (n == SRSLTE_UE_MIB_FOUND) {
+                srslte_pbch_mib_unpack(bch_payload, &cell, &sfn);
+                //srslte_cell_fprint(stdout, &cell, sfn);
+                cout << "Decoded MIB. SFN: " << sfn <<
+                        ", offset " << sfn_offset << endl;
+                sfn = (sfn + static_cast<uint32_t>(sfn_offset)) % 1024;
+                state = DECODE_PDSCH;
+                RNTIManager& rntiManager = phy->getCommon().getRNTIManager();
+                const DCIFormatSet& formatSet = phy->getMetaFormats().getFormatSet();
 //              if(falcon_ue_dl.rnti_manager != nullptr) {
 //                rnti_manager_free(falcon_ue_dl.rnti_manager);
 //                falcon_ue_dl.rnti_manager = nullptr;
 //              }
 //              falcon_ue_dl.rnti_manager = rnti_manager_create(nof_falcon_ue_all_formats, RNTI_PER_SUBFRAME);
 
-              // setup rnti manager
-              int idx;
-              // add format1A evergreens
-              idx = falcon_dci_index_of_format_in_list(SRSLTE_DCI_FORMAT1A, falcon_ue_all_formats, nof_falcon_ue_all_formats);
-              if(idx > -1) {
-                rntiManager.addEvergreen(SRSLTE_RARNTI_START, SRSLTE_RARNTI_END, static_cast<uint32_t>(idx));
-                rntiManager.addEvergreen(SRSLTE_PRNTI, SRSLTE_SIRNTI, static_cast<uint32_t>(idx));
-                //rnti_manager_add_evergreen(falcon_ue_dl.rnti_manager, SRSLTE_RARNTI_START, SRSLTE_RARNTI_END, static_cast<uint32_t>(idx));
-                //rnti_manager_add_evergreen(falcon_ue_dl.rnti_manager, SRSLTE_PRNTI, SRSLTE_SIRNTI, static_cast<uint32_t>(idx));
-              }
-              // add format1C evergreens
-              idx = falcon_dci_index_of_format_in_list(SRSLTE_DCI_FORMAT1C, falcon_ue_all_formats, nof_falcon_ue_all_formats);
-              if(idx > -1) {
-                rntiManager.addEvergreen(SRSLTE_RARNTI_START, SRSLTE_RARNTI_END, static_cast<uint32_t>(idx));
-                rntiManager.addEvergreen(SRSLTE_PRNTI, SRSLTE_SIRNTI, static_cast<uint32_t>(idx));
-                //rnti_manager_add_evergreen(falcon_ue_dl.rnti_manager, SRSLTE_RARNTI_START, SRSLTE_RARNTI_END, static_cast<uint32_t>(idx));
-                //rnti_manager_add_evergreen(falcon_ue_dl.rnti_manager, SRSLTE_PRNTI, SRSLTE_SIRNTI, static_cast<uint32_t>(idx));
-              }
-              // add forbidden rnti values to rnti manager
-              for(uint32_t f=0; f<nof_falcon_ue_all_formats; f++) {
-                  //disallow RNTI=0 for all formats
-                rntiManager.addForbidden(0x0, 0x0, f);
-                //rnti_manager_add_forbidden(falcon_ue_dl.rnti_manager, 0x0, 0x0, f);
-              }
+                // setup rnti manager
+                int idx;
+                // add format1A evergreens
+                idx = formatSet.indexOf(SRSLTE_DCI_FORMAT1A);
+                if(idx > -1) {
+                  rntiManager.addEvergreen(SRSLTE_RARNTI_START, SRSLTE_RARNTI_END, static_cast<uint32_t>(idx));
+                  rntiManager.addEvergreen(SRSLTE_PRNTI, SRSLTE_SIRNTI, static_cast<uint32_t>(idx));
+                  //rnti_manager_add_evergreen(falcon_ue_dl.rnti_manager, SRSLTE_RARNTI_START, SRSLTE_RARNTI_END, static_cast<uint32_t>(idx));
+                  //rnti_manager_add_evergreen(falcon_ue_dl.rnti_manager, SRSLTE_PRNTI, SRSLTE_SIRNTI, static_cast<uint32_t>(idx));
+                }
+                // add format1C evergreens
+                idx = formatSet.indexOf(SRSLTE_DCI_FORMAT1C);
+                if(idx > -1) {
+                  rntiManager.addEvergreen(SRSLTE_RARNTI_START, SRSLTE_RARNTI_END, static_cast<uint32_t>(idx));
+                  rntiManager.addEvergreen(SRSLTE_PRNTI, SRSLTE_SIRNTI, static_cast<uint32_t>(idx));
+                  //rnti_manager_add_evergreen(falcon_ue_dl.rnti_manager, SRSLTE_RARNTI_START, SRSLTE_RARNTI_END, static_cast<uint32_t>(idx));
+                  //rnti_manager_add_evergreen(falcon_ue_dl.rnti_manager, SRSLTE_PRNTI, SRSLTE_SIRNTI, static_cast<uint32_t>(idx));
+                }
+                // add forbidden rnti values to rnti manager
+                for(uint32_t f=0; f<formatSet.getNofFormats(); f++) {
+                    //disallow RNTI=0 for all formats
+                  rntiManager.addForbidden(0x0, 0x0, f);
+                  //rnti_manager_add_forbidden(falcon_ue_dl.rnti_manager, 0x0, 0x0, f);
+                }
+                // file I/O stays off the receiver thread
+                if(args.rnti_snapshot_file_name != "") {
+                  snapshots.restore(snapshotCellTag(cell));
+                }
 
+              }
             }
-          }
-          break;
-        case DECODE_PDSCH:
-            worker->prepare(srslte_ue_sync_get_sfidx(&ue_sync),
-                            sfn,
-                            sf_cnt % (args.dci_format_split_update_interval_ms) == 0);
+            break;
+          case DECODE_PDSCH:
+              worker->prepare(srslte_ue_sync_get_sfidx(&ue_sync),
+                              sfn,
+                              sf_cnt % (args.dci_format_split_update_interval_ms) == 0);
 //#define SINGLE_THREAD
 #ifdef SINGLE_THREAD
-            worker->work();
+              static DCISearchPool searchPool(args.nof_search_threads);
+              worker->work(searchPool);
 #else
-            std::shared_ptr<SubframeWorker> tmp;
-            if(args.input_file_name == "") {
-              tmp = phy->getAvailImmediate();  // non-blocking if reading from radio
-            }
-            else {
-              tmp = phy->getAvail();  // blocking if reading from file
-            }
-            if(tmp != nullptr) {
-              phy->putPending(std::move(worker));
-              worker = std::move(tmp);
-            }
-            else {
-              cout << "No worker available. Skipping subframe " << worker->getSfn() << "." << worker->getSfidx() << endl;
-              skip_cnt++;
-            }
+              SubframeWorker* tmp;
+              if(args.input_file_name == "") {
+                tmp = phy->getAvailImmediate();  // non-blocking if reading from radio
+              }
+              else {
+                tmp = phy->getAvail();  // blocking if reading from file
+              }
+              if(tmp != nullptr) {
+                phy->putPending(worker);
+                worker = tmp;
+                // buffers in use: pending, in progress and the one being filled
+                uint32_t occupancy = phy->nof_workers - phy->getNofAvail();
+                // the receiver thread is the only writer
+                if(occupancy > rxMaxOccupancy.load(std::memory_order_relaxed)) {
+                  rxMaxOccupancy.store(occupancy, std::memory_order_relaxed);
+                }
+              }
+              else {
+                // ring overflow; the buffer is reused for the next subframe
+                INFO("No worker available. Skipping subframe %d.%d\n", worker->getSfn(), worker->getSfidx());
+                phy->skipSubframe(worker->getSfn(), worker->getSfidx());
+                rxOverflows.fetch_add(1, std::memory_order_relaxed);
+              }
 #endif
-          break;
-      }
+            break;
+        }
 
-      if (srslte_ue_sync_get_sfidx(&ue_sync) == 9) {
-        sfn++;
-      }
+        if (srslte_ue_sync_get_sfidx(&ue_sync) == 9) {
+          sfn++;
+        }
 
-      if (sfn % 10 == 0 && srslte_ue_sync_get_sfidx(&ue_sync) == 9) {
-        if(SRSLTE_VERBOSE_ISINFO()) {
-          phy->getCommon().getRNTIManager().printActiveSet();
-          //rnti_manager_print_active_set(falcon_ue_dl.rnti_manager);
+        if (sfn % 10 == 0 && srslte_ue_sync_get_sfidx(&ue_sync) == 9) {
+          if(SRSLTE_VERBOSE_ISINFO()) {
+            phy->getCommon().getRNTIManager().printActiveSet();
+            //rnti_manager_print_active_set(falcon_ue_dl.rnti_manager);
+          }
         }
       }
-    }
-    else if (ret == 0) {
-      cout << "Finding PSS... Peak: " << srslte_sync_get_peak_value(&ue_sync.sfind) <<
-              ", FrameCnt: " << ue_sync.frame_total_cnt <<
-              " State: " << ue_sync.state << endl;
-    }
-    // Some delay when playing
+      else if (ret == 0) {
+        cout << "Finding PSS... Peak: " << srslte_sync_get_peak_value(&ue_sync.sfind) <<
+                ", FrameCnt: " << ue_sync.frame_total_cnt <<
+                " State: " << ue_sync.state << endl;
+      }
+      // Some delay when playing
 //    if (args.input_file_name != "" && !args.disable_plots) {
 //      usleep(1000);
 //    }
-    sf_cnt++;
-  } // Main loop
+      sf_cnt++;
+    } // Main loop
+  });
+  if(!receiver.start(args.rf_thread_prio)) {
+    cout << "Could not start RF receiver thread with priority " << args.rf_thread_prio << ", using normal priority" << endl;
+    receiver.start(-1);
+  }
+  receiver.wait_thread_finish();
 
   phy->joinPending();
 
+  if(args.rnti_snapshot_file_name != "") {
+    snapshots.stop();
+    snapshots.wait_thread_finish();
+    saveRNTISnapshot();
+  }
+
 
   phy->getCommon().getRNTIManager().printActiveSet();
   //rnti_manager_print_active_set(falcon_ue_dl.rnti_manager);
 
   phy->getCommon().printStats();
-  cout << "Skipped subframes: " << skip_cnt << " (" << static_cast<double>(skip_cnt) * 100 / (phy->getCommon().getStats().nof_subframes + skip_cnt) << "%)" <<  endl;
+  RFReceiverStats rxStats = getReceiverStats();
+  cout << "Skipped subframes: " << rxStats.nof_overflows << " (" << static_cast<double>(rxStats.nof_overflows) * 100 / (phy->getCommon().getStats().nof_subframes + rxStats.nof_overflows) << "%)" <<  endl;
+  cout << "RF receiver: " << rxStats.nof_received << " received, " <<
+          rxStats.nof_overflows << " overflows, " <<
+          rxStats.nof_late << " late, " <<
+          "max. " << rxStats.max_occupancy << "/" << phy->nof_workers << " subframe buffers in use" << endl;
+  SubframeInfoDispatcherStats dispatcherStats = phy->getCommon().getDispatcherStats();
+  cout << "Reorder buffer: " << dispatcherStats.nof_dispatched << " dispatched, " <<
+          dispatcherStats.nof_late << " late, " <<
+          dispatcherStats.nof_dropped << " dropped" << endl;
   //srslte_ue_dl_stats_print(&falcon_ue_dl, falcon_ue_dl.stats_file);
 
 #if 0
@@ -530,6 +699,42 @@ void EyeCore::stop() {
   go_exit = true;
 }
 
+RFReceiverStats EyeCore::getReceiverStats() const {
+  RFReceiverStats result;
+  result.nof_received = rxReceived.load(std::memory_order_relaxed);
+  result.nof_overflows = rxOverflows.load(std::memory_order_relaxed);
+  result.nof_late = rxLate.load(std::memory_order_relaxed);
+  result.max_occupancy = rxMaxOccupancy.load(std::memory_order_relaxed);
+  return result;
+}
+
+uint32_t EyeCore::snapshotCellTag(const srslte_cell_t& cell) const {
+  // PCI (9 bit), nof_prb (7 bit) and the carrier frequency in 100 kHz (16 bit, up to 6.5 GHz)
+  uint32_t freq = static_cast<uint32_t>(args.rf_freq / 100e3 + 0.5) & 0xffff;
+  return (freq << 16) | ((cell.nof_prb & 0x7f) << 9) | (cell.id & 0x1ff);
+}
+
+void EyeCore::restoreRNTISnapshot(uint32_t tag) {
+  if(args.rnti_snapshot_file_name == "") {
+    return;
+  }
+  snapshotTag = tag;
+  snapshotEnabled = true;
+  RNTIManager& rntiManager = phy->getCommon().getRNTIManager();
+  if(rntiManager.loadSnapshot(args.rnti_snapshot_file_name, tag)) {
+    cout << "Restored RNTI snapshot " << args.rnti_snapshot_file_name << ": " << rntiManager.getNofActive() << " active RNTIs" << endl;
+  }
+}
+
+void EyeCore::saveRNTISnapshot() {
+  if(args.rnti_snapshot_file_name == "" || !snapshotEnabled) {
+    return;
+  }
+  if(!phy->getCommon().getRNTIManager().saveSnapshot(args.rnti_snapshot_file_name, snapshotTag)) {
+    cout << "Could not write RNTI snapshot " << args.rnti_snapshot_file_name << endl;
+  }
+}
+
 RNTIManager &EyeCore::getRNTIManager(){
   return phy->getCommon().getRNTIManager();
 }
@@ -26,6 +26,13 @@
 #include "falcon/util/RNTIManager.h"
 #include "phy/Phy.h"
 
+#include "srslte/common/threads.h"
+
+#include <functional>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+
 //#include "srslte/srslte.h"
 
 // include C-only headers
@@ -50,6 +57,16 @@
 //#define CORRECT_SAMPLE_OFFSET
 
 
+class RFReceiverStats {
+public:
+  RFReceiverStats();
+
+  uint64_t nof_received;    // aligned subframes read from the radio/file
+  uint64_t nof_overflows;   // no free subframe buffer, subframe skipped
+  uint64_t nof_late;        // receiver returned to the radio later than one subframe period
+  uint32_t max_occupancy;   // max. number of subframe buffers in use
+};
+
 class EyeCore : public SignalHandler {
 public:
   EyeCore(const Args& args);
@@ -61,12 +78,49 @@ public:
   bool run();
   void stop();
   RNTIManager &getRNTIManager();
+  RFReceiverStats getReceiverStats() const;
 
   //upper layer interfaces
   void setDCIConsumer(std::shared_ptr<SubframeInfoConsumer> consumer);
   void resetDCIConsumer();
 
 private:
+  // runs the sample acquisition loop of run()
+  class ReceiverThread : public thread {
+  public:
+    ReceiverThread(std::function<void()> loop);
+    virtual ~ReceiverThread() override;
+  protected:
+    virtual void run_thread() override;
+  private:
+    std::function<void()> loop;
+  };
+
+  // writes RNTIManager snapshots periodically
+  class SnapshotThread : public thread {
+  public:
+    SnapshotThread(EyeCore& core);
+    virtual ~SnapshotThread() override;
+    void stop();
+    // restores the snapshot of the cell identified by tag on this thread
+    void restore(uint32_t tag);
+  protected:
+    virtual void run_thread() override;
+  private:
+    EyeCore& core;
+    bool stopped;
+    bool restorePending;
+    uint32_t restoreTag;
+    std::mutex m;
+    std::condition_variable c;
+  };
+
+  // identifies the cell of a snapshot by PCI, bandwidth and carrier frequency
+  uint32_t snapshotCellTag(const srslte_cell_t& cell) const;
+  // restores the RNTIManager of the cell identified by tag; enables snapshots
+  void restoreRNTISnapshot(uint32_t tag);
+  void saveRNTISnapshot();
+
   //incoming interfaces
   void handleSignal() override;
 
@@ -75,6 +129,13 @@ private:
   Args args;
   enum receiver_state { DECODE_MIB, DECODE_PDSCH} state;
   Phy* phy;
+  // receiver statistics, written by the receiver thread only
+  std::atomic<uint64_t> rxReceived;
+  std::atomic<uint64_t> rxOverflows;
+  std::atomic<uint64_t> rxLate;
+  std::atomic<uint32_t> rxMaxOccupancy;
+  std::atomic<bool> snapshotEnabled;  // cell known
+  std::atomic<uint32_t> snapshotTag;
 //  Provider<ScanLine> uplinkAllocProvider;
 //  Provider<ScanLine> downlinkAllocProvider;
 //  Provider<ScanLine> downlinkSpectrumProvider;
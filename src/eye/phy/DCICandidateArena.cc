@@ -0,0 +1,46 @@
+#include "DCICandidateArena.h"
+
+#include <string.h>
+
+DCICandidateArena::DCICandidateArena() :
+  depth(0),
+  top(0),
+  nof_heap_allocations(0)
+{
+
+}
+
+DCICandidateArena::~DCICandidateArena() {
+
+}
+
+dci_candidate_t* DCICandidateArena::alloc(uint32_t nof_candidates) {
+  if(depth < DCI_CANDIDATE_ARENA_MAX_DEPTH &&
+     top + nof_candidates <= DCI_CANDIDATE_ARENA_SIZE) {
+    dci_candidate_t* result = &candidates[top];
+    memset(result, 0, nof_candidates * sizeof(dci_candidate_t));
+    sizes[depth++] = nof_candidates;
+    top += nof_candidates;
+    return result;
+  }
+  nof_heap_allocations++;
+  return falcon_alloc_candidates(nof_candidates);
+}
+
+void DCICandidateArena::release(dci_candidate_t* candidates) {
+  if(candidates >= this->candidates &&
+     candidates < this->candidates + DCI_CANDIDATE_ARENA_SIZE) {
+    top -= sizes[--depth];
+  }
+  else {
+    falcon_free_candidates(candidates);
+  }
+}
+
+uint32_t DCICandidateArena::getNofHeapAllocations() const {
+  return nof_heap_allocations;
+}
+
+void DCICandidateArena::resetNofHeapAllocations() {
+  nof_heap_allocations = 0;
+}
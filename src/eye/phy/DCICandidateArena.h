@@ -0,0 +1,32 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "falcon/phy/falcon_ue/falcon_ue_dl.h"
+#include "MetaFormats.h"
+
+// The recursive DCI search holds one set of candidates per aggregation level
+#define DCI_CANDIDATE_ARENA_MAX_DEPTH 4
+#define DCI_CANDIDATE_ARENA_SIZE (DCI_CANDIDATE_ARENA_MAX_DEPTH * MAX_NOF_META_FORMATS)
+
+// Preallocated stack of DCI candidates for the recursive blind search.
+// Candidates must be released in reverse order of allocation.
+// Falls back to the heap if the arena is exhausted; such allocations are counted.
+class DCICandidateArena {
+public:
+  DCICandidateArena();
+  ~DCICandidateArena();
+
+  // returns nof_candidates zero-initialized candidates
+  dci_candidate_t* alloc(uint32_t nof_candidates);
+  void release(dci_candidate_t* candidates);
+
+  uint32_t getNofHeapAllocations() const;
+  void resetNofHeapAllocations();
+private:
+  dci_candidate_t candidates[DCI_CANDIDATE_ARENA_SIZE];
+  uint32_t sizes[DCI_CANDIDATE_ARENA_MAX_DEPTH];
+  uint32_t depth;
+  uint32_t top;
+  uint32_t nof_heap_allocations;
+};
@@ -2,29 +2,36 @@
 #include "DCIPrint.h"
 #include "falcon/phy/falcon_phch/falcon_dci.h"
 
+#include <string.h>
+
 DCI_BASE::DCI_BASE() :
   rnti(FALCON_UNSET_RNTI),
   format(SRSLTE_DCI_NOF_FORMATS),
   nof_bits(0),
-  hex(),
   location({0, 0}),
   histval(0)
 {
 
 }
 
+void DCI_BASE::sprintHex(char* str, uint32_t max_len) const {
+  sprint_hex(str, max_len, const_cast<uint8_t*>(data), nof_bits);
+}
+
+std::string DCI_BASE::getHex() const {
+  char hex_str[DCI_HEX_MAX_LEN];
+  sprintHex(hex_str, sizeof(hex_str));
+  return std::string(hex_str);
+}
+
 DCI_DL::DCI_DL() :
-  DCI_BASE(),
-  dl_dci_unpacked(new srslte_ra_dl_dci_t),
-  dl_grant(new srslte_ra_dl_grant_t)
+  DCI_BASE()
 {
 
 }
 
 DCI_UL::DCI_UL() :
-  DCI_BASE(),
-  ul_dci_unpacked(new srslte_ra_ul_dci_t),
-  ul_grant(new srslte_ra_ul_grant_t)
+  DCI_BASE()
 {
 
 }
@@ -50,6 +57,21 @@ DCICollection::~DCICollection() {
 
 }
 
+void DCICollection::reset(const srslte_cell_t& cell) {
+  this->cell = cell;
+  sfn = 0;
+  sf_idx = 0;
+  cfi = 0;
+  timestamp = {};
+  // clear() keeps the capacity of the previous subframes
+  dci_dl_collection.clear();
+  dci_ul_collection.clear();
+  rb_map_dl.assign(cell.nof_prb, FALCON_UNSET_RNTI);
+  rb_map_ul.assign(cell.nof_prb, FALCON_UNSET_RNTI);
+  dl_collision = false;
+  ul_collision = false;
+}
+
 void DCICollection::setTimestamp(timeval timestamp) {
   this->timestamp = timestamp;
 }
@@ -103,31 +125,42 @@ bool DCICollection::hasCollisionUL() const {
 void DCICollection::addCandidate(dci_candidate_t& cand,
                                  const srslte_dci_location_t& location,
                                  uint32_t histval) {
-  DCI_DL* dci_dl = new DCI_DL();
-  DCI_UL* dci_ul = new DCI_UL();
-
-  char hex_str[SRSLTE_DCI_MAX_BITS/4 + 1];
-  sprint_hex(hex_str, sizeof(hex_str), cand.dci_msg.data, cand.dci_msg.nof_bits);
-
-#if 0 // Verify pack/unpack hex strings
-  uint8_t dci_bits[SRSLTE_DCI_MAX_BITS];
-  sscan_hex(hex_str, dci_bits, msg->nof_bits);
-  for(int kk = 0; kk<msg->nof_bits; kk++) {
-    if(dci_bits[kk] != msg->data[kk]) {
-      ERROR("Mismatch in re-unpacked hex strings");
-    }
+  // the record of the other direction is unpacked into scratch space on the stack
+  srslte_ra_dl_dci_t dl_dci_scratch;
+  srslte_ra_dl_grant_t dl_grant_scratch;
+  srslte_ra_ul_dci_t ul_dci_scratch;
+  srslte_ra_ul_grant_t ul_grant_scratch;
+  DCI_DL* dci_dl = nullptr;
+  DCI_UL* dci_ul = nullptr;
+  DCI_BASE* dci = nullptr;
+
+  if (cand.dci_msg.format != SRSLTE_DCI_FORMAT0) {
+    dci_dl_collection.emplace_back();
+    dci_dl = &dci_dl_collection.back();
+    dci = dci_dl;
+  }
+  else {
+    dci_ul_collection.emplace_back();
+    dci_ul = &dci_ul_collection.back();
+    dci = dci_ul;
   }
-#endif
+
+  dci->rnti = cand.rnti;
+  dci->format = cand.dci_msg.format;
+  dci->nof_bits = cand.dci_msg.nof_bits;
+  memcpy(dci->data, cand.dci_msg.data, cand.dci_msg.nof_bits * sizeof(uint8_t));
+  dci->location = location;
+  dci->histval = histval;
 
   //this function needs to be replaced by a more elegant code to unpack dci
   srslte_dci_msg_to_trace_timestamp(&cand.dci_msg,
                                     cand.rnti,
                                     cell.nof_prb,
                                     cell.nof_ports,
-                                    dci_dl->dl_dci_unpacked.get(),
-                                    dci_ul->ul_dci_unpacked.get(),
-                                    dci_dl->dl_grant.get(),
-                                    dci_ul->ul_grant.get(),
+                                    dci_dl != nullptr ? &dci_dl->dl_dci_unpacked : &dl_dci_scratch,
+                                    dci_ul != nullptr ? &dci_ul->ul_dci_unpacked : &ul_dci_scratch,
+                                    dci_dl != nullptr ? &dci_dl->dl_grant : &dl_grant_scratch,
+                                    dci_ul != nullptr ? &dci_ul->ul_grant : &ul_grant_scratch,
                                     sf_idx,
                                     sfn,
                                     histval,
@@ -143,17 +176,10 @@ void DCICollection::addCandidate(dci_candidate_t& cand,
   INFO("Collecting DCI for %d, %s, cce %d, L%d\n", cand.rnti, srslte_dci_format_string(cand.dci_msg.format), location.ncce, location.L);
 
   // Downlink
-  if (cand.dci_msg.format != SRSLTE_DCI_FORMAT0) {
-    dci_dl->rnti = cand.rnti;
-    dci_dl->format = cand.dci_msg.format;
-    dci_dl->nof_bits = cand.dci_msg.nof_bits;
-    dci_dl->hex = hex_str;
-    dci_dl->location = location;
-    dci_dl->histval = histval;
-
+  if (dci_dl != nullptr) {
     /* merge total RB map for RB allocation overview */
     for(uint32_t rb_idx = 0; rb_idx < cell.nof_prb; rb_idx++) {
-      if(dci_dl->dl_grant->prb_idx[0][rb_idx] == true) {
+      if(dci_dl->dl_grant.prb_idx[0][rb_idx] == true) {
         if(rb_map_dl[rb_idx] != FALCON_UNSET_RNTI) {
           dl_collision = true;
         }
@@ -167,28 +193,19 @@ void DCICollection::addCandidate(dci_candidate_t& cand,
       fprintf(stdout, "]\n");
     }
 
-    //q.totRBdw += dci_dl->dl_grant->nof_prb;
-    //q.totBWdw += (uint32_t)(dci_dl->dl_grant->mcs[0].tbs + dci_dl->dl_grant->mcs[1].tbs);
+    //q.totRBdw += dci_dl->dl_grant.nof_prb;
+    //q.totBWdw += (uint32_t)(dci_dl->dl_grant.mcs[0].tbs + dci_dl->dl_grant.mcs[1].tbs);
     //if (q.totRBdw > q.q->cell.nof_prb) q.totBWdw = q.q->cell.nof_prb;
-
-    dci_dl_collection.push_back(std::move(*dci_dl));
   }
 
   // Uplink
-  if (cand.dci_msg.format == SRSLTE_DCI_FORMAT0) {
-    dci_ul->rnti = cand.rnti;
-    dci_ul->format = cand.dci_msg.format;
-    dci_ul->nof_bits = cand.dci_msg.nof_bits;
-    dci_ul->hex = hex_str;
-    dci_ul->location = location;
-    dci_ul->histval = histval;
-
+  if (dci_ul != nullptr) {
     /* merge total RB map for RB allocation overview */
-    for(uint32_t rb_idx = 0; rb_idx < dci_ul->ul_grant->L_prb; rb_idx++) {
-      if(rb_map_ul[dci_ul->ul_grant->n_prb[0] + rb_idx] != FALCON_UNSET_RNTI) {
+    for(uint32_t rb_idx = 0; rb_idx < dci_ul->ul_grant.L_prb; rb_idx++) {
+      if(rb_map_ul[dci_ul->ul_grant.n_prb[0] + rb_idx] != FALCON_UNSET_RNTI) {
         ul_collision = true;
       }
-      rb_map_ul[dci_ul->ul_grant->n_prb[0] + rb_idx] = cand.rnti;
+      rb_map_ul[dci_ul->ul_grant.n_prb[0] + rb_idx] = cand.rnti;
     }
 
     if(SRSLTE_VERBOSE_ISINFO()) {
@@ -197,15 +214,10 @@ void DCICollection::addCandidate(dci_candidate_t& cand,
       fprintf(stdout, "]\n");
     }
 
-    //q.totRBup += dci_ul->ul_grant->L_prb;
-    //q.totBWup +=  (uint32_t) dci_ul->ul_grant->mcs.tbs;
+    //q.totRBup += dci_ul->ul_grant.L_prb;
+    //q.totBWup +=  (uint32_t) dci_ul->ul_grant.mcs.tbs;
     //if (q.totRBup > q.q->cell.nof_prb) q.totBWup = q.q->cell.nof_prb;
-
-    dci_ul_collection.push_back(std::move(*dci_ul));
   }
-
-  delete dci_dl;
-  delete dci_ul;
 }
 
 std::vector<uint16_t> DCICollection::applyLegacyColorMap(const std::vector<uint16_t>& RBMap) {
@@ -2,44 +2,50 @@
 
 #include "falcon/phy/falcon_ue/falcon_ue_dl.h"
 #include <vector>
-#include <memory>
 #include <string>
 
 #define EXPECTED_NOF_DL_DCI_PER_SUBFRAME 10
 #define EXPECTED_NOF_UL_DCI_PER_SUBFRAME 10
 #define MAX_NOF_DL_PRB 100
 #define MAX_NOF_UL_PRB 100
+#define DCI_HEX_MAX_LEN (SRSLTE_DCI_MAX_BITS/4 + 1)
 
 struct DCI_BASE {
     DCI_BASE();
     uint16_t rnti;
     srslte_dci_format_t format;
     uint32_t nof_bits;
-    std::string hex;
+    uint8_t data[SRSLTE_DCI_MAX_BITS];  // raw message bits, hex string is built on demand
     srslte_dci_location_t location;
     uint32_t histval;
+    void sprintHex(char* str, uint32_t max_len) const;
+    std::string getHex() const;
 };
 
 struct DCI_DL : public DCI_BASE {
     DCI_DL();
-    std::unique_ptr<srslte_ra_dl_dci_t> dl_dci_unpacked;
-    std::unique_ptr<srslte_ra_dl_grant_t> dl_grant;
+    srslte_ra_dl_dci_t dl_dci_unpacked;
+    srslte_ra_dl_grant_t dl_grant;
 };
 
 struct DCI_UL : public DCI_BASE {
     DCI_UL();
-    std::unique_ptr<srslte_ra_ul_dci_t> ul_dci_unpacked;
-    std::unique_ptr<srslte_ra_ul_grant_t> ul_grant;
+    srslte_ra_ul_dci_t ul_dci_unpacked;
+    srslte_ra_ul_grant_t ul_grant;
 };
 
 /**
  * @brief The DCICollection class is a container for buffering DCI of a subframe
+ *
+ * DCI are stored by value. A collection is meant to be reset and reused, so that
+ * the containers keep their capacity and no allocations occur in steady state.
  */
 class DCICollection {
 
 public:
     DCICollection(const srslte_cell_t& cell);
     ~DCICollection();
+    void reset(const srslte_cell_t& cell);
     void setTimestamp(struct timeval timestamp);
     timeval getTimestamp() const;
     void setSubframe(uint32_t sfn, uint32_t sf_idx, uint32_t cfi);
@@ -0,0 +1,55 @@
+#include "DCIDecodeCache.h"
+
+#include <string.h>
+
+DCIDecodeCache::DCIDecodeCache() :
+  generation(1)
+{
+  // generation 0 marks an empty entry
+  memset(entries, 0, sizeof(entries));
+}
+
+void DCIDecodeCache::clear() {
+  generation++;
+}
+
+bool DCIDecodeCache::lookup(uint32_t location_idx, uint32_t nof_bits, srslte_dci_msg_t* msg, uint16_t* crc_rem) const {
+  if(location_idx >= MAX_CANDIDATES_BLIND) {
+    return false;
+  }
+  for(uint32_t slot=0; slot<DCI_DECODE_CACHE_SLOTS; slot++) {
+    const Entry& entry = entries[location_idx][slot];
+    if(entry.generation != generation) {
+      // slots are filled in order, no more valid entries
+      break;
+    }
+    if(entry.nof_bits == nof_bits) {
+      memcpy(msg->data, entry.data, sizeof(entry.data));
+      msg->nof_bits = nof_bits;
+      *crc_rem = entry.crc_rem;
+      return true;
+    }
+  }
+  return false;
+}
+
+void DCIDecodeCache::store(uint32_t location_idx, const srslte_dci_msg_t* msg, uint16_t crc_rem) {
+  if(location_idx >= MAX_CANDIDATES_BLIND) {
+    return;
+  }
+  for(uint32_t slot=0; slot<DCI_DECODE_CACHE_SLOTS; slot++) {
+    Entry& entry = entries[location_idx][slot];
+    if(entry.generation != generation) {
+      entry.generation = generation;
+      entry.nof_bits = msg->nof_bits;
+      entry.crc_rem = crc_rem;
+      memcpy(entry.data, msg->data, sizeof(entry.data));
+      return;
+    }
+    if(entry.nof_bits == msg->nof_bits) {
+      // already cached
+      return;
+    }
+  }
+  // all slots in use, do not cache
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "falcon/phy/falcon_ue/falcon_ue_dl.h"
+
+// Distinct payload sizes per location (at most one per DCI format)
+#define DCI_DECODE_CACHE_SLOTS 8
+
+// Memoizes decoded DCI bits and CRC remainder per (location, nof_bits) within one subframe.
+// Locations are identified by their index in the location list of the blind search.
+// Entries of different locations are independent, so threads searching disjoint
+// locations may use the same cache concurrently.
+class DCIDecodeCache {
+public:
+  DCIDecodeCache();
+
+  // invalidates all entries, call at the beginning of each subframe
+  void clear();
+  bool lookup(uint32_t location_idx, uint32_t nof_bits, srslte_dci_msg_t* msg, uint16_t* crc_rem) const;
+  void store(uint32_t location_idx, const srslte_dci_msg_t* msg, uint16_t crc_rem);
+private:
+  struct Entry {
+    uint64_t generation;
+    uint32_t nof_bits;
+    uint16_t crc_rem;
+    uint8_t data[SRSLTE_DCI_MAX_BITS];
+  };
+  Entry entries[MAX_CANDIDATES_BLIND][DCI_DECODE_CACHE_SLOTS];
+  uint64_t generation;
+};
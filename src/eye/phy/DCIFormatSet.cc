@@ -0,0 +1,97 @@
+#include "DCIFormatSet.h"
+
+typedef DCIFormatList<SRSLTE_DCI_FORMAT0,
+                      SRSLTE_DCI_FORMAT1,
+                      SRSLTE_DCI_FORMAT1A,
+                      SRSLTE_DCI_FORMAT1B,
+                      SRSLTE_DCI_FORMAT1C,
+                      SRSLTE_DCI_FORMAT2,
+                      SRSLTE_DCI_FORMAT2A> DCIFormatListOWL;
+
+typedef DCIFormatList<SRSLTE_DCI_FORMAT0,
+                      SRSLTE_DCI_FORMAT1,
+                      SRSLTE_DCI_FORMAT1A,
+                      SRSLTE_DCI_FORMAT1C,
+                      SRSLTE_DCI_FORMAT2A> DCIFormatListFalcon;
+
+// cells without spatial multiplexing (TM 1, 2, 5-7)
+typedef DCIFormatList<SRSLTE_DCI_FORMAT0,
+                      SRSLTE_DCI_FORMAT1,
+                      SRSLTE_DCI_FORMAT1A,
+                      SRSLTE_DCI_FORMAT1B,
+                      SRSLTE_DCI_FORMAT1C,
+                      SRSLTE_DCI_FORMAT1D> DCIFormatListSISO;
+
+typedef DCIFormatList<SRSLTE_DCI_FORMAT0,
+                      SRSLTE_DCI_FORMAT1,
+                      SRSLTE_DCI_FORMAT1A,
+                      SRSLTE_DCI_FORMAT1C,
+                      SRSLTE_DCI_FORMAT1B,
+                      SRSLTE_DCI_FORMAT1D,
+                      SRSLTE_DCI_FORMAT2,
+                      SRSLTE_DCI_FORMAT2A> DCIFormatListAll;
+
+static const DCIFormatSet formatSets[] = {
+  DCIFormatSet::fromList<DCIFormatListOWL>("owl"),
+  DCIFormatSet::fromList<DCIFormatListFalcon>("falcon"),
+  DCIFormatSet::fromList<DCIFormatListSISO>("siso"),
+  DCIFormatSet::fromList<DCIFormatListAll>("all"),
+};
+
+const srslte_dci_format_t falcon_ue_all_formats[] = {
+  SRSLTE_DCI_FORMAT0,
+  SRSLTE_DCI_FORMAT1,
+  SRSLTE_DCI_FORMAT1A,
+  SRSLTE_DCI_FORMAT1B,
+  SRSLTE_DCI_FORMAT1C,
+  SRSLTE_DCI_FORMAT2,
+  SRSLTE_DCI_FORMAT2A
+};
+const uint32_t nof_falcon_ue_all_formats = 7;
+
+DCIFormatSet::DCIFormatSet(const char* name, const srslte_dci_format_t* formats, const uint32_t* flags, uint32_t nof_formats) :
+  name(name),
+  formats(formats),
+  flags(flags),
+  nof_formats(nof_formats)
+{
+
+}
+
+const char* DCIFormatSet::getName() const {
+  return name;
+}
+
+uint32_t DCIFormatSet::getNofFormats() const {
+  return nof_formats;
+}
+
+srslte_dci_format_t DCIFormatSet::getFormat(uint32_t idx) const {
+  return formats[idx];
+}
+
+uint32_t DCIFormatSet::getFlags(uint32_t idx) const {
+  return flags[idx];
+}
+
+int DCIFormatSet::indexOf(srslte_dci_format_t format) const {
+  for(uint32_t i=0; i<nof_formats; i++) {
+    if(formats[i] == format) {
+      return static_cast<int>(i);
+    }
+  }
+  return -1;
+}
+
+const DCIFormatSet* DCIFormatSet::get(const std::string& name) {
+  for(const DCIFormatSet& set : formatSets) {
+    if(name == set.name) {
+      return &set;
+    }
+  }
+  return nullptr;
+}
+
+const DCIFormatSet& DCIFormatSet::getDefault() {
+  return formatSets[0];
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <stdint.h>
+#include <string>
+
+#include "srslte/phy/phch/dci.h"
+
+// format list of the C library (falcon_ue_dl), equals the default set
+extern const srslte_dci_format_t falcon_ue_all_formats[];
+extern const uint32_t nof_falcon_ue_all_formats;
+
+// Properties of a DCI format that the blind search evaluates per candidate
+#define DCI_FORMAT_FLAG_UPLINK 0x01       // format 0
+#define DCI_FORMAT_FLAG_0_1A 0x02         // shares the payload size of 0/1A, format given by the flag bit
+#define DCI_FORMAT_FLAG_COMMON_ONLY 0x04  // RA-, P- and SI-RNTI only (format 1C)
+#define DCI_FORMAT_FLAG_RA_RNTI 0x08      // the only format carrying RA-RNTI (format 1A)
+
+template <srslte_dci_format_t F>
+struct DCIFormatTraits {
+  static constexpr uint32_t flags =
+      (F == SRSLTE_DCI_FORMAT0 ? DCI_FORMAT_FLAG_UPLINK : 0) |
+      (F == SRSLTE_DCI_FORMAT0 || F == SRSLTE_DCI_FORMAT1A ? DCI_FORMAT_FLAG_0_1A : 0) |
+      (F == SRSLTE_DCI_FORMAT1C ? DCI_FORMAT_FLAG_COMMON_ONLY : 0) |
+      (F == SRSLTE_DCI_FORMAT1A ? DCI_FORMAT_FLAG_RA_RNTI : 0);
+};
+
+// List of formats fixed at compile time; the traits are folded into a table.
+// Format 0 must be the first element (uplink format index of the RNTIManager).
+template <srslte_dci_format_t... F>
+struct DCIFormatList {
+  static constexpr uint32_t nof_formats = sizeof...(F);
+  static const srslte_dci_format_t formats[sizeof...(F)];
+  static const uint32_t flags[sizeof...(F)];
+};
+
+template <srslte_dci_format_t... F>
+const srslte_dci_format_t DCIFormatList<F...>::formats[sizeof...(F)] = {F...};
+
+template <srslte_dci_format_t... F>
+const uint32_t DCIFormatList<F...>::flags[sizeof...(F)] = {DCIFormatTraits<F>::flags...};
+
+/**
+ * @brief Set of DCI formats to search, selected by name at startup.
+ * The index of a format in the set is its global index in DCIMetaFormats and RNTIManager.
+ */
+class DCIFormatSet {
+public:
+  template <class List>
+  static DCIFormatSet fromList(const char* name) {
+    return DCIFormatSet(name, List::formats, List::flags, List::nof_formats);
+  }
+
+  const char* getName() const;
+  uint32_t getNofFormats() const;
+  srslte_dci_format_t getFormat(uint32_t idx) const;
+  uint32_t getFlags(uint32_t idx) const;
+  // index of format in this set, -1 if not included
+  int indexOf(srslte_dci_format_t format) const;
+
+  // "owl" (default, compatible with IMDEA OWL), "falcon", "siso" (no 2/2A) or "all";
+  // nullptr for unknown names
+  static const DCIFormatSet* get(const std::string& name);
+  static const DCIFormatSet& getDefault();
+private:
+  DCIFormatSet(const char* name, const srslte_dci_format_t* formats, const uint32_t* flags, uint32_t nof_formats);
+  const char* name;
+  const srslte_dci_format_t* formats;
+  const uint32_t* flags;
+  uint32_t nof_formats;
+};
@@ -0,0 +1,45 @@
+#include "DCIHintTable.h"
+
+DCIHintTable::DCIHintTable() {
+  clear();
+}
+
+void DCIHintTable::add(uint32_t tti, uint16_t rnti, srslte_dci_format_t format, uint32_t L) {
+  uint32_t target = (tti + DCI_HINT_HARQ_RTT) % DCI_HINT_NOF_TTI;
+  std::lock_guard<std::mutex> lock(m);
+  Slot& slot = slots[target % DCI_HINT_NOF_SLOTS];
+  if(slot.tti != target) {
+    // outdated hints of an earlier subframe
+    slot.tti = target;
+    slot.nof_hints = 0;
+  }
+  for(uint32_t i=0; i<slot.nof_hints; i++) {
+    if(slot.hints[i].rnti == rnti && slot.hints[i].format == format) {
+      return;
+    }
+  }
+  if(slot.nof_hints < DCI_HINT_MAX_PER_SLOT) {
+    slot.hints[slot.nof_hints++] = DCIHint{rnti, format, L};
+  }
+}
+
+uint32_t DCIHintTable::get(uint32_t tti, DCIHint* hints, uint32_t max_hints) {
+  std::lock_guard<std::mutex> lock(m);
+  const Slot& slot = slots[tti % DCI_HINT_NOF_SLOTS];
+  if(slot.tti != tti) {
+    return 0;
+  }
+  uint32_t n = slot.nof_hints < max_hints ? slot.nof_hints : max_hints;
+  for(uint32_t i=0; i<n; i++) {
+    hints[i] = slot.hints[i];
+  }
+  return n;
+}
+
+void DCIHintTable::clear() {
+  std::lock_guard<std::mutex> lock(m);
+  for(uint32_t i=0; i<DCI_HINT_NOF_SLOTS; i++) {
+    slots[i].tti = DCI_HINT_NOF_TTI;  // no subframe
+    slots[i].nof_hints = 0;
+  }
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <stdint.h>
+#include <mutex>
+
+#include "falcon/phy/falcon_ue/falcon_ue_dl.h"
+
+// HARQ round trip (FDD): the next DCI of the same HARQ process follows 8 subframes later
+#define DCI_HINT_HARQ_RTT 8
+#define DCI_HINT_NOF_SLOTS 16
+#define DCI_HINT_MAX_PER_SLOT 32
+// subframe numbering 10*sfn + sf_idx
+#define DCI_HINT_NOF_TTI 10240
+
+struct DCIHint {
+  uint16_t rnti;
+  srslte_dci_format_t format;
+  uint32_t L;
+};
+
+// Predicted DCI of upcoming subframes, derived from the HARQ timing of DCI found in
+// earlier subframes: a C-RNTI with DCI in subframe n is expected again in n+8 with the
+// same format and aggregation level (retransmission or next transport block of the HARQ
+// process). The position follows from the search space of the RNTI in subframe n+8.
+// Shared by all subframe workers; subframes that are too old or too far ahead find no hints.
+class DCIHintTable {
+public:
+  DCIHintTable();
+  DCIHintTable(const DCIHintTable&) = delete; //prevent copy
+  DCIHintTable& operator=(const DCIHintTable&) = delete; //prevent copy
+
+  // DCI found in subframe tti
+  void add(uint32_t tti, uint16_t rnti, srslte_dci_format_t format, uint32_t L);
+  // copies the hints for subframe tti, returns their number
+  uint32_t get(uint32_t tti, DCIHint* hints, uint32_t max_hints);
+  void clear();
+private:
+  struct Slot {
+    uint32_t tti;   // subframe of the hints in this slot
+    uint32_t nof_hints;
+    DCIHint hints[DCI_HINT_MAX_PER_SLOT];
+  };
+  Slot slots[DCI_HINT_NOF_SLOTS];
+  std::mutex m;
+};
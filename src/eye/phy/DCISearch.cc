@@ -23,89 +23,89 @@
 #include "DCICollection.h"
 
 #include "falcon/prof/Lifetime.h"
+#include "falcon/common/Settings.h"
 
 #define MIN(a, b) (a > b ? b : a)
 #define MAX(a, b) (a > b ? a : b)
 
-/**
-  * MAX_RECURSION_DEPTH
-  * 0: Recursion disabled (= breadth-first search)
-  * 1..L: Limit depth of recursive dci search
-  * 99: Unlimited (since L is not larger than 3)
-  */
-#ifndef MAX_RECURSION_DEPTH
-#define MAX_RECURSION_DEPTH 99
-#endif
-
-/**
-  * DCI_DISAMBIGUATION_DEPTH:
-  * 0: Disambiguation disabled
-  * 1..MAX_RECURSION_DEPTH: Recursion depth for disambiguation search
-  */
-#ifndef DCI_DISAMBIGUATION_DEPTH
-#define DCI_DISAMBIGUATION_DEPTH MAX_RECURSION_DEPTH
-#endif
-
-#if MAX_RECURSION_DEPTH == -1
-#error("FAILED")
-#endif
-
-
 #define CNI_HISTOGRAM
 
 #define RNTILIFELEN 2
 
 //#define PRINT_SCAN_TIME
 
-//const srslte_dci_format_t falcon_ue_all_formats[] = {
-//  SRSLTE_DCI_FORMAT0,
-//  SRSLTE_DCI_FORMAT1,
-//  SRSLTE_DCI_FORMAT1A,
-//  SRSLTE_DCI_FORMAT1C,
-//  SRSLTE_DCI_FORMAT1B,
-//  SRSLTE_DCI_FORMAT1D,
-//  SRSLTE_DCI_FORMAT2,
-//  SRSLTE_DCI_FORMAT2A,
-//};
-//const uint32_t nof_falcon_ue_all_formats = 8;
-
-#define IMDEA_OWL_COMPAT
-#ifndef IMDEA_OWL_COMPAT
-
-const srslte_dci_format_t falcon_ue_all_formats[] = {
-  SRSLTE_DCI_FORMAT0,
-  SRSLTE_DCI_FORMAT1,
-  SRSLTE_DCI_FORMAT1A,
-  SRSLTE_DCI_FORMAT1C,
-  SRSLTE_DCI_FORMAT2A,
-};
-const uint32_t nof_falcon_ue_all_formats = 5;
-
-#else
-
-const srslte_dci_format_t falcon_ue_all_formats[] = {
-  SRSLTE_DCI_FORMAT0,
-  SRSLTE_DCI_FORMAT1,
-  SRSLTE_DCI_FORMAT1A,
-  SRSLTE_DCI_FORMAT1B,
-  SRSLTE_DCI_FORMAT1C,
-  SRSLTE_DCI_FORMAT2,
-  SRSLTE_DCI_FORMAT2A
-};
-const uint32_t nof_falcon_ue_all_formats = 7;
-
-#endif
-
+uint32_t DCISearch::decode_location(DCISearchContext& ctx,
+                                uint32_t cfi,
+                                falcon_dci_location_t *location,
+                                uint32_t location_idx,
+                                falcon_dci_meta_format_t **meta_formats,
+                                uint32_t nof_formats,
+                                dci_candidate_t cand[])
+{
+  // Take payload sizes already decoded at this location from the cache (e.g. in the previous pass)
+  srslte_dci_format_t formats[MAX_NOF_META_FORMATS];
+  srslte_dci_msg_t* msgs[MAX_NOF_META_FORMATS];
+  uint16_t* crc_rem[MAX_NOF_META_FORMATS];
+  uint32_t nof_missed = 0;
+  for(uint32_t format_idx=0; format_idx<nof_formats; format_idx++) {
+    srslte_dci_format_t format = meta_formats[format_idx]->format;
+    uint32_t nof_bits = formatNofBits[meta_formats[format_idx]->global_index];
+    if(decodeCache.lookup(location_idx, nof_bits, &cand[format_idx].dci_msg, &cand[format_idx].rnti)) {
+      falcon_pdcch_dci_msg_set_format(&cand[format_idx].dci_msg, format);
+      ctx.stats.nof_decode_cache_hits++;
+    }
+    else {
+      formats[nof_missed] = format;
+      msgs[nof_missed] = &cand[format_idx].dci_msg;
+      crc_rem[nof_missed] = &cand[format_idx].rnti;
+      nof_missed++;
+    }
+  }
 
+  // Decode the remaining formats at once (CRC and DCI)
+  uint32_t nof_decoder_runs = 0;
+  if(nof_missed > 0) {
+    //gettimeofday(&t[1], nullptr);
+    int nof_runs = falcon_pdcch_decode_msg_multi(&ue_dl.pdcch, &ctx.decoder, location, formats, nof_missed, cfi, msgs, crc_rem, 0);
+    if(nof_runs < 0) {
+      ERROR("Error calling falcon_pdcch_decode_msg_multi\n");
+    }
+    else if(nof_runs > 0) {
+      nof_decoder_runs = static_cast<uint32_t>(nof_runs);
+      for(uint32_t i=0; i<nof_missed; i++) {
+        decodeCache.store(location_idx, msgs[i], *crc_rem[i]);
+        if(*crc_rem[i] == FALCON_ILLEGAL_RNTI) {
+          ctx.stats.nof_abandoned_decodes++;
+        }
+      }
+    }
+    ctx.stats.nof_decode_cache_misses += nof_missed;
+  }
+  return nof_decoder_runs;
+}
 
+void DCISearch::mark_occupied(falcon_cce_to_dci_location_map_t *cce_map, uint32_t ncce, uint32_t L) {
+  for(uint32_t cce_idx=ncce; cce_idx < ncce+(1 << L); cce_idx++) {
+    for(uint32_t aggr=0; aggr < 4; aggr++) {
+      if (cce_map[cce_idx].location[aggr]) {
+        cce_map[cce_idx].location[aggr]->occupied = 1;
+        cce_map[cce_idx].location[aggr]->checked = 1;
+      }
+    }
+  }
+}
 
-int DCISearch::inspect_dci_location_recursively(srslte_dci_msg_t *dci_msg,
+// recursive == false: breadth-first search (max_depth 0), compiled without the recursive descent
+template <bool recursive>
+int DCISearch::inspect_dci_location_recursively(DCISearchContext& ctx,
+                srslte_dci_msg_t *dci_msg,
                 uint32_t cfi,
                 falcon_cce_to_dci_location_map_t *cce_map,
                 falcon_dci_location_t *location_list,
                 uint32_t ncce,
                 uint32_t L,
                 uint32_t max_depth,
+                uint32_t depth,
                 falcon_dci_meta_format_t **meta_formats,
                 uint32_t nof_formats,
                 uint32_t enable_discovery,
@@ -117,27 +117,34 @@ int DCISearch::inspect_dci_location_recursively(srslte_dci_msg_t *dci_msg,
   unsigned int hist_max_format_value = 0;
   unsigned int nof_cand_above_threshold = 0;
 
-  dci_candidate_t* cand = falcon_alloc_candidates(nof_formats);
+  dci_candidate_t* cand = ctx.candidates.alloc(nof_formats);
 
   //struct timeval t[3];
 
   if (cce_map[ncce].location[L] &&
       !cce_map[ncce].location[L]->occupied &&
       !cce_map[ncce].location[L]->checked &&
-      cce_map[ncce].location[L]->sufficient_power)
+      cce_map[ncce].location[L]->sufficient_power &&
+      (!enforceOccupancyGate || cce_map[ncce].location[L]->occupancy >= occupancyThreshold))
   {
-    // Decode candidate for each format (CRC and DCI)
+    uint32_t location_idx = static_cast<uint32_t>(cce_map[ncce].location[L] - location_list);
+    uint32_t nof_misses = ctx.stats.nof_decode_cache_misses;
+    // formats of equal size share a decoder run, formats in the decode cache need none
+    uint32_t nof_runs = decode_location(ctx, cfi, cce_map[ncce].location[L], location_idx, meta_formats, nof_formats, cand);
+    ctx.stats.nof_blind_decodes += ctx.stats.nof_decode_cache_misses - nof_misses;
+    ctx.stats.nof_decoded_locations += nof_runs;
+    ctx.stats.nof_decoded_per_depth[MIN(depth, DCI_SEARCH_NOF_DEPTHS - 1)] += nof_runs;
+
     for(uint32_t format_idx=0; format_idx<nof_formats; format_idx++) {
-      //gettimeofday(&t[1], nullptr);
-      int result = srslte_pdcch_decode_msg_limit_avg_llr_power(&ue_dl.pdcch, &cand[format_idx].dci_msg, cce_map[ncce].location[L], meta_formats[format_idx]->format, cfi, &cand[format_idx].rnti, 0);
-      stats.nof_decoded_locations++;
 #ifdef PRINT_ALL_CANDIDATES
       printf("Cand. %d (sfn %d.%d, ncce %d, L %d, f_idx %d)\n", &cand[format_idx].rnti, sfn, sf_idx, ncce, L, format_idx);
 #endif
-      if(result != SRSLTE_SUCCESS) {
-        ERROR("Error calling srslte_pdcch_decode_msg_limit_avg_llr_power\n");
+      if(cand[format_idx].rnti == FALCON_ILLEGAL_RNTI) {
+        // abandoned by the list Viterbi
+        continue;
       }
-      if(meta_formats[format_idx]->format != cand[format_idx].dci_msg.format) {
+      uint32_t flags = formatFlags[meta_formats[format_idx]->global_index];
+      if((flags & DCI_FORMAT_FLAG_0_1A) && meta_formats[format_idx]->format != cand[format_idx].dci_msg.format) {
         //format 0/1A format mismatch
         INFO("Dropped DCI cand. %d (format_idx %d) L%d ncce %d (format 0/1A mismatch)\n", cand[format_idx].rnti, format_idx, L, ncce);
         cand[format_idx].rnti = FALCON_ILLEGAL_RNTI;
@@ -148,7 +155,7 @@ int DCISearch::inspect_dci_location_recursively(srslte_dci_msg_t *dci_msg,
       //printf("Decoding time: %d us (sfn %d, ncce %d, L %d)\n", t[0].tv_usec, sfn, ncce, L);
 
       // Filter 1a: Disallowed RNTI values for format 1C
-      if ((meta_formats[format_idx]->format==SRSLTE_DCI_FORMAT1C) && (cand[format_idx].rnti > SRSLTE_RARNTI_END) && (cand[format_idx].rnti < SRSLTE_PRNTI)) {
+      if ((flags & DCI_FORMAT_FLAG_COMMON_ONLY) && (cand[format_idx].rnti > SRSLTE_RARNTI_END) && (cand[format_idx].rnti < SRSLTE_PRNTI)) {
         //DEBUG("Dropped DCI 1C cand. by illegal RNTI: 0x%x\n", cand[format_idx].rnti);
         INFO("Dropped DCI cand. %d (format_idx %d) L%d ncce %d (RNTI not allowed in format1C)\n", cand[format_idx].rnti, format_idx, L, ncce);
         cand[format_idx].rnti = FALCON_ILLEGAL_RNTI;
@@ -157,9 +164,9 @@ int DCISearch::inspect_dci_location_recursively(srslte_dci_msg_t *dci_msg,
       // Filter 1a-RA: Disallowed formats for RA-RNTI
       if ((cand[format_idx].rnti > SRSLTE_RARNTI_START) &&
           (cand[format_idx].rnti < SRSLTE_RARNTI_END)) {
-        if(meta_formats[format_idx]->format==SRSLTE_DCI_FORMAT1A) {
+        if(flags & DCI_FORMAT_FLAG_RA_RNTI) {
           INFO("Found RA-RNTI: 0x%x\n", cand[format_idx].rnti);
-          ue_dl.current_rnti = cand[format_idx].rnti;
+          ctx.ra_rnti = cand[format_idx].rnti;
         }
         else {
           //DEBUG("Dropped DCI cand.: RA-RNTI only with format 1A: 0x%x\n", cand[format_idx].rnti);
@@ -179,12 +186,12 @@ int DCISearch::inspect_dci_location_recursively(srslte_dci_msg_t *dci_msg,
          )
       {
         INFO("RNTI matches to parent DCI cand. %d (format_idx %d), this: L%d ncce %d\n", cand[format_idx].rnti, meta_formats[format_idx]->global_index, L, ncce);
-        falcon_free_candidates(cand);
+        ctx.candidates.release(cand);
         return -(static_cast<int>(format_idx)+1);
       }
 
       // Filter 1b: Illegal DCI positions
-      cand[format_idx].search_space_match_result = srslte_pdcch_validate_location(srslte_pdcch_nof_cce(&ue_dl.pdcch, cfi), ncce, L, sf_idx, cand[format_idx].rnti);
+      cand[format_idx].search_space_match_result = falcon_search_space_cache_validate_location(&ctx.searchSpace, srslte_pdcch_nof_cce(&ue_dl.pdcch, cfi), ncce, L, sf_idx, cand[format_idx].rnti);
       if (cand[format_idx].search_space_match_result == 0) {
         //DEBUG("Dropped DCI cand. by illegal position: 0x%x\n", cand[format_idx].rnti);
         INFO("Dropped DCI cand. %d (format_idx %d) L%d ncce %d (illegal position)\n", cand[format_idx].rnti, format_idx, L, ncce);
@@ -255,29 +262,28 @@ int DCISearch::inspect_dci_location_recursively(srslte_dci_msg_t *dci_msg,
     cce_map[ncce].location[L]->checked = 1;
 
     int disambiguation_count = 0;
-#if DCI_DISAMBIGUATION_DEPTH > 0
     // check, if the location of the preferred DCI is ambiguous with L-1
     // to prevent overshadowing of neighbouring DCI with L-1 in the right half
-    if(nof_cand_above_threshold > 0 &&
+    if(recursive &&
+       disambiguationDepth > 0 &&
+       nof_cand_above_threshold > 0 &&
        cand[hist_max_format_idx].search_space_match_result == SEARCH_SPACE_MATCH_RESULT_AMBIGUOUS ) {
 
       //descend only right half; pass nullptr as parent_rnti_cands; disable further shortcuts
       if(L > 0 && max_depth > 0) {
-        disambiguation_count = inspect_dci_location_recursively(dci_msg, cfi, cce_map, location_list, ncce + (1 << (L-1)), L-1, max_depth-1, meta_formats, nof_formats, 0, nullptr);
+        disambiguation_count = inspect_dci_location_recursively<recursive>(ctx, dci_msg, cfi, cce_map, location_list, ncce + (1 << (L-1)), L-1, MIN(max_depth, disambiguationDepth)-1, depth+1, meta_formats, nof_formats, 0, nullptr);
       }
       if(disambiguation_count > 0) {
         INFO("Disambiguation discovered %d additional DCI\n", disambiguation_count);
       }
     }
-    else
-#endif
     // if no candidates were found, descend covered CCEs recursively
-    if(nof_cand_above_threshold == 0) {
+    else if(nof_cand_above_threshold == 0) {
       // found nothing - recursion, if applicable
       int recursion_result = 0;
-      if(L > 0 && max_depth > 0) {
+      if(recursive && L > 0 && max_depth > 0) {
         //descend left half; pass parent_rnti_cands for shortcuts...
-        recursion_result += inspect_dci_location_recursively(dci_msg, cfi, cce_map, location_list, ncce, L-1, max_depth-1, meta_formats, nof_formats, enable_discovery, cand);
+        recursion_result += inspect_dci_location_recursively<recursive>(ctx, dci_msg, cfi, cce_map, location_list, ncce, L-1, max_depth-1, depth+1, meta_formats, nof_formats, enable_discovery, cand);
         if(recursion_result < 0) {
           //shortcut taken, activate RNTI
           INFO("Shortcut detected: RNTI: %d (format_idx %d)!\n", cand[-recursion_result - 1].rnti, -recursion_result - 1);
@@ -285,22 +291,21 @@ int DCISearch::inspect_dci_location_recursively(srslte_dci_msg_t *dci_msg,
           //hist_max_format_value = rnti_manager_getFrequency(q.rnti_manager, cand[hist_max_format_idx].rnti, meta_formats[(uint32_t)hist_max_format_idx]->global_index);
           hist_max_format_value = rntiManager.getFrequency(cand[hist_max_format_idx].rnti, meta_formats[static_cast<uint32_t>(hist_max_format_idx)]->global_index);
           nof_cand_above_threshold = 1;
-#if DCI_DISAMBIGUATION_DEPTH > 0
           //Very rare special case: The DCI just discovered may overshadow neighbouring DCI with L-1 in the right half
-          if(cand[hist_max_format_idx].search_space_match_result == SEARCH_SPACE_MATCH_RESULT_AMBIGUOUS ) {
+          if(disambiguationDepth > 0 &&
+             cand[hist_max_format_idx].search_space_match_result == SEARCH_SPACE_MATCH_RESULT_AMBIGUOUS ) {
             //descend only right half; pass nullptr as parent_rnti_cands; disable further shortcuts
-            disambiguation_count = inspect_dci_location_recursively(dci_msg, cfi, cce_map, location_list, ncce + (1 << (L-1)), L-1, MIN(max_depth, DCI_DISAMBIGUATION_DEPTH)-1, meta_formats, nof_formats, 0, nullptr);
+            disambiguation_count = inspect_dci_location_recursively<recursive>(ctx, dci_msg, cfi, cce_map, location_list, ncce + (1 << (L-1)), L-1, MIN(max_depth, disambiguationDepth)-1, depth+1, meta_formats, nof_formats, 0, nullptr);
             if(disambiguation_count > 0) {
               INFO("Disambiguation discovered %d additional DCI\n", disambiguation_count);
             }
           }
-#endif
           //rnti_manager_activate_and_refresh(q.rnti_manager, cand[hist_max_format_idx].rnti, meta_formats[(uint32_t)hist_max_format_idx]->global_index, RM_ACT_SHORTCUT);
           rntiManager.activateAndRefresh(cand[hist_max_format_idx].rnti, meta_formats[static_cast<uint32_t>(hist_max_format_idx)]->global_index, RM_ACT_SHORTCUT);
         }
         else {
           //descend right half; pass NULL as parent_rnti_cands
-          recursion_result += inspect_dci_location_recursively(dci_msg, cfi, cce_map, location_list, ncce + (1 << (L-1)), L-1, max_depth-1, meta_formats, nof_formats, enable_discovery, nullptr);
+          recursion_result += inspect_dci_location_recursively<recursive>(ctx, dci_msg, cfi, cce_map, location_list, ncce + (1 << (L-1)), L-1, max_depth-1, depth+1, meta_formats, nof_formats, enable_discovery, nullptr);
         }
       }
 
@@ -317,7 +322,7 @@ int DCISearch::inspect_dci_location_recursively(srslte_dci_msg_t *dci_msg,
               rnti_histogram_add_rnti(&q->rnti_histogram[0], cand[format_idx].rnti);
   #else
               //rnti_manager_add_candidate(q.rnti_manager, cand[format_idx].rnti, meta_formats[format_idx]->global_index);
-              rntiManager.addCandidate(cand[format_idx].rnti, meta_formats[format_idx]->global_index);
+              ctx.rntiCandidates.add(cand[format_idx].rnti, meta_formats[format_idx]->global_index);
               INFO("Dropped DCI cand. %d (format_idx %d) L%d ncce %d (spurious/infrequent), add to histogram\n", cand[format_idx].rnti, format_idx, L, ncce);
   #endif
 
@@ -330,11 +335,11 @@ int DCISearch::inspect_dci_location_recursively(srslte_dci_msg_t *dci_msg,
             }
           }
         }
-        falcon_free_candidates(cand);
+        ctx.candidates.release(cand);
         return 0;
       }
       else if(recursion_result > 0) {
-        falcon_free_candidates(cand);
+        ctx.candidates.release(cand);
         return recursion_result;
       }
       //else if(recursion_result < 0) { do not return }
@@ -346,14 +351,7 @@ int DCISearch::inspect_dci_location_recursively(srslte_dci_msg_t *dci_msg,
       cce_map[ncce].location[L]->used = 1;
 
       // mark all other locations which overlap this location as checked
-      for(uint32_t cce_idx=ncce; cce_idx < ncce+(1 << L); cce_idx++) {
-        for(uint32_t aggr=0; aggr < 4; aggr++) {
-          if (cce_map[cce_idx].location[aggr]) {
-            cce_map[cce_idx].location[aggr]->occupied = 1;
-            cce_map[cce_idx].location[aggr]->checked = 1;
-          }
-        }
-      }
+      mark_occupied(cce_map, ncce, L);
 
       // accept only the most frequent dci candidate and ignore others
 #ifndef __NEW_HISTOGRAM__
@@ -361,19 +359,23 @@ int DCISearch::inspect_dci_location_recursively(srslte_dci_msg_t *dci_msg,
 #else
       //rnti_manager_add_candidate(q.rnti_manager, cand[hist_max_format_idx].rnti, meta_formats[(uint32_t)hist_max_format_idx]->global_index);
       // inform rntiManager of the accepted candidate (track activity in histogram)
-      rntiManager.addCandidate(cand[hist_max_format_idx].rnti, meta_formats[(uint32_t)hist_max_format_idx]->global_index);
+      ctx.rntiCandidates.add(cand[hist_max_format_idx].rnti, meta_formats[(uint32_t)hist_max_format_idx]->global_index);
 #endif
 
       // inform meta_formats of the accepted format
-      meta_formats[(uint32_t)hist_max_format_idx]->hits++;
+      metaFormats.countHit(meta_formats[(uint32_t)hist_max_format_idx]);
       // correct L if this candidate's L is ambiguous and disambiguation found another dci overshadoved by this candidate
       uint32_t L_disamb = disambiguation_count > 0 ? L-1 : L;
 
-      // finally, process the accepted DCI
-      dciCollection.addCandidate(cand[hist_max_format_idx], srslte_dci_location_t{L_disamb, ncce}, hist_max_format_value);
+      // finally, keep the accepted DCI for the DCICollection
+      DCISearchResult result;
+      result.cand = cand[hist_max_format_idx];
+      result.location = srslte_dci_location_t{L_disamb, ncce};
+      result.histval = hist_max_format_value;
+      ctx.found.push_back(result);
 
       // cleanup and return
-      falcon_free_candidates(cand);
+      ctx.candidates.release(cand);
       return 1 + disambiguation_count;
     }
     else {
@@ -381,10 +383,272 @@ int DCISearch::inspect_dci_location_recursively(srslte_dci_msg_t *dci_msg,
       ERROR("nof_cand_above_threshold <= 0 but this was not caught earlier.\n");
     }
   }
-  falcon_free_candidates(cand);
+  ctx.candidates.release(cand);
   return 0;
 }
 
+void DCISearch::accept_candidate(DCISearchContext& ctx,
+                                 falcon_cce_to_dci_location_map_t *cce_map,
+                                 falcon_dci_location_t *location,
+                                 const dci_candidate_t& cand,
+                                 falcon_dci_meta_format_t *meta_format,
+                                 uint32_t histval)
+{
+  location->used = 1;
+  mark_occupied(cce_map, location->ncce, location->L);
+  if(cand.rnti > SRSLTE_RARNTI_START && cand.rnti < SRSLTE_RARNTI_END) {
+    INFO("Found RA-RNTI: 0x%x\n", cand.rnti);
+    ctx.ra_rnti = cand.rnti;
+  }
+  ctx.rntiCandidates.add(cand.rnti, meta_format->global_index);
+  metaFormats.countHit(meta_format);
+
+  DCISearchResult result;
+  result.cand = cand;
+  result.location = srslte_dci_location_t{location->L, location->ncce};
+  result.histval = histval;
+  ctx.found.push_back(result);
+}
+
+int DCISearch::hinted_dci_search(uint32_t cfi,
+                                 falcon_cce_to_dci_location_map_t *cce_map,
+                                 falcon_dci_location_t *locations)
+{
+  DCISearchContext& ctx = searchPool.getContext(0);
+  ctx.found.clear();
+  ctx.ra_rnti = 0xffff;
+  uint32_t nof_cce = srslte_pdcch_nof_cce(&ue_dl.pdcch, cfi);
+
+  DCIHint hints[DCI_HINT_MAX_PER_SLOT];
+  uint32_t nof_hints = hintTable->get(10*sfn + sf_idx, hints, DCI_HINT_MAX_PER_SLOT);
+  for(uint32_t i=0; i<nof_hints; i++) {
+    const DCIHint& hint = hints[i];
+    // only the predicted format; the remaining formats follow in the later phases
+    falcon_dci_meta_format_t* meta_format = nullptr;
+    for(uint32_t j=0; j<nof_primary_meta_formats + nof_secondary_meta_formats && meta_format == nullptr; j++) {
+      falcon_dci_meta_format_t* mf = j < nof_primary_meta_formats ? primaryMetaFormats[j] : secondaryMetaFormats[j - nof_primary_meta_formats];
+      if(mf->format == hint.format) {
+        meta_format = mf;
+      }
+    }
+    if(meta_format == nullptr) {
+      continue;
+    }
+
+    // positions of the predicted aggregation level in the search space of this subframe
+    srslte_dci_location_t loc[TARGETED_SEARCH_MAX_LOCATIONS];
+    uint32_t nof_loc = srslte_pdcch_ue_locations_ncce(nof_cce, loc, TARGETED_SEARCH_MAX_LOCATIONS, sf_idx, hint.rnti);
+    for(uint32_t k=0; k<nof_loc; k++) {
+      if(loc[k].L != hint.L || loc[k].ncce >= MAX_NUM_OF_CCE) {
+        continue;
+      }
+      falcon_dci_location_t* location = cce_map[loc[k].ncce].location[loc[k].L];
+      // hinted locations bypass the occupancy gate; ambiguous positions are left to the blind search
+      if(location == nullptr || location->occupied || !location->sufficient_power ||
+         falcon_search_space_cache_validate_location(&ctx.searchSpace, nof_cce, location->ncce, location->L, sf_idx, hint.rnti) != SEARCH_SPACE_MATCH_RESULT_EXACT) {
+        continue;
+      }
+      dci_candidate_t* cand = ctx.candidates.alloc(1);
+      uint32_t nof_misses = ctx.stats.nof_decode_cache_misses;
+      decode_location(ctx, cfi, location, static_cast<uint32_t>(location - locations), &meta_format, 1, cand);
+      ctx.stats.nof_hinted_decodes += ctx.stats.nof_decode_cache_misses - nof_misses;
+
+      bool hit = cand[0].rnti == hint.rnti &&
+                 cand[0].dci_msg.format == hint.format &&
+                 rntiManager.validateAndRefresh(hint.rnti, meta_format->global_index);
+      if(hit) {
+        accept_candidate(ctx, cce_map, location, cand[0], meta_format, rntiManager.getFrequency(hint.rnti, meta_format->global_index));
+        ctx.stats.nof_hinted_dci++;
+      }
+      ctx.candidates.release(cand);
+      if(hit) {
+        break;
+      }
+    }
+  }
+  return accept_results(ctx.found, ctx.ra_rnti);
+}
+
+int DCISearch::targeted_dci_search(uint32_t cfi,
+                                   falcon_cce_to_dci_location_map_t *cce_map,
+                                   falcon_dci_location_t *locations,
+                                   uint32_t nof_locations)
+{
+  DCISearchContext& ctx = searchPool.getContext(0);
+  ctx.found.clear();
+  ctx.ra_rnti = 0xffff;
+  uint32_t nof_cce = srslte_pdcch_nof_cce(&ue_dl.pdcch, cfi);
+
+  // all formats at once; the blind search takes these payloads from the decode cache
+  falcon_dci_meta_format_t* meta_formats[MAX_NOF_META_FORMATS];
+  uint32_t nof_formats = 0;
+  for(uint32_t i=0; i<nof_primary_meta_formats; i++) {
+    meta_formats[nof_formats++] = primaryMetaFormats[i];
+  }
+  if(!metaFormats.skipSecondaryMetaFormats() && loadSheddingLevel < LOAD_SHEDDING_SKIP_SECONDARY) {
+    for(uint32_t i=0; i<nof_secondary_meta_formats; i++) {
+      meta_formats[nof_formats++] = secondaryMetaFormats[i];
+    }
+  }
+
+  // locations of the common search space (evergreen RNTIs) and the search spaces of all active RNTIs
+  bool targeted[MAX_CANDIDATES_BLIND] = {false};
+  srslte_dci_location_t loc[TARGETED_SEARCH_MAX_LOCATIONS];
+  auto addTargets = [&](uint32_t n) {
+    for(uint32_t i=0; i<n; i++) {
+      if(loc[i].ncce < MAX_NUM_OF_CCE && cce_map[loc[i].ncce].location[loc[i].L]) {
+        targeted[static_cast<uint32_t>(cce_map[loc[i].ncce].location[loc[i].L] - locations)] = true;
+      }
+    }
+  };
+  addTargets(srslte_pdcch_common_locations_ncce(nof_cce, loc, TARGETED_SEARCH_MAX_LOCATIONS));
+  rntiManager.forEachActive([&](const rnti_manager_active_set_t& entry) {
+    if(entry.rnti >= SRSLTE_CRNTI_START && entry.rnti <= SRSLTE_CRNTI_END) {
+      addTargets(srslte_pdcch_ue_locations_ncce(nof_cce, loc, TARGETED_SEARCH_MAX_LOCATIONS, sf_idx, entry.rnti));
+    }
+  });
+
+  for(uint32_t location_idx=0; location_idx < nof_locations; location_idx++) {
+    falcon_dci_location_t* location = &locations[location_idx];
+    if(!targeted[location_idx] ||
+       location->occupied ||
+       !location->sufficient_power ||
+       (enforceOccupancyGate && location->occupancy < occupancyThreshold)) {
+      continue;
+    }
+    dci_candidate_t* cand = ctx.candidates.alloc(nof_formats);
+    uint32_t nof_misses = ctx.stats.nof_decode_cache_misses;
+    decode_location(ctx, cfi, location, location_idx, meta_formats, nof_formats, cand);
+    ctx.stats.nof_targeted_decodes += ctx.stats.nof_decode_cache_misses - nof_misses;
+
+    // accept only RNTIs known up front at exact positions; the rest is left to the blind search
+    int match_idx = -1;
+    uint32_t match_freq = 0;
+    for(uint32_t format_idx=0; format_idx<nof_formats; format_idx++) {
+      uint16_t rnti = cand[format_idx].rnti;
+      uint32_t global_index = meta_formats[format_idx]->global_index;
+      uint32_t flags = formatFlags[global_index];
+      if(rnti == FALCON_ILLEGAL_RNTI ||
+         ((flags & DCI_FORMAT_FLAG_0_1A) && meta_formats[format_idx]->format != cand[format_idx].dci_msg.format) ||
+         ((flags & DCI_FORMAT_FLAG_COMMON_ONLY) && rnti > SRSLTE_RARNTI_END && rnti < SRSLTE_PRNTI) ||
+         (rnti > SRSLTE_RARNTI_START && rnti < SRSLTE_RARNTI_END && !(flags & DCI_FORMAT_FLAG_RA_RNTI))) {
+        continue;
+      }
+      if(rntiManager.getActivationReason(rnti) == RM_ACT_UNSET && !rntiManager.isEvergreen(rnti, global_index)) {
+        continue;
+      }
+      cand[format_idx].search_space_match_result = falcon_search_space_cache_validate_location(&ctx.searchSpace, nof_cce, location->ncce, location->L, sf_idx, rnti);
+      if(cand[format_idx].search_space_match_result != SEARCH_SPACE_MATCH_RESULT_EXACT ||
+         !rntiManager.validateAndRefresh(rnti, global_index)) {
+        continue;
+      }
+      uint32_t freq = rntiManager.getFrequency(rnti, global_index);
+      if(match_idx < 0 || freq > match_freq) {
+        match_idx = static_cast<int>(format_idx);
+        match_freq = freq;
+      }
+    }
+
+    if(match_idx >= 0) {
+      accept_candidate(ctx, cce_map, location, cand[match_idx], meta_formats[match_idx], match_freq);
+      ctx.stats.nof_targeted_dci++;
+    }
+    ctx.candidates.release(cand);
+  }
+  return accept_results(ctx.found, ctx.ra_rnti);
+}
+
+void DCISearch::inspect_block(DCISearchContext& ctx,
+                              srslte_dci_msg_t *dci_msg,
+                              uint32_t cfi,
+                              falcon_cce_to_dci_location_map_t *cce_map,
+                              falcon_dci_location_t *locations,
+                              uint32_t nof_locations,
+                              uint32_t block_idx,
+                              falcon_dci_meta_format_t **meta_formats,
+                              uint32_t nof_formats)
+{
+  uint32_t max_depth = maxRecursionDepth;
+  if(loadSheddingLevel >= LOAD_SHEDDING_LIMIT_DEPTH) {
+    max_depth = MIN(max_depth, LOAD_SHEDDING_LIMITED_DEPTH);
+  }
+  uint32_t enable_discovery = loadSheddingLevel >= LOAD_SHEDDING_ACTIVE_SET_ONLY ? 0 : 1;
+
+  // inspect all locations of this block recursively, ordered by aggregation level
+  for(unsigned int location_idx=0; location_idx < nof_locations; location_idx++) {
+    if(block_idx != ALL_CCE_BLOCKS &&
+       locations[location_idx].ncce / DCI_SEARCH_CCE_BLOCK_SIZE != block_idx) {
+      continue;
+    }
+    if(max_depth > 0) {
+      inspect_dci_location_recursively<true>(ctx, dci_msg, cfi, cce_map, locations,
+                                             locations[location_idx].ncce, locations[location_idx].L,
+                                             max_depth, 0, meta_formats, nof_formats, enable_discovery, nullptr);
+    }
+    else {
+      inspect_dci_location_recursively<false>(ctx, dci_msg, cfi, cce_map, locations,
+                                              locations[location_idx].ncce, locations[location_idx].L,
+                                              0, 0, meta_formats, nof_formats, enable_discovery, nullptr);
+    }
+  }
+}
+
+int DCISearch::inspect_locations(srslte_dci_msg_t *dci_msg,
+                                 uint32_t cfi,
+                                 falcon_cce_to_dci_location_map_t *cce_map,
+                                 falcon_dci_location_t *locations,
+                                 uint32_t nof_locations,
+                                 falcon_dci_meta_format_t **meta_formats,
+                                 uint32_t nof_formats)
+{
+  int ret = 0;
+
+  if(searchPool.getNofThreads() <= 1) {
+    // sequential search in the original order of locations
+    DCISearchContext& ctx = searchPool.getContext(0);
+    ctx.found.clear();
+    ctx.ra_rnti = 0xffff;
+    inspect_block(ctx, dci_msg, cfi, cce_map, locations, nof_locations, ALL_CCE_BLOCKS, meta_formats, nof_formats);
+    ret += accept_results(ctx.found, ctx.ra_rnti);
+    return ret;
+  }
+
+  // parallel search: each block is searched by one thread, results are merged in block order
+  uint32_t nof_blocks = (srslte_pdcch_nof_cce(&ue_dl.pdcch, cfi) + DCI_SEARCH_CCE_BLOCK_SIZE - 1) / DCI_SEARCH_CCE_BLOCK_SIZE;
+  if(nof_blocks > MAX_NOF_CCE_BLOCKS) {
+    nof_blocks = MAX_NOF_CCE_BLOCKS;
+  }
+  searchPool.run(nof_blocks, [&](DCISearchContext& ctx, uint32_t block_idx) {
+    ctx.found.clear();
+    ctx.ra_rnti = 0xffff;
+    inspect_block(ctx, dci_msg, cfi, cce_map, locations, nof_locations, block_idx, meta_formats, nof_formats);
+    // hand the results to the block, take its (empty) buffer in exchange
+    DCISearchBlockResult& block = searchPool.getBlockResult(block_idx);
+    block.found.clear();
+    block.found.swap(ctx.found);
+    block.ra_rnti = ctx.ra_rnti;
+  });
+  for(uint32_t block_idx=0; block_idx < nof_blocks; block_idx++) {
+    DCISearchBlockResult& block = searchPool.getBlockResult(block_idx);
+    ret += accept_results(block.found, block.ra_rnti);
+  }
+  return ret;
+}
+
+int DCISearch::accept_results(const std::vector<DCISearchResult>& found, uint16_t ra_rnti) {
+  for(const DCISearchResult& result : found) {
+    dci_candidate_t cand = result.cand;
+    dciCollection.addCandidate(cand, result.location, result.histval);
+    if(hintTable != nullptr && cand.rnti >= SRSLTE_CRNTI_START && cand.rnti <= SRSLTE_CRNTI_END) {
+      hintTable->add(10*sfn + sf_idx, cand.rnti, cand.dci_msg.format, result.location.L);
+    }
+  }
+  if(ra_rnti != 0xffff) {
+    ue_dl.current_rnti = ra_rnti;
+  }
+  return static_cast<int>(found.size());
+}
+
 int DCISearch::recursive_blind_dci_search(srslte_dci_msg_t *dci_msg,
                                           uint32_t cfi)
 {
@@ -400,27 +664,45 @@ int DCISearch::recursive_blind_dci_search(srslte_dci_msg_t *dci_msg,
   nof_locations = srslte_pdcch_ue_locations_all_map(&ue_dl.pdcch, locations, MAX_CANDIDATES_BLIND, cce_map, MAX_NUM_OF_CCE, sf_idx, cfi);
   stats.nof_locations +=nof_locations;
 
+  /* Decoded candidates of the previous subframe are not valid anymore */
+  decodeCache.clear();
+
   /* Calculate power levels on each cce*/
   srslte_pdcch_cce_avg_llr_power(&ue_dl.pdcch, cfi, cce_map, MAX_NUM_OF_CCE);
 
+  /* Estimate the occupancy of each location; audit subframes are searched without the gate */
+  bool auditOccupancyGate = false;
+  enforceOccupancyGate = false;
+  if(occupancyGate != nullptr && (occupancyThreshold > 0 || occupancyTrace != nullptr)) {
+    falcon_occupancy_gate_apply(occupancyGate, locations, nof_locations);
+    if(occupancyThreshold > 0) {
+      auditOccupancyGate = (10*sfn + sf_idx) % OCCUPANCY_GATE_AUDIT_INTERVAL == 0;
+      enforceOccupancyGate = !auditOccupancyGate;
+    }
+  }
+  if(enforceOccupancyGate) {
+    for(uint32_t i=0; i<nof_locations; i++) {
+      if(locations[i].sufficient_power && locations[i].occupancy < occupancyThreshold) {
+        stats.nof_gated_locations++;
+      }
+    }
+  }
+
   ue_dl.current_rnti = 0xffff;
 
-  // Check primary DCI formats (the most frequent)
+  // Predicted DCI first (HARQ timing of earlier subframes)
+  if(hintTable != nullptr) {
+    ret += hinted_dci_search(cfi, cce_map, locations);
+  }
 
-  // inspect all locations at this aggregation level recursively
-  for(unsigned int location_idx=0; location_idx < nof_locations; location_idx++) {
-    ret += inspect_dci_location_recursively(dci_msg,
-                                            cfi,
-                                            cce_map,
-                                            locations,
-                                            locations[location_idx].ncce,
-                                            locations[location_idx].L,
-                                            MAX_RECURSION_DEPTH,
-                                            metaFormats.getPrimaryMetaFormats(),
-                                            metaFormats.getNofPrimaryMetaFormats(),
-                                            1,
-                                            nullptr);
+  // Phase one: decode the search spaces of known RNTIs; found DCI occupy their CCEs for the blind search
+  if(enableTargetedSearch) {
+    ret += targeted_dci_search(cfi, cce_map, locations, nof_locations);
   }
+  int nof_blind = 0;
+
+  // Check primary DCI formats (the most frequent)
+  nof_blind += inspect_locations(dci_msg, cfi, cce_map, locations, nof_locations, primaryMetaFormats, nof_primary_meta_formats);
 
   uint32_t primary_missed = srslte_pdcch_nof_missed_cce(&ue_dl.pdcch, cfi, cce_map, MAX_NUM_OF_CCE);
   if(primary_missed > 0) {
@@ -428,24 +710,14 @@ int DCISearch::recursive_blind_dci_search(srslte_dci_msg_t *dci_msg,
   }
 
   // Check secondary DCI formats (remaining)
-  if(!metaFormats.skipSecondaryMetaFormats()) {
+  if(!metaFormats.skipSecondaryMetaFormats() && loadSheddingLevel < LOAD_SHEDDING_SKIP_SECONDARY) {
     // Reset the checked flag for all locations
     srslte_pdcch_uncheck_ue_locations(locations, nof_locations);
 
-    for(unsigned int location_idx=0; location_idx < nof_locations; location_idx++) {
-      ret += inspect_dci_location_recursively(dci_msg,
-                                              cfi,
-                                              cce_map,
-                                              locations,
-                                              locations[location_idx].ncce,
-                                              locations[location_idx].L,
-                                              MAX_RECURSION_DEPTH,
-                                              metaFormats.getSecondaryMetaFormats(),
-                                              metaFormats.getNofSecondaryMetaFormats(),
-                                              1,
-                                              nullptr);
-    }
+    nof_blind += inspect_locations(dci_msg, cfi, cce_map, locations, nof_locations, secondaryMetaFormats, nof_secondary_meta_formats);
   }
+  stats.nof_blind_dci += static_cast<uint32_t>(nof_blind);
+  ret += nof_blind;
 
   if(dciCollection.hasCollisionDL()) {
     stats.nof_subframe_collisions_dw++;
@@ -460,7 +732,21 @@ int DCISearch::recursive_blind_dci_search(srslte_dci_msg_t *dci_msg,
     INFO("Missed CCEs in SFN %d.%d: %d\n", sfn, sf_idx, missed);
   }
   stats.nof_missed_cce += missed;
-  rntiManager.stepTime();
+
+  if(auditOccupancyGate) {
+    for(uint32_t i=0; i<nof_locations; i++) {
+      if(locations[i].used) {
+        stats.nof_gate_audit_dci++;
+        if(locations[i].occupancy < occupancyThreshold) {
+          stats.nof_gate_audit_misses++;
+        }
+      }
+    }
+  }
+  // labels of gated locations are unknown, so only complete searches are recorded
+  if(occupancyTrace != nullptr && !enforceOccupancyGate) {
+    occupancyTrace->write(sfn, sf_idx, cfi, locations, nof_locations);
+  }
 
   return ret;
 }
@@ -468,20 +754,45 @@ int DCISearch::recursive_blind_dci_search(srslte_dci_msg_t *dci_msg,
 DCISearch::DCISearch(srslte_ue_dl_t& ue_dl,
                      const DCIMetaFormats& metaFormats,
                      RNTIManager& rntiManager,
+                     DCISearchPool& searchPool,
                      SubframeInfo& subframeInfo,
                      uint32_t sf_idx,
                      uint32_t sfn) :
   ue_dl(ue_dl),
   metaFormats(metaFormats),
+  nof_primary_meta_formats(0),
+  nof_secondary_meta_formats(0),
   rntiManager(rntiManager),
+  searchPool(searchPool),
+  decodeCache(searchPool.getDecodeCache()),
   dciCollection(subframeInfo.getDCICollection()),
   subframePower(subframeInfo.getSubframePower()),
+  subframeInfo(subframeInfo),
   sf_idx(sf_idx),
   sfn(sfn),
   stats(),
-  enableShortcutDiscovery(true)
+  enableShortcutDiscovery(true),
+  loadSheddingLevel(LOAD_SHEDDING_NONE),
+  maxRecursionDepth(DEFAULT_MAX_RECURSION_DEPTH),
+  disambiguationDepth(DEFAULT_DCI_DISAMBIGUATION_DEPTH),
+  listViterbiSize(DEFAULT_LIST_VITERBI_SIZE),
+  viterbiMinReliability(DEFAULT_VITERBI_MIN_RELIABILITY),
+  occupancyGate(nullptr),
+  occupancyThreshold(DEFAULT_OCCUPANCY_THRESHOLD),
+  enforceOccupancyGate(false),
+  occupancyTrace(nullptr),
+  enableTargetedSearch(DEFAULT_TARGETED_DCI_SEARCH),
+  hintTable(nullptr)
 {
-
+  // other workers may update the format split while this subframe is searched
+  metaFormats.copySplit(primaryMetaFormats, &nof_primary_meta_formats,
+                        secondaryMetaFormats, &nof_secondary_meta_formats);
+  // per-format constants of this cell, indexed by global format index
+  const DCIFormatSet& formatSet = metaFormats.getFormatSet();
+  for(uint32_t i=0; i<formatSet.getNofFormats() && i<MAX_NOF_META_FORMATS; i++) {
+    formatFlags[i] = formatSet.getFlags(i);
+    formatNofBits[i] = srslte_dci_format_sizeof(formatSet.getFormat(i), ue_dl.pdcch.cell.nof_prb, ue_dl.pdcch.cell.nof_ports);
+  }
 }
 
 int DCISearch::search() {
@@ -509,8 +820,32 @@ int DCISearch::search() {
     }
   }
 
+  // decoder options apply to all search threads of this subframe
+  for(uint32_t i=0; i<searchPool.getNofThreads(); i++) {
+    falcon_pdcch_decoder_t* decoder = &searchPool.getContext(i).decoder;
+    falcon_pdcch_decoder_set_list_viterbi(decoder, listViterbiSize, viterbiMinReliability);
+    falcon_pdcch_decoder_set_rnti_filter(decoder, listViterbiSize > 1 ? &DCISearch::isKnownRNTI : nullptr, &rntiManager);
+  }
+
   ret = recursive_blind_dci_search(&dci_msg, cfi);
+
+  // candidates of all search threads enter the histograms at once
+  RNTICandidateDelta& rntiCandidates = searchPool.getContext(0).rntiCandidates;
+  for(uint32_t i=1; i<searchPool.getNofThreads(); i++) {
+    rntiCandidates.append(searchPool.getContext(i).rntiCandidates);
+  }
+  rntiManager.commitSubframe(10*sfn + sf_idx, rntiCandidates);
+
+  for(uint32_t i=0; i<searchPool.getNofThreads(); i++) {
+    DCISearchContext& ctx = searchPool.getContext(i);
+    ctx.stats.nof_candidate_heap_allocs += ctx.candidates.getNofHeapAllocations();
+    stats += ctx.stats;
+    ctx.reset();
+  }
   stats.nof_subframes++;
+  if(loadSheddingLevel > LOAD_SHEDDING_NONE) {
+    stats.nof_subframes_shed++;
+  }
 
   return ret;
 }
@@ -526,3 +861,40 @@ void DCISearch::setShortcutDiscovery(bool enable) {
 bool DCISearch::getShortcutDiscovery() const {
   return enableShortcutDiscovery;
 }
+
+void DCISearch::setLoadSheddingLevel(LoadSheddingLevel level) {
+  loadSheddingLevel = level;
+  subframeInfo.setLoadSheddingLevel(level);
+}
+
+void DCISearch::setSearchDepth(uint32_t maxRecursionDepth, uint32_t disambiguationDepth) {
+  this->maxRecursionDepth = maxRecursionDepth;
+  this->disambiguationDepth = disambiguationDepth;
+}
+
+void DCISearch::setListViterbi(uint32_t listSize, float minReliability) {
+  listViterbiSize = listSize;
+  viterbiMinReliability = minReliability;
+}
+
+void DCISearch::setOccupancyGate(const falcon_occupancy_gate_t* gate, float threshold) {
+  occupancyGate = gate;
+  occupancyThreshold = threshold;
+}
+
+void DCISearch::setOccupancyTrace(OccupancyTrace* trace) {
+  occupancyTrace = trace;
+}
+
+void DCISearch::setTargetedSearch(bool enable) {
+  enableTargetedSearch = enable;
+}
+
+void DCISearch::setHintTable(DCIHintTable* table) {
+  hintTable = table;
+}
+
+int DCISearch::isKnownRNTI(void* rntiManager, uint16_t rnti) {
+  // cheap: a single state lookup, no histogram access
+  return static_cast<RNTIManager*>(rntiManager)->getActivationReason(rnti) != RM_ACT_UNSET;
+}
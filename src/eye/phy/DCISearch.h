@@ -4,12 +4,23 @@
 #include "SubframeInfo.h"
 #include "PhyCommon.h"
 #include "MetaFormats.h"
+#include "DCISearchPool.h"
+#include "DCIHintTable.h"
+
+#include <vector>
+
+#define ALL_CCE_BLOCKS 0xffffffff
+// every n-th subframe is searched without the occupancy gate to count the DCI it would miss
+#define OCCUPANCY_GATE_AUDIT_INTERVAL 100
+// UE-specific and common search space (36.213 Table 9.1.1-1)
+#define TARGETED_SEARCH_MAX_LOCATIONS (16+6)
 
 class DCISearch {
 public:
     DCISearch(srslte_ue_dl_t& ue_dl,
               const DCIMetaFormats& metaFormats,
               RNTIManager& rntiManager,
+              DCISearchPool& searchPool,
               SubframeInfo& subframeInfo,
               uint32_t sf_idx,
               uint32_t sfn);
@@ -19,28 +30,100 @@ public:
 
     void setShortcutDiscovery(bool enable);
     bool getShortcutDiscovery() const;
+    void setLoadSheddingLevel(LoadSheddingLevel level);
+    void setSearchDepth(uint32_t maxRecursionDepth, uint32_t disambiguationDepth);
+    void setListViterbi(uint32_t listSize, float minReliability);
+    void setOccupancyGate(const falcon_occupancy_gate_t* gate, float threshold);
+    void setOccupancyTrace(OccupancyTrace* trace);
+    // decode the search spaces of active and evergreen RNTIs before the blind search
+    void setTargetedSearch(bool enable);
+    // decode the DCI predicted by earlier subframes first and record predictions (nullptr: disabled)
+    void setHintTable(DCIHintTable* table);
 private:
-    int inspect_dci_location_recursively(srslte_dci_msg_t *dci_msg,
+    static int isKnownRNTI(void* rntiManager, uint16_t rnti);
+    static void mark_occupied(falcon_cce_to_dci_location_map_t *cce_map, uint32_t ncce, uint32_t L);
+    // returns the number of decoder runs
+    uint32_t decode_location(DCISearchContext& ctx,
+                             uint32_t cfi,
+                             falcon_dci_location_t *location,
+                             uint32_t location_idx,
+                             falcon_dci_meta_format_t **meta_formats,
+                             uint32_t nof_formats,
+                             dci_candidate_t cand[]);
+    template <bool recursive>
+    int inspect_dci_location_recursively(DCISearchContext& ctx,
+                                         srslte_dci_msg_t *dci_msg,
                                          uint32_t cfi,
                                          falcon_cce_to_dci_location_map_t *cce_map,
                                          falcon_dci_location_t *location_list,
                                          uint32_t ncce,
                                          uint32_t L,
                                          uint32_t max_depth,
+                                         uint32_t depth,
                                          falcon_dci_meta_format_t **meta_formats,
                                          uint32_t nof_formats,
                                          uint32_t enable_discovery,
                                          const dci_candidate_t parent_cand[]);
+    void inspect_block(DCISearchContext& ctx,
+                       srslte_dci_msg_t *dci_msg,
+                       uint32_t cfi,
+                       falcon_cce_to_dci_location_map_t *cce_map,
+                       falcon_dci_location_t *locations,
+                       uint32_t nof_locations,
+                       uint32_t block_idx,
+                       falcon_dci_meta_format_t **meta_formats,
+                       uint32_t nof_formats);
+    int inspect_locations(srslte_dci_msg_t *dci_msg,
+                          uint32_t cfi,
+                          falcon_cce_to_dci_location_map_t *cce_map,
+                          falcon_dci_location_t *locations,
+                          uint32_t nof_locations,
+                          falcon_dci_meta_format_t **meta_formats,
+                          uint32_t nof_formats);
+    void accept_candidate(DCISearchContext& ctx,
+                          falcon_cce_to_dci_location_map_t *cce_map,
+                          falcon_dci_location_t *location,
+                          const dci_candidate_t& cand,
+                          falcon_dci_meta_format_t *meta_format,
+                          uint32_t histval);
+    int hinted_dci_search(uint32_t cfi,
+                          falcon_cce_to_dci_location_map_t *cce_map,
+                          falcon_dci_location_t *locations);
+    int targeted_dci_search(uint32_t cfi,
+                            falcon_cce_to_dci_location_map_t *cce_map,
+                            falcon_dci_location_t *locations,
+                            uint32_t nof_locations);
+    int accept_results(const std::vector<DCISearchResult>& found, uint16_t ra_rnti);
     int recursive_blind_dci_search(srslte_dci_msg_t *dci_msg,
                                    uint32_t cfi);
     //falcon_ue_dl_t& q;
     srslte_ue_dl_t& ue_dl;
     const DCIMetaFormats& metaFormats;
+    falcon_dci_meta_format_t* primaryMetaFormats[MAX_NOF_META_FORMATS];
+    falcon_dci_meta_format_t* secondaryMetaFormats[MAX_NOF_META_FORMATS];
+    uint32_t nof_primary_meta_formats;
+    uint32_t nof_secondary_meta_formats;
+    uint32_t formatFlags[MAX_NOF_META_FORMATS];     // DCI_FORMAT_FLAG_*
+    uint32_t formatNofBits[MAX_NOF_META_FORMATS];   // payload size
     RNTIManager& rntiManager;
+    DCISearchPool& searchPool;
+    DCIDecodeCache& decodeCache;
     DCICollection& dciCollection;
     SubframePower& subframePower;
+    SubframeInfo& subframeInfo;
     uint32_t sf_idx;
     uint32_t sfn;
     DCIBlindSearchStats stats;
     bool enableShortcutDiscovery;
+    LoadSheddingLevel loadSheddingLevel;
+    uint32_t maxRecursionDepth;
+    uint32_t disambiguationDepth;
+    uint32_t listViterbiSize;
+    float viterbiMinReliability;
+    const falcon_occupancy_gate_t* occupancyGate;
+    float occupancyThreshold;
+    bool enforceOccupancyGate;
+    OccupancyTrace* occupancyTrace;
+    bool enableTargetedSearch;
+    DCIHintTable* hintTable;
 };
@@ -0,0 +1,152 @@
+#include "DCISearchPool.h"
+
+#include "srslte/phy/utils/debug.h"
+
+DCISearchContext::DCISearchContext() :
+  candidates(),
+  rntiCandidates(),
+  stats(),
+  found(),
+  ra_rnti(0xffff)
+{
+  if(falcon_pdcch_decoder_init(&decoder)) {
+    ERROR("Error initializing PDCCH decoder\n");
+  }
+  if(falcon_search_space_cache_init(&searchSpace)) {
+    ERROR("Error initializing search space cache\n");
+  }
+}
+
+DCISearchContext::~DCISearchContext() {
+  falcon_search_space_cache_free(&searchSpace);
+  falcon_pdcch_decoder_free(&decoder);
+}
+
+void DCISearchContext::reset() {
+  stats = DCIBlindSearchStats();
+  candidates.resetNofHeapAllocations();
+  rntiCandidates.clear();
+  found.clear();
+  ra_rnti = 0xffff;
+}
+
+DCISearchPool::Helper::Helper(DCISearchPool& pool, uint32_t idx) :
+  pool(pool),
+  idx(idx)
+{
+
+}
+
+DCISearchPool::Helper::~Helper() {
+
+}
+
+void DCISearchPool::Helper::run_thread() {
+  pool.helperLoop(idx);
+}
+
+DCISearchPool::DCISearchPool(uint32_t nof_threads) :
+  contexts(),
+  helpers(),
+  decodeCache(),
+  task(nullptr),
+  nof_blocks(0),
+  next_block(0),
+  nof_busy(0),
+  generation(0),
+  canceled(false)
+{
+  if(nof_threads < 1) {
+    nof_threads = 1;
+  }
+  for(uint32_t i=0; i<nof_threads; i++) {
+    contexts.push_back(std::unique_ptr<DCISearchContext>(new DCISearchContext()));
+  }
+  // context 0 belongs to the calling thread
+  for(uint32_t i=1; i<nof_threads; i++) {
+    std::unique_ptr<Helper> helper(new Helper(*this, i));
+    helper->start();
+    helpers.push_back(std::move(helper));
+  }
+}
+
+DCISearchPool::~DCISearchPool() {
+  {
+    std::lock_guard<std::mutex> lock(m);
+    canceled = true;
+    start.notify_all();
+  }
+  for(auto& helper : helpers) {
+    helper->wait_thread_finish();
+  }
+}
+
+uint32_t DCISearchPool::getNofThreads() const {
+  return static_cast<uint32_t>(contexts.size());
+}
+
+DCISearchContext& DCISearchPool::getContext(uint32_t idx) {
+  return *contexts[idx];
+}
+
+DCIDecodeCache& DCISearchPool::getDecodeCache() {
+  return decodeCache;
+}
+
+DCISearchBlockResult& DCISearchPool::getBlockResult(uint32_t block_idx) {
+  return blockResults[block_idx];
+}
+
+void DCISearchPool::run(uint32_t nof_blocks, const Task& task) {
+  if(nof_blocks == 0) {
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> lock(m);
+    this->task = &task;
+    this->nof_blocks = nof_blocks;
+    next_block = 0;
+    nof_busy = static_cast<uint32_t>(helpers.size());
+    generation++;
+    start.notify_all();
+  }
+
+  work(0);
+
+  std::unique_lock<std::mutex> lock(m);
+  while(nof_busy > 0) {
+    done.wait(lock);
+  }
+  this->task = nullptr;
+}
+
+void DCISearchPool::helperLoop(uint32_t idx) {
+  uint64_t seen = 0;
+  std::unique_lock<std::mutex> lock(m);
+  while(true) {
+    while(generation == seen && !canceled) {
+      start.wait(lock);
+    }
+    if(canceled) {
+      break;
+    }
+    seen = generation;
+
+    lock.unlock();
+    work(idx);
+    lock.lock();
+
+    nof_busy--;
+    if(nof_busy == 0) {
+      done.notify_one();
+    }
+  }
+}
+
+void DCISearchPool::work(uint32_t idx) {
+  DCISearchContext& ctx = *contexts[idx];
+  uint32_t block_idx;
+  while((block_idx = next_block.fetch_add(1)) < nof_blocks) {
+    (*task)(ctx, block_idx);
+  }
+}
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <stdint.h>
+#include <vector>
+#include <memory>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+
+#include "PhyCommon.h"
+#include "DCIDecodeCache.h"
+#include "DCICandidateArena.h"
+
+#include "falcon/phy/falcon_phch/falcon_pdcch.h"
+#include "falcon/phy/falcon_ue/falcon_ue_dl.h"
+
+#include "srslte/common/threads.h"
+
+// CCEs are distributed to the search threads in blocks of the largest aggregation level.
+// Locations of different blocks never overlap, so blocks can be searched independently.
+#define DCI_SEARCH_CCE_BLOCK_SIZE 8
+#define MAX_NOF_CCE_BLOCKS ((MAX_NUM_OF_CCE + DCI_SEARCH_CCE_BLOCK_SIZE - 1) / DCI_SEARCH_CCE_BLOCK_SIZE)
+
+// Accepted DCI candidate, added to the DCICollection after the search
+struct DCISearchResult {
+  dci_candidate_t cand;
+  srslte_dci_location_t location;
+  uint32_t histval;
+};
+
+// Results of one CCE block, merged in block order after the search
+struct DCISearchBlockResult {
+  std::vector<DCISearchResult> found;
+  uint16_t ra_rnti;
+};
+
+// State of a single search thread
+class DCISearchContext {
+public:
+  DCISearchContext();
+  ~DCISearchContext();
+  void reset();
+
+  falcon_pdcch_decoder_t decoder;
+  falcon_search_space_cache_t searchSpace;  // persists across subframes
+  DCICandidateArena candidates;
+  RNTICandidateDelta rntiCandidates;  // histogram input, committed after the search
+  DCIBlindSearchStats stats;
+  std::vector<DCISearchResult> found;
+  uint16_t ra_rnti;
+};
+
+// Small pool of threads that search the CCE blocks of one subframe concurrently.
+// Each SubframeWorker owns a pool, so subframes never compete for the same threads.
+class DCISearchPool {
+public:
+  typedef std::function<void(DCISearchContext& ctx, uint32_t block_idx)> Task;
+
+  DCISearchPool(uint32_t nof_threads);
+  ~DCISearchPool();
+  uint32_t getNofThreads() const;
+  DCISearchContext& getContext(uint32_t idx);
+  DCIDecodeCache& getDecodeCache();
+  DCISearchBlockResult& getBlockResult(uint32_t block_idx);
+
+  // Calls task for each block 0..nof_blocks-1 and returns when all blocks are done.
+  // The calling thread works with context 0, helpers take the remaining blocks as they become idle.
+  void run(uint32_t nof_blocks, const Task& task);
+private:
+  class Helper : public thread {
+  public:
+    Helper(DCISearchPool& pool, uint32_t idx);
+    virtual ~Helper() override;
+  protected:
+    virtual void run_thread() override;
+  private:
+    DCISearchPool& pool;
+    uint32_t idx;
+  };
+
+  void helperLoop(uint32_t idx);
+  void work(uint32_t idx);
+
+  std::vector<std::unique_ptr<DCISearchContext>> contexts;
+  std::vector<std::unique_ptr<Helper>> helpers;
+  DCIDecodeCache decodeCache;
+  DCISearchBlockResult blockResults[MAX_NOF_CCE_BLOCKS];
+  const Task* task;
+  uint32_t nof_blocks;
+  std::atomic<uint32_t> next_block;
+  uint32_t nof_busy;
+  uint64_t generation;
+  bool canceled;
+
+  std::mutex m;
+  std::condition_variable start;  // new run
+  std::condition_variable done;   // helper finished
+};
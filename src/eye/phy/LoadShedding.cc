@@ -0,0 +1,92 @@
+#include "LoadShedding.h"
+
+LoadSheddingPolicy::~LoadSheddingPolicy() {
+
+}
+
+const char* LoadSheddingPolicy::getLevelString(LoadSheddingLevel level) {
+  switch(level) {
+    case LOAD_SHEDDING_NONE:
+      return "none";
+    case LOAD_SHEDDING_SKIP_SECONDARY:
+      return "skip secondary formats";
+    case LOAD_SHEDDING_LIMIT_DEPTH:
+      return "limited depth";
+    case LOAD_SHEDDING_ACTIVE_SET_ONLY:
+      return "active set only";
+    default:
+      return "unknown";
+  }
+}
+
+std::unique_ptr<LoadSheddingPolicy> LoadSheddingPolicy::create(const std::string& name) {
+  if(name == "none") {
+    return std::unique_ptr<LoadSheddingPolicy>(new NoLoadShedding());
+  }
+  if(name == "adaptive") {
+    return std::unique_ptr<LoadSheddingPolicy>(new AdaptiveLoadShedding());
+  }
+  return nullptr;
+}
+
+NoLoadShedding::~NoLoadShedding() {
+
+}
+
+LoadSheddingLevel NoLoadShedding::update(const LoadSheddingInput& load) {
+  (void)load;
+  return LOAD_SHEDDING_NONE;
+}
+
+const char* NoLoadShedding::getName() const {
+  return "none";
+}
+
+AdaptiveLoadShedding::AdaptiveLoadShedding(double highWatermark,
+                                           double lowWatermark,
+                                           double maxUtilization,
+                                           uint32_t holdSubframes) :
+  highWatermark(highWatermark),
+  lowWatermark(lowWatermark),
+  maxUtilization(maxUtilization),
+  holdSubframes(holdSubframes),
+  level(LOAD_SHEDDING_NONE),
+  nof_calm(0),
+  nof_since_change(0)
+{
+
+}
+
+AdaptiveLoadShedding::~AdaptiveLoadShedding() {
+
+}
+
+LoadSheddingLevel AdaptiveLoadShedding::update(const LoadSheddingInput& load) {
+  // backlog ahead of the subframe just handed over; 0 if the workers keep up
+  uint32_t backlog = load.nof_pending > 0 ? load.nof_pending - 1 : 0;
+  double fill = load.nof_buffers > 0 ? static_cast<double>(backlog) / load.nof_buffers : 0;
+  double utilization = load.nof_worker_threads > 0 ? load.decode_time_us / (1000.0 * load.nof_worker_threads) : 0;
+  nof_since_change++;
+
+  if(fill >= highWatermark || utilization >= maxUtilization) {
+    nof_calm = 0;
+    // escalate quickly, but give the previous step a few subframes to take effect
+    if(level + 1 < LOAD_SHEDDING_NOF_LEVELS && nof_since_change >= load.nof_buffers) {
+      level = static_cast<LoadSheddingLevel>(level + 1);
+      nof_since_change = 0;
+    }
+  }
+  else if(fill <= lowWatermark && utilization < maxUtilization) {
+    nof_calm++;
+    if(level > LOAD_SHEDDING_NONE && nof_calm >= holdSubframes) {
+      level = static_cast<LoadSheddingLevel>(level - 1);
+      nof_calm = 0;
+      nof_since_change = 0;
+    }
+  }
+  return level;
+}
+
+const char* AdaptiveLoadShedding::getName() const {
+  return "adaptive";
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <stdint.h>
+#include <string>
+#include <memory>
+
+// Degradation steps, each level includes the savings of the levels below
+typedef enum {
+  LOAD_SHEDDING_NONE = 0,           // full blind search
+  LOAD_SHEDDING_SKIP_SECONDARY,     // skip secondary (less frequent) DCI formats
+  LOAD_SHEDDING_LIMIT_DEPTH,        // limit recursion/disambiguation depth
+  LOAD_SHEDDING_ACTIVE_SET_ONLY,    // no RNTI discovery, accept active RNTIs only
+  LOAD_SHEDDING_NOF_LEVELS
+} LoadSheddingLevel;
+
+#define LOAD_SHEDDING_LIMITED_DEPTH 1
+
+// Load observed by the receiver when a subframe is handed over to the workers
+struct LoadSheddingInput {
+  uint32_t nof_pending;       // subframes waiting for or in processing, including the one handed over
+  uint32_t nof_buffers;       // subframe buffers for the workers (without the one the receiver fills next)
+  uint32_t nof_worker_threads;
+  double decode_time_us;      // recent average processing time per subframe
+};
+
+class LoadSheddingPolicy {
+public:
+  virtual ~LoadSheddingPolicy();
+  // Called once per subframe from the receiver thread; returns the level for this subframe
+  virtual LoadSheddingLevel update(const LoadSheddingInput& load) = 0;
+  virtual const char* getName() const = 0;
+
+  static const char* getLevelString(LoadSheddingLevel level);
+  // "none" or "adaptive"; nullptr for unknown names
+  static std::unique_ptr<LoadSheddingPolicy> create(const std::string& name);
+};
+
+// Always full search; overload leads to skipped subframes
+class NoLoadShedding : public LoadSheddingPolicy {
+public:
+  virtual ~NoLoadShedding() override;
+  virtual LoadSheddingLevel update(const LoadSheddingInput& load) override;
+  virtual const char* getName() const override;
+};
+
+// Raises the level by one step whenever the buffers fill up or the workers
+// fall behind real time, and lowers it by one step after a calm period.
+class AdaptiveLoadShedding : public LoadSheddingPolicy {
+public:
+  AdaptiveLoadShedding(double highWatermark = 0.5,
+                       double lowWatermark = 0.2,
+                       double maxUtilization = 0.9,
+                       uint32_t holdSubframes = 200);
+  virtual ~AdaptiveLoadShedding() override;
+  virtual LoadSheddingLevel update(const LoadSheddingInput& load) override;
+  virtual const char* getName() const override;
+private:
+  double highWatermark;     // fill level of the buffers to escalate
+  double lowWatermark;      // fill level of the buffers to recover
+  double maxUtilization;    // decode time per subframe relative to the time available per worker thread
+  uint32_t holdSubframes;   // calm subframes before lowering the level by one step
+  LoadSheddingLevel level;
+  uint32_t nof_calm;
+  uint32_t nof_since_change;
+};
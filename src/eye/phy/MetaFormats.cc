@@ -4,8 +4,16 @@
 
 #include <iostream>
 
-DCIMetaFormats::DCIMetaFormats(uint32_t nformats, double split_ratio) {
+DCIMetaFormats::DCIMetaFormats(const DCIFormatSet& formatSet, double split_ratio) :
+  formatSet(formatSet),
+  hitCounters(formatSet.getNofFormats())
+{
   // Init formats
+  uint32_t nformats = formatSet.getNofFormats();
+  if(nformats > MAX_NOF_META_FORMATS) {
+    ERROR("Too many DCI formats (%d), limiting to %d\n", nformats, MAX_NOF_META_FORMATS);
+    nformats = MAX_NOF_META_FORMATS;
+  }
   nof_all_meta_formats = nformats;
   nof_primary_meta_formats = 0;
   nof_secondary_meta_formats = 0;
@@ -14,7 +22,7 @@ DCIMetaFormats::DCIMetaFormats(uint32_t nformats, double split_ratio) {
   primary_meta_formats = static_cast<falcon_dci_meta_format_t**>(calloc(nof_all_meta_formats, sizeof(falcon_dci_meta_format_t*)));
   secondary_meta_formats = static_cast<falcon_dci_meta_format_t**>(calloc(nof_all_meta_formats, sizeof(falcon_dci_meta_format_t*)));
   for(uint32_t i=0; i<nof_all_meta_formats; i++) {
-    all_meta_formats[i].format = falcon_ue_all_formats[i];
+    all_meta_formats[i].format = formatSet.getFormat(i);
     all_meta_formats[i].global_index = i;
     all_meta_formats[i].hits = 0;
   }
@@ -34,15 +42,21 @@ DCIMetaFormats::~DCIMetaFormats() {
   secondary_meta_formats = nullptr;
 }
 
+const DCIFormatSet& DCIMetaFormats::getFormatSet() const {
+  return formatSet;
+}
+
 void DCIMetaFormats::setSplitRatio(double split_ratio) {
   this->split_ratio = split_ratio;
 }
 
 void DCIMetaFormats::update_formats() {
+  std::lock_guard<std::mutex> lock(splitMutex);
   falcon_dci_meta_format_t** sorted = static_cast<falcon_dci_meta_format_t**>(calloc(nof_all_meta_formats, sizeof(falcon_dci_meta_format_t*)));
   double total_hits = 0;
   // init and count
   for(uint32_t i=0; i<nof_all_meta_formats; i++) {
+    all_meta_formats[i].hits = hitCounters[i].exchange(0, std::memory_order_relaxed);
     sorted[i] = &all_meta_formats[i];
     total_hits += sorted[i]->hits;
   }
@@ -104,6 +118,23 @@ uint32_t DCIMetaFormats::getNofSecondaryMetaFormats() const {
   return nof_secondary_meta_formats;
 }
 
+void DCIMetaFormats::copySplit(falcon_dci_meta_format_t** primary, uint32_t* nof_primary,
+                               falcon_dci_meta_format_t** secondary, uint32_t* nof_secondary) const {
+  std::lock_guard<std::mutex> lock(splitMutex);
+  for(uint32_t i=0; i<nof_primary_meta_formats; i++) {
+    primary[i] = primary_meta_formats[i];
+  }
+  for(uint32_t i=0; i<nof_secondary_meta_formats; i++) {
+    secondary[i] = secondary_meta_formats[i];
+  }
+  *nof_primary = nof_primary_meta_formats;
+  *nof_secondary = nof_secondary_meta_formats;
+}
+
+void DCIMetaFormats::countHit(const falcon_dci_meta_format_t* format) const {
+  hitCounters[format->global_index].fetch_add(1, std::memory_order_relaxed);
+}
+
 void DCIMetaFormats::setSkipSecondaryMetaFormats(bool skip) {
   skip_secondary_meta_formats = skip;
 }
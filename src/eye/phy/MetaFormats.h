@@ -1,26 +1,35 @@
 #pragma once
 
 #include <stdint.h>
+#include <vector>
+#include <atomic>
+#include <mutex>
 #include "falcon/phy/falcon_phch/falcon_dci.h"
+#include "DCIFormatSet.h"
 
-extern const srslte_dci_format_t falcon_ue_all_formats[];
-extern const uint32_t nof_falcon_ue_all_formats;
+#define MAX_NOF_META_FORMATS 16
 
 class DCIMetaFormats {
 public:
-    DCIMetaFormats(uint32_t nformats, double split_ratio = 1.0);
+    DCIMetaFormats(const DCIFormatSet& formatSet, double split_ratio = 1.0);
     ~DCIMetaFormats();
+    const DCIFormatSet& getFormatSet() const;
     void setSplitRatio(double split_ratio);
     void update_formats();
     falcon_dci_meta_format_t** getPrimaryMetaFormats() const;
     falcon_dci_meta_format_t** getSecondaryMetaFormats() const;
     uint32_t getNofPrimaryMetaFormats() const;
     uint32_t getNofSecondaryMetaFormats() const;
+    // consistent copy of the current split, safe against concurrent update_formats()
+    void copySplit(falcon_dci_meta_format_t** primary, uint32_t* nof_primary,
+                   falcon_dci_meta_format_t** secondary, uint32_t* nof_secondary) const;
+    void countHit(const falcon_dci_meta_format_t* format) const;
     void setSkipSecondaryMetaFormats(bool skip);
     bool skipSecondaryMetaFormats() const;
     void printPrimaryMetaFormats() const;
     void printSecondaryMetaFormats() const;
 private:
+    const DCIFormatSet& formatSet;
     falcon_dci_meta_format_t* all_meta_formats;
     falcon_dci_meta_format_t** primary_meta_formats;
     falcon_dci_meta_format_t** secondary_meta_formats;
@@ -30,5 +39,7 @@ private:
     uint32_t nof_secondary_meta_formats;
     bool skip_secondary_meta_formats;
     double split_ratio;
+    mutable std::vector<std::atomic<uint32_t> > hitCounters;
+    mutable std::mutex splitMutex;
     void printMetaFormatList(falcon_dci_meta_format_t** formats, uint32_t nof_formats) const;
 };
@@ -0,0 +1,51 @@
+#include "OccupancyTrace.h"
+
+OccupancyTrace::OccupancyTrace() :
+  file(nullptr)
+{
+
+}
+
+OccupancyTrace::~OccupancyTrace() {
+  close();
+}
+
+bool OccupancyTrace::open(const std::string& filename) {
+  std::lock_guard<std::mutex> lock(m);
+  if(file != nullptr) {
+    fclose(file);
+  }
+  file = fopen(filename.c_str(), "w");
+  if(file == nullptr) {
+    return false;
+  }
+  fprintf(file, "sfn, sf_idx, cfi, ncce, l, power, spread, relative_power, occupancy, label\n");
+  return true;
+}
+
+bool OccupancyTrace::isOpen() const {
+  return file != nullptr;
+}
+
+void OccupancyTrace::write(uint32_t sfn, uint32_t sf_idx, uint32_t cfi, const falcon_dci_location_t* locations, uint32_t nof_locations) {
+  std::lock_guard<std::mutex> lock(m);
+  if(file == nullptr) {
+    return;
+  }
+  for(uint32_t i=0; i<nof_locations; i++) {
+    const falcon_dci_location_t& l = locations[i];
+    if(!l.sufficient_power) {
+      continue;
+    }
+    fprintf(file, "%d, %d, %d, %d, %d, %f, %f, %f, %f, %d\n",
+            sfn, sf_idx, cfi, l.ncce, l.L, l.power, l.spread, l.relative_power, l.occupancy, l.used ? 1 : 0);
+  }
+}
+
+void OccupancyTrace::close() {
+  std::lock_guard<std::mutex> lock(m);
+  if(file != nullptr) {
+    fclose(file);
+    file = nullptr;
+  }
+}
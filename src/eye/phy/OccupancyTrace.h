@@ -0,0 +1,28 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string>
+#include <mutex>
+
+#include "falcon/phy/falcon_phch/falcon_dci.h"
+
+// Text trace of occupancy features and labels (DCI found at the location), input of OccupancyGateTrainer.
+// One line per location with sufficient power:
+// sfn, sf_idx, cfi, ncce, l, power, spread, relative_power, occupancy, label
+class OccupancyTrace {
+public:
+  OccupancyTrace();
+  OccupancyTrace(const OccupancyTrace&) = delete; //prevent copy
+  OccupancyTrace& operator=(const OccupancyTrace&) = delete; //prevent copy
+  ~OccupancyTrace();
+
+  bool open(const std::string& filename);
+  bool isOpen() const;
+  // thread-safe; call after the search, when the labels are final
+  void write(uint32_t sfn, uint32_t sf_idx, uint32_t cfi, const falcon_dci_location_t* locations, uint32_t nof_locations);
+  void close();
+private:
+  FILE* file;
+  std::mutex m;
+};
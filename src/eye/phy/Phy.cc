@@ -2,69 +2,132 @@
 
 #include <iostream>
 
-Phy::Phy(uint32_t nof_rx_antennas, uint32_t nof_workers, const std::string& dciFilenName, const std::string& statsFileName, bool skipSecondaryMetaFormats, double metaFormatSplitRatio) :
+#include "srslte/phy/utils/debug.h"
+
+Phy::Phy(uint32_t nof_rx_antennas, uint32_t nof_workers, uint32_t nof_worker_threads, uint32_t nof_search_threads, const std::string& dciFilenName, const std::string& statsFileName, bool skipSecondaryMetaFormats, double metaFormatSplitRatio, const DCIFormatSet& formatSet) :
   nof_rx_antennas(nof_rx_antennas),
-  nof_workers(nof_workers),
-  common(FALCON_MAX_PRB, nof_rx_antennas, dciFilenName, statsFileName),
-  metaFormats(nof_falcon_ue_all_formats, metaFormatSplitRatio),
+  nof_workers(nof_workers > 2 ? nof_workers : 2),  // one buffer is always held by the receiver
+  nof_worker_threads(nof_worker_threads),
+  nof_search_threads(nof_search_threads),
+  common(FALCON_MAX_PRB, nof_rx_antennas, formatSet.getNofFormats(), dciFilenName, statsFileName),
+  metaFormats(formatSet, metaFormatSplitRatio),
   workers(),
-  workerThread(avail, pending)
+  avail(this->nof_workers),
+  pending(this->nof_workers),
+  workerThreads(),
+  loadSheddingPolicy(),
+  loadSheddingLevel(LOAD_SHEDDING_NONE)
 {
-  std::cout << "Creating Phy" << std::endl;
+  std::cout << "Creating Phy (DCI format set " << formatSet.getName() << ")" << std::endl;
   metaFormats.setSkipSecondaryMetaFormats(skipSecondaryMetaFormats);
 
-  for(uint32_t i=0; i<nof_workers; i++) {
+  for(uint32_t i=0; i<this->nof_workers; i++) {
     std::shared_ptr<SubframeWorker> worker(new SubframeWorker(i, common.max_prb, common, metaFormats));
     workers.push_back(worker);
-    avail.enqueue(worker);
+    avail.enqueue(worker.get());
+  }
+
+  // more threads than workers would never get a subframe to process
+  if(this->nof_worker_threads < 1) {
+    this->nof_worker_threads = 1;
+  }
+  if(this->nof_worker_threads > this->nof_workers) {
+    this->nof_worker_threads = this->nof_workers;
+  }
+  if(this->nof_search_threads < 1) {
+    this->nof_search_threads = 1;
+  }
+  for(uint32_t i=0; i<this->nof_worker_threads; i++) {
+    std::unique_ptr<SubframeWorkerThread> workerThread(new SubframeWorkerThread(avail, pending, this->nof_search_threads));
+    workerThread->start();
+    workerThreads.push_back(std::move(workerThread));
   }
-  workerThread.start();
+  std::cout << "Started " << this->nof_worker_threads << " subframe worker thread(s) with "
+            << this->nof_search_threads << " DCI search thread(s) each" << std::endl;
 }
 
 Phy::~Phy() {
-  workerThread.cancel();
+  for(auto& workerThread : workerThreads) {
+    workerThread->cancel();
+  }
   avail.cancel();
   pending.cancel();
-  workerThread.wait_thread_finish();
-
-  // cleanup
-  std::shared_ptr<SubframeWorker> buffer = nullptr;
-  do {
-    buffer = avail.dequeueImmediate();
-  } while(buffer != nullptr);
-  do {
-    buffer = pending.dequeueImmediate();
-  } while(buffer != nullptr);
+  for(auto& workerThread : workerThreads) {
+    workerThread->wait_thread_finish();
+  }
 
   std::cout << "Destroyed Phy" << std::endl;
 }
 
-std::shared_ptr<SubframeWorker> Phy::getAvail() {
+SubframeWorker* Phy::getAvail() {
   return avail.dequeue();
 }
 
-std::shared_ptr<SubframeWorker> Phy::getAvailImmediate() {
+SubframeWorker* Phy::getAvailImmediate() {
   return avail.dequeueImmediate();
 }
 
-void Phy::putAvail(std::shared_ptr<SubframeWorker> buffer) {
-  avail.enqueue(std::move(buffer));
+void Phy::putAvail(SubframeWorker* buffer) {
+  // queues hold all workers, so they never run full
+  avail.enqueue(buffer);
 }
 
-std::shared_ptr<SubframeWorker> Phy::getPending() {
+SubframeWorker* Phy::getPending() {
   return pending.dequeue();
 }
 
-void Phy::putPending(std::shared_ptr<SubframeWorker> buffer) {
-  pending.enqueue(std::move(buffer));
+void Phy::putPending(SubframeWorker* buffer) {
+  if(loadSheddingPolicy) {
+    LoadSheddingInput load;
+    // the receiver already holds the buffer of the next subframe
+    load.nof_buffers = nof_workers - 1;
+    load.nof_pending = nof_workers - 1 - getNofAvail();  // includes this subframe
+    load.nof_worker_threads = nof_worker_threads;
+    load.decode_time_us = common.getAvgDecodeTime();
+    LoadSheddingLevel level = loadSheddingPolicy->update(load);
+    if(level != loadSheddingLevel) {
+      INFO("Load shedding in SFN %d.%d: %s -> %s (pending %d/%d, decode time %.0f us)\n",
+           buffer->getSfn(), buffer->getSfidx(),
+           LoadSheddingPolicy::getLevelString(loadSheddingLevel),
+           LoadSheddingPolicy::getLevelString(level),
+           load.nof_pending, load.nof_buffers, load.decode_time_us);
+      loadSheddingLevel = level;
+    }
+    buffer->setLoadSheddingLevel(level);
+  }
+  // reserve the subframe's slot in the reorder buffer before any worker may finish it
+  common.announceSubframe(buffer->getSfn(), buffer->getSfidx());
+  pending.enqueue(buffer);
 }
 
-// Wait until pending queue has been processed entirely and workerThread finished his work
+uint32_t Phy::getNofAvail() const {
+  return static_cast<uint32_t>(avail.size());
+}
+
+void Phy::setLoadSheddingPolicy(std::unique_ptr<LoadSheddingPolicy> policy) {
+  loadSheddingPolicy = std::move(policy);
+  loadSheddingLevel = LOAD_SHEDDING_NONE;
+}
+
+LoadSheddingLevel Phy::getLoadSheddingLevel() const {
+  return loadSheddingLevel;
+}
+
+void Phy::skipSubframe(uint32_t sfn, uint32_t sf_idx) {
+  common.skipSubframe(sfn, sf_idx);
+}
+
+// Wait until pending queue has been processed entirely and all workerThreads finished their work
 void Phy::joinPending() {
   pending.waitEmpty();  // wait empty queue
-  workerThread.cancel(); // mark worker thread as disabled
-  pending.cancel(); // trigger cancel event to waiting worker thread
-  workerThread.wait_thread_finish(); // wait worker thread to exit
+  for(auto& workerThread : workerThreads) {
+    workerThread->cancel(); // mark worker threads as disabled
+  }
+  pending.cancel(); // trigger cancel event to waiting worker threads
+  for(auto& workerThread : workerThreads) {
+    workerThread->wait_thread_finish(); // wait worker threads to exit
+  }
+  common.flushDCIConsumer(); // wait until all results have been consumed
 }
 
 PhyCommon& Phy::getCommon() {
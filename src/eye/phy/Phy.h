@@ -8,7 +8,8 @@
 #include "MetaFormats.h"
 #include "SubframeWorkerThread.h"
 #include "SubframeWorker.h"
-#include "falcon/common/ThreadSafeQueue.h"
+#include "LoadShedding.h"
+#include "falcon/common/LockFreeQueue.h"
 
 #include "srslte/common/common.h"
 
@@ -20,17 +21,26 @@ class Phy {
 public:
   Phy(uint32_t nof_rx_antennas,
       uint32_t nof_workers,
+      uint32_t nof_worker_threads,
+      uint32_t nof_search_threads,
       const std::string& dciFilenName,
       const std::string& statsFileName,
       bool skipSecondaryMetaFormats,
-      double metaFormatSplitRatio);
+      double metaFormatSplitRatio,
+      const DCIFormatSet& formatSet = DCIFormatSet::getDefault());
   ~Phy();
-  std::shared_ptr<SubframeWorker> getAvail();
-  std::shared_ptr<SubframeWorker> getAvailImmediate();
-  void putAvail(std::shared_ptr<SubframeWorker>);
-  std::shared_ptr<SubframeWorker> getPending();
-  void putPending(std::shared_ptr<SubframeWorker>);
+  // workers are owned by Phy; the queues only pass raw handles
+  SubframeWorker* getAvail();
+  SubframeWorker* getAvailImmediate();
+  void putAvail(SubframeWorker*);
+  SubframeWorker* getPending();
+  void putPending(SubframeWorker*);
+  uint32_t getNofAvail() const;
+  void skipSubframe(uint32_t sfn, uint32_t sf_idx);
   void joinPending();
+  // evaluated by putPending() for each subframe; nullptr disables load shedding
+  void setLoadSheddingPolicy(std::unique_ptr<LoadSheddingPolicy> policy);
+  LoadSheddingLevel getLoadSheddingLevel() const;
   PhyCommon& getCommon();
   DCIMetaFormats& getMetaFormats();
   std::vector<std::shared_ptr<SubframeWorker> >& getWorkers();
@@ -43,13 +53,17 @@ public:
 
   uint32_t nof_rx_antennas;
   uint32_t nof_workers;
+  uint32_t nof_worker_threads;
+  uint32_t nof_search_threads;
 private:
   PhyCommon common;
   DCIMetaFormats metaFormats;
 
   std::vector<std::shared_ptr<SubframeWorker>> workers;
-  ThreadSafeQueue<SubframeWorker> avail;
-  ThreadSafeQueue<SubframeWorker> pending;
-  SubframeWorkerThread workerThread;
+  LockFreeQueue<SubframeWorker> avail;
+  LockFreeQueue<SubframeWorker> pending;
+  std::vector<std::unique_ptr<SubframeWorkerThread>> workerThreads;
+  std::unique_ptr<LoadSheddingPolicy> loadSheddingPolicy;
+  LoadSheddingLevel loadSheddingLevel;
 
 };
@@ -3,17 +3,30 @@
 
 PhyCommon::PhyCommon(uint32_t max_prb,
                      uint32_t nof_rx_antennas,
+                     uint32_t nof_formats,
                      const std::string& dciFilenName,
                      const std::string& statsFileName) :
   max_prb(max_prb),
   nof_rx_antennas(nof_rx_antennas),
-  rntiManager(nof_falcon_ue_all_formats, RNTI_PER_SUBFRAME),
+  rntiManager(nof_formats, RNTI_PER_SUBFRAME),
   stats(),
   defaultDCIConsumer(new DCIToFile()),
   dciConsumer(defaultDCIConsumer),
-  enableShortcutDiscovery(true)
+  subframeInfoPool(),
+  dispatcher(DEFAULT_REORDER_BUFFER_DEPTH),
+  enableShortcutDiscovery(true),
+  maxRecursionDepth(DEFAULT_MAX_RECURSION_DEPTH),
+  disambiguationDepth(DEFAULT_DCI_DISAMBIGUATION_DEPTH),
+  listViterbiSize(DEFAULT_LIST_VITERBI_SIZE),
+  viterbiMinReliability(DEFAULT_VITERBI_MIN_RELIABILITY),
+  occupancyThreshold(DEFAULT_OCCUPANCY_THRESHOLD),
+  occupancyTrace(),
+  enableTargetedSearch(DEFAULT_TARGETED_DCI_SEARCH),
+  enableHarqHints(DEFAULT_HARQ_HINTS),
+  hintTable(),
+  avgDecodeTime(0)
 {
-
+  falcon_occupancy_gate_init(&occupancyGate);
 
   if(dciFilenName.length() > 0) {
     dci_file = fopen(dciFilenName.c_str(), "w");
@@ -30,9 +43,15 @@ PhyCommon::PhyCommon(uint32_t max_prb,
   }
 
   defaultDCIConsumer->setFile(dci_file);
+  dispatcher.setConsumer(dciConsumer);
+  dispatcher.setPool(&subframeInfoPool);
+  dispatcher.start();
 }
 
 PhyCommon::~PhyCommon() {
+  // stop dispatching before the consumers' files are closed
+  dispatcher.cancel();
+  dispatcher.wait_thread_finish();
   if(dci_file != stdout) {
     fclose(dci_file);
   }
@@ -54,6 +73,7 @@ FILE* PhyCommon::getStatsFile() {
 }
 
 void PhyCommon::addStats(const DCIBlindSearchStats& stats) {
+  std::lock_guard<std::mutex> lock(statsMutex);
   this->stats += stats;
 }
 
@@ -73,17 +93,123 @@ bool PhyCommon::getShortcutDiscovery() const {
   return enableShortcutDiscovery;
 }
 
+void PhyCommon::setSearchDepth(uint32_t maxRecursionDepth, uint32_t disambiguationDepth) {
+  this->maxRecursionDepth = maxRecursionDepth;
+  this->disambiguationDepth = disambiguationDepth;
+}
+
+uint32_t PhyCommon::getMaxRecursionDepth() const {
+  return maxRecursionDepth;
+}
+
+uint32_t PhyCommon::getDisambiguationDepth() const {
+  return disambiguationDepth;
+}
+
+void PhyCommon::setListViterbi(uint32_t listSize, float minReliability) {
+  listViterbiSize = listSize;
+  viterbiMinReliability = minReliability;
+}
+
+uint32_t PhyCommon::getListViterbiSize() const {
+  return listViterbiSize;
+}
+
+float PhyCommon::getViterbiMinReliability() const {
+  return viterbiMinReliability;
+}
+
+void PhyCommon::setOccupancyThreshold(float threshold) {
+  occupancyThreshold = threshold;
+}
+
+float PhyCommon::getOccupancyThreshold() const {
+  return occupancyThreshold;
+}
+
+bool PhyCommon::loadOccupancyModel(const std::string& filename) {
+  return falcon_occupancy_gate_load(&occupancyGate, filename.c_str()) == SRSLTE_SUCCESS;
+}
+
+const falcon_occupancy_gate_t& PhyCommon::getOccupancyGate() const {
+  return occupancyGate;
+}
+
+bool PhyCommon::openOccupancyTrace(const std::string& filename) {
+  return occupancyTrace.open(filename);
+}
+
+OccupancyTrace* PhyCommon::getOccupancyTrace() {
+  return occupancyTrace.isOpen() ? &occupancyTrace : nullptr;
+}
+
+void PhyCommon::setTargetedSearch(bool enable) {
+  enableTargetedSearch = enable;
+}
+
+bool PhyCommon::getTargetedSearch() const {
+  return enableTargetedSearch;
+}
+
+void PhyCommon::setHarqHints(bool enable) {
+  enableHarqHints = enable;
+}
+
+bool PhyCommon::getHarqHints() const {
+  return enableHarqHints;
+}
+
+DCIHintTable& PhyCommon::getHintTable() {
+  return hintTable;
+}
+
+void PhyCommon::reportDecodeTime(uint32_t time_us) {
+  // moving average (weight 1/16); concurrent updates may lose a sample, which is acceptable here
+  uint32_t avg = avgDecodeTime.load(std::memory_order_relaxed);
+  avgDecodeTime.store(avg - avg/16 + time_us/16, std::memory_order_relaxed);
+}
+
+uint32_t PhyCommon::getAvgDecodeTime() const {
+  return avgDecodeTime.load(std::memory_order_relaxed);
+}
+
 void PhyCommon::setDCIConsumer(std::shared_ptr<SubframeInfoConsumer> consumer) {
   dciConsumer = consumer;
+  dispatcher.setConsumer(dciConsumer);
 }
 
 void PhyCommon::resetDCIConsumer() {
   dciConsumer = defaultDCIConsumer;
+  dispatcher.setConsumer(dciConsumer);
+}
+
+void PhyCommon::setReorderBufferDepth(uint32_t depth) {
+  dispatcher.setDepth(depth);
+}
+
+void PhyCommon::flushDCIConsumer() {
+  dispatcher.flush();
+}
+
+SubframeInfoDispatcherStats PhyCommon::getDispatcherStats() const {
+  return dispatcher.getStats();
+}
+
+void PhyCommon::announceSubframe(uint32_t sfn, uint32_t sf_idx) {
+  dispatcher.announce(sfn, sf_idx);
 }
 
-void PhyCommon::consumeDCICollection(const SubframeInfo& subframeInfo) {
-  // maybe this is a good point for synchronization
-  dciConsumer->consumeDCICollection(subframeInfo);
+void PhyCommon::skipSubframe(uint32_t sfn, uint32_t sf_idx) {
+  dispatcher.skip(sfn, sf_idx);
+}
+
+std::shared_ptr<SubframeInfo> PhyCommon::getSubframeInfo(const srslte_cell_t& cell) {
+  return subframeInfoPool.get(cell);
+}
+
+void PhyCommon::consumeDCICollection(uint32_t sfn, uint32_t sf_idx, std::shared_ptr<SubframeInfo> subframeInfo) {
+  // hand over to the dispatcher thread; consumers are served in order of (sfn, sf_idx)
+  dispatcher.deliver(sfn, sf_idx, std::move(subframeInfo));
 }
 
 DCIBlindSearchStats::DCIBlindSearchStats() {
@@ -96,11 +222,28 @@ DCIBlindSearchStats::DCIBlindSearchStats() {
   nof_subframe_collisions_up = 0;
   time_blindsearch.tv_sec = 0;
   time_blindsearch.tv_usec = 0;
+  nof_decode_cache_hits = 0;
+  nof_decode_cache_misses = 0;
+  nof_candidate_heap_allocs = 0;
+  nof_subframes_shed = 0;
+  for(uint32_t i = 0; i < DCI_SEARCH_NOF_DEPTHS; i++) {
+    nof_decoded_per_depth[i] = 0;
+  }
+  nof_abandoned_decodes = 0;
+  nof_gated_locations = 0;
+  nof_gate_audit_dci = 0;
+  nof_gate_audit_misses = 0;
+  nof_targeted_decodes = 0;
+  nof_targeted_dci = 0;
+  nof_blind_decodes = 0;
+  nof_blind_dci = 0;
+  nof_hinted_decodes = 0;
+  nof_hinted_dci = 0;
 }
 
 void DCIBlindSearchStats::print(FILE* file) {
-  fprintf(file, "nof_decoded_locations, nof_cce, nof_missed_cce, nof_subframes, nof_subframe_collisions_dw, nof_subframe_collisions_up, time, nof_locations\n");
-  fprintf(file, "%d, %d, %d, %d, %d, %d, %ld.%06ld, %d\n",
+  fprintf(file, "nof_decoded_locations, nof_cce, nof_missed_cce, nof_subframes, nof_subframe_collisions_dw, nof_subframe_collisions_up, time, nof_locations, nof_decode_cache_hits, nof_decode_cache_misses, nof_candidate_heap_allocs, nof_subframes_shed, nof_decoded_depth0, nof_decoded_depth1, nof_decoded_depth2, nof_decoded_depth3, nof_abandoned_decodes, nof_gated_locations, nof_gate_audit_dci, nof_gate_audit_misses, nof_targeted_decodes, nof_targeted_dci, nof_blind_decodes, nof_blind_dci, nof_hinted_decodes, nof_hinted_dci\n");
+  fprintf(file, "%d, %d, %d, %d, %d, %d, %ld.%06ld, %d, %d, %d, %d, %d, %d, %d, %d, %d, %d, %d, %d, %d, %d, %d, %d, %d, %d, %d\n",
           nof_decoded_locations,
           nof_cce,
           nof_missed_cce,
@@ -109,7 +252,25 @@ void DCIBlindSearchStats::print(FILE* file) {
           nof_subframe_collisions_up,
           time_blindsearch.tv_sec,
           time_blindsearch.tv_usec,
-          nof_locations);
+          nof_locations,
+          nof_decode_cache_hits,
+          nof_decode_cache_misses,
+          nof_candidate_heap_allocs,
+          nof_subframes_shed,
+          nof_decoded_per_depth[0],
+          nof_decoded_per_depth[1],
+          nof_decoded_per_depth[2],
+          nof_decoded_per_depth[3],
+          nof_abandoned_decodes,
+          nof_gated_locations,
+          nof_gate_audit_dci,
+          nof_gate_audit_misses,
+          nof_targeted_decodes,
+          nof_targeted_dci,
+          nof_blind_decodes,
+          nof_blind_dci,
+          nof_hinted_decodes,
+          nof_hinted_dci);
 }
 
 DCIBlindSearchStats& DCIBlindSearchStats::operator+=(const DCIBlindSearchStats& right) {
@@ -122,6 +283,23 @@ DCIBlindSearchStats& DCIBlindSearchStats::operator+=(const DCIBlindSearchStats&
   nof_subframe_collisions_up  += right.nof_subframe_collisions_up;
   time_blindsearch.tv_sec     += right.time_blindsearch.tv_sec;
   time_blindsearch.tv_usec    += right.time_blindsearch.tv_usec;
+  nof_decode_cache_hits       += right.nof_decode_cache_hits;
+  nof_decode_cache_misses     += right.nof_decode_cache_misses;
+  nof_candidate_heap_allocs   += right.nof_candidate_heap_allocs;
+  nof_subframes_shed          += right.nof_subframes_shed;
+  for(uint32_t i = 0; i < DCI_SEARCH_NOF_DEPTHS; i++) {
+    nof_decoded_per_depth[i]  += right.nof_decoded_per_depth[i];
+  }
+  nof_abandoned_decodes       += right.nof_abandoned_decodes;
+  nof_gated_locations         += right.nof_gated_locations;
+  nof_gate_audit_dci          += right.nof_gate_audit_dci;
+  nof_gate_audit_misses       += right.nof_gate_audit_misses;
+  nof_targeted_decodes        += right.nof_targeted_decodes;
+  nof_targeted_dci            += right.nof_targeted_dci;
+  nof_blind_decodes           += right.nof_blind_decodes;
+  nof_blind_dci               += right.nof_blind_dci;
+  nof_hinted_decodes          += right.nof_hinted_decodes;
+  nof_hinted_dci              += right.nof_hinted_dci;
   return *this;
 }
 
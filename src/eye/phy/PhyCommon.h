@@ -1,12 +1,19 @@
 #pragma once
 
 #include <stdint.h>
+#include <mutex>
+#include <atomic>
 #include "falcon/util/RNTIManager.h"
 #include "falcon/phy/falcon_phch/falcon_dci.h"
 #include "SubframeInfoConsumer.h"
+#include "SubframeInfoDispatcher.h"
+#include "SubframeInfoPool.h"
+#include "OccupancyTrace.h"
+#include "DCIHintTable.h"
+#include "falcon/phy/falcon_phch/falcon_occupancy_gate.h"
 
-extern const srslte_dci_format_t falcon_ue_all_formats[];
-extern const uint32_t nof_falcon_ue_all_formats;
+// decode counts per recursion depth; deeper levels are counted in the last entry
+#define DCI_SEARCH_NOF_DEPTHS 4
 
 class DCIBlindSearchStats {
 public:
@@ -15,13 +22,28 @@ public:
     DCIBlindSearchStats& operator+=(const DCIBlindSearchStats& right);
 
     uint32_t nof_locations;
-    uint32_t nof_decoded_locations;
+    uint32_t nof_decoded_locations;   // decoder runs of the blind search (formats of equal size share a run)
     uint32_t nof_cce;
     uint32_t nof_missed_cce;
     uint32_t nof_subframes;
     uint32_t nof_subframe_collisions_dw;
     uint32_t nof_subframe_collisions_up;
     struct timeval time_blindsearch;
+    uint32_t nof_decode_cache_hits;
+    uint32_t nof_decode_cache_misses;
+    uint32_t nof_candidate_heap_allocs;
+    uint32_t nof_subframes_shed;
+    uint32_t nof_decoded_per_depth[DCI_SEARCH_NOF_DEPTHS];
+    uint32_t nof_abandoned_decodes;
+    uint32_t nof_gated_locations;     // locations not decoded due to the occupancy gate
+    uint32_t nof_gate_audit_dci;      // DCI found in audit subframes (searched without gate)
+    uint32_t nof_gate_audit_misses;   // ...of which the gate would have skipped the location
+    uint32_t nof_targeted_decodes;    // phase one: formats decoded in the search spaces of known RNTIs (decode cache misses)
+    uint32_t nof_targeted_dci;        // phase one: DCI of known RNTIs
+    uint32_t nof_blind_decodes;       // phase two: formats decoded by the blind search (decode cache misses)
+    uint32_t nof_blind_dci;           // phase two: DCI of the blind search
+    uint32_t nof_hinted_decodes;      // formats decoded at locations predicted by HARQ timing (decode cache misses)
+    uint32_t nof_hinted_dci;          // DCI found at predicted locations
 };
 
 class PhyStats {
@@ -38,6 +60,7 @@ class PhyCommon {
 public:
   PhyCommon(uint32_t max_prb,
             uint32_t nof_rx_antennas,
+            uint32_t nof_formats,
             const std::string& dciFilenName,
             const std::string& statsFileName);
   ~PhyCommon();
@@ -51,12 +74,50 @@ public:
   void setShortcutDiscovery(bool enable);
   bool getShortcutDiscovery() const;
 
+  // max recursion depth of the DCI search (0: breadth-first) and depth of the disambiguation search
+  void setSearchDepth(uint32_t maxRecursionDepth, uint32_t disambiguationDepth);
+  uint32_t getMaxRecursionDepth() const;
+  uint32_t getDisambiguationDepth() const;
+
+  // list Viterbi: number of survivors and min. reliability to continue decoding (0: no early termination)
+  void setListViterbi(uint32_t listSize, float minReliability);
+  uint32_t getListViterbiSize() const;
+  float getViterbiMinReliability() const;
+
+  // occupancy gate: locations with an estimated probability of a DCI below threshold are not decoded (0: disabled)
+  void setOccupancyThreshold(float threshold);
+  float getOccupancyThreshold() const;
+  bool loadOccupancyModel(const std::string& filename);
+  const falcon_occupancy_gate_t& getOccupancyGate() const;
+  // features and labels for OccupancyGateTrainer
+  bool openOccupancyTrace(const std::string& filename);
+  OccupancyTrace* getOccupancyTrace();  // nullptr if not recording
+
+  // decode the search spaces of active and evergreen RNTIs before the blind search
+  void setTargetedSearch(bool enable);
+  bool getTargetedSearch() const;
+
+  // decode the DCI predicted by HARQ timing (same RNTI, location and format 8 subframes later) first
+  void setHarqHints(bool enable);
+  bool getHarqHints() const;
+  DCIHintTable& getHintTable();
+
+  // recent processing time of a subframe in us (input of the load shedding policy)
+  void reportDecodeTime(uint32_t time_us);
+  uint32_t getAvgDecodeTime() const;
+
   //upper layer interfaces
   void setDCIConsumer(std::shared_ptr<SubframeInfoConsumer>);
   void resetDCIConsumer();
+  void setReorderBufferDepth(uint32_t depth);
+  void flushDCIConsumer();
+  SubframeInfoDispatcherStats getDispatcherStats() const;
 
   //lower layer interface
-  void consumeDCICollection(const SubframeInfo& subframeInfo);
+  std::shared_ptr<SubframeInfo> getSubframeInfo(const srslte_cell_t& cell);
+  void announceSubframe(uint32_t sfn, uint32_t sf_idx);
+  void skipSubframe(uint32_t sfn, uint32_t sf_idx);
+  void consumeDCICollection(uint32_t sfn, uint32_t sf_idx, std::shared_ptr<SubframeInfo> subframeInfo);
 
   uint32_t max_prb;
   uint32_t nof_rx_antennas;
@@ -66,9 +127,23 @@ private:
   RNTIManager rntiManager;
 
   DCIBlindSearchStats stats;
+  std::mutex statsMutex;
 
   std::shared_ptr<DCIToFile> defaultDCIConsumer;
   std::shared_ptr<SubframeInfoConsumer> dciConsumer;
+  SubframeInfoPool subframeInfoPool;  // must outlive the dispatcher
+  SubframeInfoDispatcher dispatcher;
 
   bool enableShortcutDiscovery;
+  std::atomic<uint32_t> maxRecursionDepth;
+  std::atomic<uint32_t> disambiguationDepth;
+  std::atomic<uint32_t> listViterbiSize;
+  std::atomic<float> viterbiMinReliability;
+  std::atomic<float> occupancyThreshold;
+  falcon_occupancy_gate_t occupancyGate;
+  OccupancyTrace occupancyTrace;
+  std::atomic<bool> enableTargetedSearch;
+  std::atomic<bool> enableHarqHints;
+  DCIHintTable hintTable;
+  std::atomic<uint32_t> avgDecodeTime;
 };
@@ -2,7 +2,8 @@
 
 SubframeInfo::SubframeInfo(const srslte_cell_t& cell) :
   subframePower(cell),
-  dciCollection(cell)
+  dciCollection(cell),
+  loadSheddingLevel(LOAD_SHEDDING_NONE)
 {
 
 }
@@ -10,3 +11,9 @@ SubframeInfo::SubframeInfo(const srslte_cell_t& cell) :
 SubframeInfo::~SubframeInfo() {
 
 }
+
+void SubframeInfo::reset(const srslte_cell_t& cell) {
+  subframePower.reset(cell);
+  dciCollection.reset(cell);
+  loadSheddingLevel = LOAD_SHEDDING_NONE;
+}
@@ -2,16 +2,23 @@
 
 #include "SubframePower.h"
 #include "DCICollection.h"
+#include "LoadShedding.h"
 
 class SubframeInfo {
 public:
     SubframeInfo(const srslte_cell_t& cell);
     ~SubframeInfo();
+    // prepare a recycled instance for the next subframe
+    void reset(const srslte_cell_t& cell);
     SubframePower& getSubframePower() { return subframePower; }
     const SubframePower& getSubframePower() const { return subframePower; }
     DCICollection& getDCICollection() { return dciCollection; }
     const DCICollection& getDCICollection() const { return dciCollection; }
+    // degradation applied while searching this subframe
+    void setLoadSheddingLevel(LoadSheddingLevel level) { loadSheddingLevel = level; }
+    LoadSheddingLevel getLoadSheddingLevel() const { return loadSheddingLevel; }
 private:
     SubframePower subframePower;
     DCICollection dciCollection;
+    LoadSheddingLevel loadSheddingLevel;
 };
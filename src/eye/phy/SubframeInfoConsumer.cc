@@ -1,6 +1,8 @@
 #include "SubframeInfoConsumer.h"
 #include "DCIPrint.h"
 
+#include <cstring>
+
 
 
 DCIConsumerList::~DCIConsumerList() {
@@ -13,6 +15,12 @@ void DCIConsumerList::consumeDCICollection(const SubframeInfo& subframeInfo) {
   }
 }
 
+void DCIConsumerList::consumeSubframeGap(uint32_t sfn, uint32_t sf_idx, SubframeGapReason reason) {
+  for(auto& consumer : consumers) {
+    consumer->consumeSubframeGap(sfn, sf_idx, reason);
+  }
+}
+
 void DCIConsumerList::addConsumer(std::shared_ptr<SubframeInfoConsumer> consumer)
 {
   consumers.push_back(consumer);
@@ -67,9 +75,12 @@ void DCIToFile::printDCICollection(const SubframeInfo& subframeInfo) const {
   const DCICollection& collection(subframeInfo.getDCICollection());
   struct timeval timestamp = collection.getTimestamp();
 
+  char hex_str[DCI_HEX_MAX_LEN];
+
   // Downlink
   const std::vector<DCI_DL>& dci_dl = collection.getDCI_DL();
   for(std::vector<DCI_DL>::const_iterator dci = dci_dl.begin(); dci != dci_dl.end(); ++dci) {
+    dci->sprintHex(hex_str, sizeof(hex_str));
     switch(dci->format) {
       case SRSLTE_DCI_FORMAT0:
         ERROR("Error: no reason to be here\n");
@@ -85,9 +96,9 @@ void DCIToFile::printDCICollection(const SubframeInfo& subframeInfo) const {
                 "%d\t%d\t%d\t%d\t"
                 "%d\t%d\t%d\t%d\t%d\t%s\n",
                 timestamp.tv_sec, timestamp.tv_usec, collection.get_sfn(), collection.get_sf_idx(), dci->rnti,
-                dci->dl_grant->mcs[0].idx, dci->dl_grant->nof_prb, dci->dl_grant->mcs[0].tbs, -1, -1,
-                dci->format+1, dci->dl_dci_unpacked->ndi, -1, dci->dl_dci_unpacked->harq_process,
-                dci->location.ncce, dci->location.L, collection.get_cfi(), dci->histval, dci->nof_bits, dci->hex.c_str());
+                dci->dl_grant.mcs[0].idx, dci->dl_grant.nof_prb, dci->dl_grant.mcs[0].tbs, -1, -1,
+                dci->format+1, dci->dl_dci_unpacked.ndi, -1, dci->dl_dci_unpacked.harq_process,
+                dci->location.ncce, dci->location.L, collection.get_cfi(), dci->histval, dci->nof_bits, hex_str);
         break;
       case SRSLTE_DCI_FORMAT2:
       case SRSLTE_DCI_FORMAT2A:
@@ -98,9 +109,9 @@ void DCIToFile::printDCICollection(const SubframeInfo& subframeInfo) const {
                 "%d\t%d\t%d\t%d\t"
                 "%d\t%d\t%d\t%d\t%d\t%s\n",
                 timestamp.tv_sec, timestamp.tv_usec, collection.get_sfn(), collection.get_sf_idx(), dci->rnti,
-                dci->dl_grant->mcs[0].idx, dci->dl_grant->nof_prb, dci->dl_grant->mcs[0].tbs + dci->dl_grant->mcs[1].tbs, dci->dl_grant->mcs[0].tbs, dci->dl_grant->mcs[1].tbs,
-                dci->format+1, dci->dl_dci_unpacked->ndi, dci->dl_dci_unpacked->ndi_1, dci->dl_dci_unpacked->harq_process,
-                dci->location.ncce, dci->location.L, collection.get_cfi(), dci->histval, dci->nof_bits, dci->hex.c_str());
+                dci->dl_grant.mcs[0].idx, dci->dl_grant.nof_prb, dci->dl_grant.mcs[0].tbs + dci->dl_grant.mcs[1].tbs, dci->dl_grant.mcs[0].tbs, dci->dl_grant.mcs[1].tbs,
+                dci->format+1, dci->dl_dci_unpacked.ndi, dci->dl_dci_unpacked.ndi_1, dci->dl_dci_unpacked.harq_process,
+                dci->location.ncce, dci->location.L, collection.get_cfi(), dci->histval, dci->nof_bits, hex_str);
         break;
         //case SRSLTE_DCI_FORMAT3:
         //case SRSLTE_DCI_FORMAT3A:
@@ -112,16 +123,17 @@ void DCIToFile::printDCICollection(const SubframeInfo& subframeInfo) const {
   // Uplink
   const std::vector<DCI_UL>& dci_ul = collection.getDCI_UL();
   for(std::vector<DCI_UL>::const_iterator dci = dci_ul.begin(); dci != dci_ul.end(); ++dci) {
-    if (dci->ul_dci_unpacked->mcs_idx < 29) {
+    dci->sprintHex(hex_str, sizeof(hex_str));
+    if (dci->ul_dci_unpacked.mcs_idx < 29) {
       fprintf(dci_file,
               "%ld.%06ld\t%04d\t%d\t%d\t0\t"
               "%d\t%d\t%d\t%d\t%d\t"
               "0\t%d\t-1\t%d\t"
               "%d\t%d\t%d\t%d\t%d\t%s\n",
               timestamp.tv_sec, timestamp.tv_usec, collection.get_sfn(), collection.get_sf_idx(), dci->rnti,
-              dci->ul_grant->mcs.idx, dci->ul_grant->L_prb, dci->ul_grant->mcs.tbs, -1, -1,
-              dci->ul_dci_unpacked->ndi, (10*collection.get_sfn()+collection.get_sf_idx())%8,
-              dci->location.ncce, dci->location.L, collection.get_cfi(), dci->histval, dci->nof_bits, dci->hex.c_str());
+              dci->ul_grant.mcs.idx, dci->ul_grant.L_prb, dci->ul_grant.mcs.tbs, -1, -1,
+              dci->ul_dci_unpacked.ndi, (10*collection.get_sfn()+collection.get_sf_idx())%8,
+              dci->location.ncce, dci->location.L, collection.get_cfi(), dci->histval, dci->nof_bits, hex_str);
     }
     else {
       fprintf(dci_file,
@@ -130,13 +142,119 @@ void DCIToFile::printDCICollection(const SubframeInfo& subframeInfo) const {
               "0\t%d\t-1\t%d\t"
               "%d\t%d\t%d\t%d\t%d\t%s\n",
               timestamp.tv_sec, timestamp.tv_usec, collection.get_sfn(), collection.get_sf_idx(), dci->rnti,
-              dci->ul_grant->mcs.idx, dci->ul_grant->L_prb, 0, -1, -1,
-              dci->ul_dci_unpacked->ndi, (10*collection.get_sfn()+collection.get_sf_idx())%8,
-              dci->location.ncce, dci->location.L, collection.get_cfi(), dci->histval, dci->nof_bits, dci->hex.c_str());
+              dci->ul_grant.mcs.idx, dci->ul_grant.L_prb, 0, -1, -1,
+              dci->ul_dci_unpacked.ndi, (10*collection.get_sfn()+collection.get_sf_idx())%8,
+              dci->location.ncce, dci->location.L, collection.get_cfi(), dci->histval, dci->nof_bits, hex_str);
     }
   }
 }
 
+DCIToBinaryFile::DCIToBinaryFile(const std::string& filename) :
+  writer(),
+  records()
+{
+  if(!writer.open(filename)) {
+    ERROR("Could not open DCI trace file %s\n", filename.c_str());
+  }
+  records.reserve(EXPECTED_NOF_DL_DCI_PER_SUBFRAME + EXPECTED_NOF_UL_DCI_PER_SUBFRAME);
+}
+
+DCIToBinaryFile::~DCIToBinaryFile() {
+  writer.close();
+}
+
+bool DCIToBinaryFile::isOpen() const {
+  return writer.isOpen();
+}
+
+void DCIToBinaryFile::consumeDCICollection(const SubframeInfo& subframeInfo) {
+  const DCICollection& collection(subframeInfo.getDCICollection());
+  struct timeval timestamp = collection.getTimestamp();
+  records.clear();
+
+  // same selection and field values as DCIToFile
+  const std::vector<DCI_DL>& dci_dl = collection.getDCI_DL();
+  for(std::vector<DCI_DL>::const_iterator dci = dci_dl.begin(); dci != dci_dl.end(); ++dci) {
+    DCITraceRecord record;
+    record.direction = DCI_TRACE_DIR_DL;
+    record.mcs_idx = static_cast<int16_t>(dci->dl_grant.mcs[0].idx);
+    record.nof_prb = static_cast<int16_t>(dci->dl_grant.nof_prb);
+    record.ndi = static_cast<int8_t>(dci->dl_dci_unpacked.ndi);
+    record.harq_process = static_cast<int8_t>(dci->dl_dci_unpacked.harq_process);
+    switch(dci->format) {
+      case SRSLTE_DCI_FORMAT1:
+      case SRSLTE_DCI_FORMAT1A:
+      case SRSLTE_DCI_FORMAT1C:
+      case SRSLTE_DCI_FORMAT1B:
+      case SRSLTE_DCI_FORMAT1D:
+        record.tbs = dci->dl_grant.mcs[0].tbs;
+        record.tbs0 = -1;
+        record.tbs1 = -1;
+        record.ndi_1 = -1;
+        break;
+      case SRSLTE_DCI_FORMAT2:
+      case SRSLTE_DCI_FORMAT2A:
+      case SRSLTE_DCI_FORMAT2B:
+        record.tbs = dci->dl_grant.mcs[0].tbs + dci->dl_grant.mcs[1].tbs;
+        record.tbs0 = dci->dl_grant.mcs[0].tbs;
+        record.tbs1 = dci->dl_grant.mcs[1].tbs;
+        record.ndi_1 = static_cast<int8_t>(dci->dl_dci_unpacked.ndi_1);
+        break;
+      default:
+        continue;
+    }
+    record.rnti = dci->rnti;
+    record.format = static_cast<uint8_t>(dci->format);
+    record.ncce = static_cast<uint8_t>(dci->location.ncce);
+    record.L = static_cast<uint8_t>(dci->location.L);
+    record.histval = dci->histval;
+    DCITracePackPayload(record, dci->data, dci->nof_bits);
+    records.push_back(record);
+  }
+
+  const std::vector<DCI_UL>& dci_ul = collection.getDCI_UL();
+  for(std::vector<DCI_UL>::const_iterator dci = dci_ul.begin(); dci != dci_ul.end(); ++dci) {
+    DCITraceRecord record;
+    record.rnti = dci->rnti;
+    record.direction = DCI_TRACE_DIR_UL;
+    record.format = static_cast<uint8_t>(dci->format);
+    record.mcs_idx = static_cast<int16_t>(dci->ul_grant.mcs.idx);
+    record.nof_prb = static_cast<int16_t>(dci->ul_grant.L_prb);
+    record.tbs = dci->ul_dci_unpacked.mcs_idx < 29 ? dci->ul_grant.mcs.tbs : 0;
+    record.tbs0 = -1;
+    record.tbs1 = -1;
+    record.ndi = static_cast<int8_t>(dci->ul_dci_unpacked.ndi);
+    record.ndi_1 = -1;
+    record.harq_process = static_cast<int8_t>((10*collection.get_sfn()+collection.get_sf_idx())%8);
+    record.ncce = static_cast<uint8_t>(dci->location.ncce);
+    record.L = static_cast<uint8_t>(dci->location.L);
+    record.histval = dci->histval;
+    DCITracePackPayload(record, dci->data, dci->nof_bits);
+    records.push_back(record);
+  }
+
+  DCITraceSubframeHeader header;
+  header.tv_sec = timestamp.tv_sec;
+  header.tv_usec = static_cast<uint32_t>(timestamp.tv_usec);
+  header.sfn = static_cast<uint16_t>(collection.get_sfn());
+  header.sf_idx = static_cast<uint8_t>(collection.get_sf_idx());
+  header.cfi = static_cast<uint8_t>(collection.get_cfi());
+  header.flags = static_cast<uint8_t>((subframeInfo.getLoadSheddingLevel() << DCI_TRACE_FLAG_LOAD_SHEDDING_SHIFT) & DCI_TRACE_FLAG_LOAD_SHEDDING_MASK);
+  header.gap_reason = 0;
+  header.nof_dci = static_cast<uint16_t>(records.size());
+  writer.writeSubframe(header, records.data());
+}
+
+void DCIToBinaryFile::consumeSubframeGap(uint32_t sfn, uint32_t sf_idx, SubframeGapReason reason) {
+  DCITraceSubframeHeader header;
+  memset(&header, 0, sizeof(header));
+  header.sfn = static_cast<uint16_t>(sfn);
+  header.sf_idx = static_cast<uint8_t>(sf_idx);
+  header.flags = DCI_TRACE_FLAG_GAP;
+  header.gap_reason = static_cast<uint8_t>(reason);
+  writer.writeSubframe(header, nullptr);
+}
+
 DCIDrawASCII::DCIDrawASCII() :
   DCIToFileBase()
 {
@@ -157,6 +275,10 @@ void DCIDrawASCII::consumeDCICollection(const SubframeInfo& collection) {
   printRBMaps(collection);
 }
 
+void DCIDrawASCII::consumeSubframeGap(uint32_t sfn, uint32_t sf_idx, SubframeGapReason reason) {
+  fprintf(dci_file, "-- %d.%d %s --\n", sfn, sf_idx, getSubframeGapReasonString(reason));
+}
+
 void DCIDrawASCII::printRBMaps(const SubframeInfo& subframeInfo) const {
   const DCICollection& collection(subframeInfo.getDCICollection());
   fprintf(dci_file, "DL[");
@@ -178,6 +300,25 @@ SubframeInfoConsumer::~SubframeInfoConsumer() {
 
 }
 
+void SubframeInfoConsumer::consumeSubframeGap(uint32_t sfn, uint32_t sf_idx, SubframeGapReason reason) {
+  // ignore gaps by default
+  (void)sfn;
+  (void)sf_idx;
+  (void)reason;
+}
+
+const char* SubframeInfoConsumer::getSubframeGapReasonString(SubframeGapReason reason) {
+  switch(reason) {
+    case SUBFRAME_GAP_SKIPPED:
+      return "skipped";
+    case SUBFRAME_GAP_LATE:
+      return "late";
+    case SUBFRAME_GAP_DROPPED:
+      return "dropped";
+  }
+  return "INVALID";
+}
+
 PowerDrawASCII::PowerDrawASCII() :
   DCIToFileBase()
 {
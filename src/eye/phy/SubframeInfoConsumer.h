@@ -2,17 +2,34 @@
 
 #include "SubframeInfo.h"
 
+#include "falcon/common/DCITrace.h"
+
+#include <memory>
+#include <vector>
+#include <string>
+
+// Why a subframe has no SubframeInfo
+typedef enum {
+  SUBFRAME_GAP_SKIPPED = 0,   // no worker available, subframe was not processed
+  SUBFRAME_GAP_LATE,          // processing exceeded the reorder window
+  SUBFRAME_GAP_DROPPED        // consumer could not keep up, result discarded
+} SubframeGapReason;
+
 class SubframeInfoConsumer {
 
 public:
   virtual ~SubframeInfoConsumer();
   virtual void consumeDCICollection(const SubframeInfo& collection) = 0;
+  // called in place of consumeDCICollection for subframes without result
+  virtual void consumeSubframeGap(uint32_t sfn, uint32_t sf_idx, SubframeGapReason reason);
+  static const char* getSubframeGapReasonString(SubframeGapReason reason);
 };
 
 class DCIConsumerList : public SubframeInfoConsumer {
 public:
   virtual ~DCIConsumerList() override;
   virtual void consumeDCICollection(const SubframeInfo &collection) override;
+  virtual void consumeSubframeGap(uint32_t sfn, uint32_t sf_idx, SubframeGapReason reason) override;
   void addConsumer(std::shared_ptr<SubframeInfoConsumer> consumer);
 private:
   std::vector<std::shared_ptr<SubframeInfoConsumer>> consumers;
@@ -40,12 +57,26 @@ private:
     void printDCICollection(const SubframeInfo& collection) const;
 };
 
+// Writes the DCI in the binary trace format (see DCITrace.h)
+class DCIToBinaryFile : public SubframeInfoConsumer {
+public:
+  DCIToBinaryFile(const std::string& filename);
+  virtual ~DCIToBinaryFile() override;
+  bool isOpen() const;
+  virtual void consumeDCICollection(const SubframeInfo& subframeInfo) override;
+  virtual void consumeSubframeGap(uint32_t sfn, uint32_t sf_idx, SubframeGapReason reason) override;
+private:
+  DCITraceWriter writer;
+  std::vector<DCITraceRecord> records;  // reused across subframes
+};
+
 class DCIDrawASCII : public DCIToFileBase {
 public:
   DCIDrawASCII();
   DCIDrawASCII(FILE* dci_file);
   virtual ~DCIDrawASCII() override;
   virtual void consumeDCICollection(const SubframeInfo& subframeInfo) override;
+  virtual void consumeSubframeGap(uint32_t sfn, uint32_t sf_idx, SubframeGapReason reason) override;
 private:
   void printRBMaps(const SubframeInfo& subframeInfo) const;
   void printRBVector(const std::vector<uint16_t>& map) const;
@@ -0,0 +1,231 @@
+#include "SubframeInfoDispatcher.h"
+
+SubframeInfoDispatcherStats::SubframeInfoDispatcherStats() :
+  nof_dispatched(0),
+  nof_skipped(0),
+  nof_late(0),
+  nof_dropped(0)
+{
+
+}
+
+SubframeInfoDispatcher::SubframeInfoDispatcher(uint32_t depth) :
+  entries(),
+  abandoned(),
+  nof_buffered(0),
+  latestKey(REORDER_BUFFER_NOF_TTI),
+  depth(depth > 0 ? depth : 1),
+  consumer(nullptr),
+  pool(nullptr),
+  stats(),
+  dispatching(false),
+  canceled(false),
+  joined(false)
+{
+
+}
+
+SubframeInfoDispatcher::~SubframeInfoDispatcher() {
+  cancel();
+  wait_thread_finish();
+}
+
+void SubframeInfoDispatcher::setDepth(uint32_t depth) {
+  std::lock_guard<std::mutex> lock(m);
+  this->depth = depth > 0 ? depth : 1;
+  trim();
+}
+
+uint32_t SubframeInfoDispatcher::getDepth() const {
+  std::lock_guard<std::mutex> lock(m);
+  return depth;
+}
+
+void SubframeInfoDispatcher::setConsumer(std::shared_ptr<SubframeInfoConsumer> consumer) {
+  std::lock_guard<std::mutex> lock(m);
+  this->consumer = consumer;
+}
+
+void SubframeInfoDispatcher::setPool(SubframeInfoPool* pool) {
+  std::lock_guard<std::mutex> lock(m);
+  this->pool = pool;
+}
+
+void SubframeInfoDispatcher::announce(uint32_t sfn, uint32_t sf_idx) {
+  std::lock_guard<std::mutex> lock(m);
+  Entry& entry = entries[key(sfn, sf_idx)];
+  entry.state = ENTRY_PENDING;
+  entry.reason = SUBFRAME_GAP_SKIPPED;
+  entry.sfn = sfn;
+  entry.sf_idx = sf_idx;
+  entry.subframeInfo = nullptr;
+  nof_buffered++;
+  trim();
+}
+
+void SubframeInfoDispatcher::skip(uint32_t sfn, uint32_t sf_idx) {
+  std::lock_guard<std::mutex> lock(m);
+  uint64_t k = key(sfn, sf_idx);
+  std::map<uint64_t, Entry>::iterator it = entries.find(k);
+  if(it != entries.end() && (it->second.state == ENTRY_PENDING || it->second.state == ENTRY_READY)) {
+    // announced before; no longer occupies the window
+    release(it->second.subframeInfo);
+    nof_buffered--;
+  }
+  Entry& entry = it != entries.end() ? it->second : entries[k];
+  entry.state = ENTRY_GAP;
+  entry.reason = SUBFRAME_GAP_SKIPPED;
+  entry.sfn = sfn;
+  entry.sf_idx = sf_idx;
+  entry.subframeInfo = nullptr;
+  stats.nof_skipped++;
+  c.notify_one();
+}
+
+void SubframeInfoDispatcher::deliver(uint32_t sfn, uint32_t sf_idx, std::shared_ptr<SubframeInfo> subframeInfo) {
+  std::unique_lock<std::mutex> lock(m);
+  uint64_t k = key(sfn, sf_idx);
+  if(abandoned.erase(k) > 0) {
+    // already replaced by a gap marker; release the result outside the lock
+    SubframeInfoPool* p = pool;
+    lock.unlock();
+    if(p != nullptr) {
+      p->put(std::move(subframeInfo));
+    }
+    subframeInfo.reset();
+    return;
+  }
+  std::map<uint64_t, Entry>::iterator it = entries.find(k);
+  if(it == entries.end()) {
+    // not announced, take it anyway
+    Entry& entry = entries[k];
+    entry.sfn = sfn;
+    entry.sf_idx = sf_idx;
+    nof_buffered++;
+    it = entries.find(k);
+  }
+  it->second.state = ENTRY_READY;
+  it->second.subframeInfo = std::move(subframeInfo);
+  trim();
+  c.notify_one();
+}
+
+void SubframeInfoDispatcher::flush() {
+  std::unique_lock<std::mutex> lock(m);
+  while(!(entries.empty() && !dispatching) && !canceled) {
+    e.wait(lock);
+  }
+}
+
+void SubframeInfoDispatcher::cancel() {
+  // this function must not block on the consumer!
+  std::lock_guard<std::mutex> lock(m);
+  canceled = true;
+  c.notify_all();
+  e.notify_all();
+}
+
+void SubframeInfoDispatcher::wait_thread_finish() {
+  if(!joined) {
+    joined = true;
+    thread::wait_thread_finish();
+  }
+}
+
+SubframeInfoDispatcherStats SubframeInfoDispatcher::getStats() const {
+  std::lock_guard<std::mutex> lock(m);
+  return stats;
+}
+
+// Must be called with lock held.
+// Unwrapped subframe number: the candidate closest to the most recent subframe,
+// so that subframes after the wrap of sfn sort behind the pending ones before it.
+uint64_t SubframeInfoDispatcher::key(uint32_t sfn, uint32_t sf_idx) {
+  uint64_t tti = (10 * static_cast<uint64_t>(sfn) + sf_idx) % REORDER_BUFFER_NOF_TTI;
+  uint64_t k = latestKey - latestKey % REORDER_BUFFER_NOF_TTI + tti;
+  if(k + REORDER_BUFFER_NOF_TTI / 2 < latestKey) {
+    k += REORDER_BUFFER_NOF_TTI;
+  }
+  else if(k > latestKey + REORDER_BUFFER_NOF_TTI / 2) {
+    k -= REORDER_BUFFER_NOF_TTI;
+  }
+  if(k > latestKey) {
+    latestKey = k;
+  }
+  return k;
+}
+
+// Must be called with lock held.
+// Turns the oldest buffered entries into gap markers until the window fits.
+void SubframeInfoDispatcher::trim() {
+  std::map<uint64_t, Entry>::iterator it = entries.begin();
+  while(nof_buffered > depth && it != entries.end()) {
+    if(it->second.state == ENTRY_PENDING) {
+      // worker too slow; do not wait for this subframe any longer
+      it->second.reason = SUBFRAME_GAP_LATE;
+      abandoned.insert(it->first);
+      stats.nof_late++;
+    }
+    else if(it->second.state == ENTRY_READY) {
+      // consumer too slow; discard the oldest result
+      it->second.reason = SUBFRAME_GAP_DROPPED;
+      release(it->second.subframeInfo);
+      stats.nof_dropped++;
+    }
+    else {
+      ++it;
+      continue;
+    }
+    it->second.state = ENTRY_GAP;
+    nof_buffered--;
+    ++it;
+  }
+  c.notify_one();
+}
+
+// Must be called with lock held.
+void SubframeInfoDispatcher::release(std::shared_ptr<SubframeInfo>& subframeInfo) {
+  if(pool != nullptr) {
+    pool->put(std::move(subframeInfo));
+  }
+  subframeInfo = nullptr;
+}
+
+void SubframeInfoDispatcher::run_thread() {
+  std::unique_lock<std::mutex> lock(m);
+  while(!canceled) {
+    std::map<uint64_t, Entry>::iterator it = entries.begin();
+    if(it == entries.end() || it->second.state == ENTRY_PENDING) {
+      // nothing to dispatch in order yet
+      c.wait(lock);
+      continue;
+    }
+
+    Entry entry = std::move(it->second);
+    entries.erase(it);
+    if(entry.state == ENTRY_READY) {
+      nof_buffered--;
+    }
+    std::shared_ptr<SubframeInfoConsumer> cons(consumer);
+    dispatching = true;
+
+    // consumers run without holding the lock, workers keep delivering meanwhile
+    lock.unlock();
+    if(cons != nullptr) {
+      if(entry.state == ENTRY_READY) {
+        cons->consumeDCICollection(*entry.subframeInfo);
+      }
+      else {
+        cons->consumeSubframeGap(entry.sfn, entry.sf_idx, entry.reason);
+      }
+    }
+    lock.lock();
+    release(entry.subframeInfo);
+
+    dispatching = false;
+    if(entry.state == ENTRY_READY) {
+      stats.nof_dispatched++;
+    }
+    e.notify_all();
+  }
+}
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdio.h>
+#include <map>
+#include <set>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+
+#include "SubframeInfo.h"
+#include "SubframeInfoPool.h"
+#include "SubframeInfoConsumer.h"
+
+#include "falcon/common/Settings.h"
+
+#include "srslte/common/threads.h"
+
+// subframe numbering 10*sfn + sf_idx wraps after this many subframes
+#define REORDER_BUFFER_NOF_TTI 10240
+
+class SubframeInfoDispatcherStats {
+public:
+  SubframeInfoDispatcherStats();
+
+  uint64_t nof_dispatched;
+  uint64_t nof_skipped;
+  uint64_t nof_late;
+  uint64_t nof_dropped;
+};
+
+// Reorder buffer between the subframe workers and the SubframeInfoConsumer.
+// Workers hand in their results in any order; a dedicated thread passes them
+// to the consumer in order of (sfn, sf_idx), across the wrap-around of sfn. Subframes that were skipped, that
+// did not complete within the reorder window, or that were dropped because the
+// consumer is too slow, are replaced by explicit gap markers.
+class SubframeInfoDispatcher : public thread {
+public:
+  SubframeInfoDispatcher(uint32_t depth = DEFAULT_REORDER_BUFFER_DEPTH);
+  virtual ~SubframeInfoDispatcher() override;
+
+  void setDepth(uint32_t depth);
+  uint32_t getDepth() const;
+  void setConsumer(std::shared_ptr<SubframeInfoConsumer> consumer);
+  // consumed and discarded results are returned to this pool (optional)
+  void setPool(SubframeInfoPool* pool);
+
+  // producer side, never blocks on the consumer
+  void announce(uint32_t sfn, uint32_t sf_idx);
+  void skip(uint32_t sfn, uint32_t sf_idx);
+  void deliver(uint32_t sfn, uint32_t sf_idx, std::shared_ptr<SubframeInfo> subframeInfo);
+
+  // wait until all announced subframes have been dispatched
+  void flush();
+  void cancel();
+  void wait_thread_finish();
+  SubframeInfoDispatcherStats getStats() const;
+protected:
+  virtual void run_thread() override;
+private:
+  enum EntryState {
+    ENTRY_PENDING,  // announced, worker still busy
+    ENTRY_READY,    // result available
+    ENTRY_GAP       // no result, consumer receives a gap marker
+  };
+  struct Entry {
+    EntryState state;
+    SubframeGapReason reason;
+    uint32_t sfn;
+    uint32_t sf_idx;
+    std::shared_ptr<SubframeInfo> subframeInfo;
+  };
+  uint64_t key(uint32_t sfn, uint32_t sf_idx);
+  void trim();
+  void release(std::shared_ptr<SubframeInfo>& subframeInfo);
+
+  std::map<uint64_t, Entry> entries;
+  std::set<uint64_t> abandoned;   // late subframes, discard on delivery
+  uint32_t nof_buffered;          // pending or ready entries (excl. gaps)
+  uint64_t latestKey;             // most recent subframe, unwrapped
+  uint32_t depth;
+  std::shared_ptr<SubframeInfoConsumer> consumer;
+  SubframeInfoPool* pool;
+  SubframeInfoDispatcherStats stats;
+  bool dispatching;
+
+  mutable std::mutex m;
+  std::condition_variable c;  // new entry or state change
+  std::condition_variable e;  // entries dispatched
+  volatile bool canceled;
+  volatile bool joined;
+};
@@ -0,0 +1,51 @@
+#include "SubframeInfoPool.h"
+
+SubframeInfoPool::SubframeInfoPool() :
+  idle(),
+  nof_allocated(0)
+{
+
+}
+
+SubframeInfoPool::~SubframeInfoPool() {
+
+}
+
+std::shared_ptr<SubframeInfo> SubframeInfoPool::get(const srslte_cell_t& cell) {
+  std::shared_ptr<SubframeInfo> result;
+  {
+    std::lock_guard<std::mutex> lock(m);
+    if(!idle.empty()) {
+      result = std::move(idle.back());
+      idle.pop_back();
+    }
+    else {
+      nof_allocated++;
+    }
+  }
+  if(result != nullptr) {
+    result->reset(cell);
+  }
+  else {
+    result = std::make_shared<SubframeInfo>(cell);
+  }
+  return result;
+}
+
+void SubframeInfoPool::put(std::shared_ptr<SubframeInfo> subframeInfo) {
+  if(subframeInfo == nullptr || subframeInfo.use_count() > 1) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(m);
+  idle.push_back(std::move(subframeInfo));
+}
+
+uint32_t SubframeInfoPool::getNofIdle() const {
+  std::lock_guard<std::mutex> lock(m);
+  return static_cast<uint32_t>(idle.size());
+}
+
+uint32_t SubframeInfoPool::getNofAllocated() const {
+  std::lock_guard<std::mutex> lock(m);
+  return nof_allocated;
+}
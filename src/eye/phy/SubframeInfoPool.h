@@ -0,0 +1,28 @@
+#pragma once
+
+#include <stdint.h>
+#include <vector>
+#include <memory>
+#include <mutex>
+
+#include "SubframeInfo.h"
+
+// Recycles SubframeInfo objects, so that the DCI containers keep their
+// capacity across subframes instead of being reallocated for each subframe.
+class SubframeInfoPool {
+public:
+  SubframeInfoPool();
+  ~SubframeInfoPool();
+
+  // Returns an idle instance reset to the given cell, or a new one if the pool is empty
+  std::shared_ptr<SubframeInfo> get(const srslte_cell_t& cell);
+  // Takes back an instance; ignored if it is still referenced elsewhere
+  void put(std::shared_ptr<SubframeInfo> subframeInfo);
+
+  uint32_t getNofIdle() const;
+  uint32_t getNofAllocated() const;
+private:
+  std::vector<std::shared_ptr<SubframeInfo>> idle;
+  uint32_t nof_allocated;
+  mutable std::mutex m;
+};
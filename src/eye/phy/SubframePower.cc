@@ -15,6 +15,11 @@ SubframePower::~SubframePower() {
 
 }
 
+void SubframePower::reset(const srslte_cell_t& cell) {
+  nof_prb = cell.nof_prb;
+  rb_power_dl.assign(cell.nof_prb, 0);
+}
+
 void SubframePower::computePower(const cf_t *sf_symbols) {
 
 
@@ -7,6 +7,7 @@ class SubframePower {
 public:
     SubframePower(const srslte_cell_t& cell);
     ~SubframePower();
+    void reset(const srslte_cell_t& cell);
     const std::vector<float>& getRBPowerDL() const {return rb_power_dl;}
     void computePower(const cf_t* sf_symbols);
     uint32_t getNofPRB() const { return nof_prb; }
@@ -5,6 +5,7 @@
 #include "falcon/prof/Lifetime.h"
 
 #include <iostream>
+#include <sys/time.h>
 
 /* Buffers for PCH reception (not included in DL HARQ) */
 const static uint32_t  pch_payload_buffer_sz = 8*1024;  // cf. srslte: srsue/hdr/mac/mac.h
@@ -21,6 +22,7 @@ SubframeWorker::SubframeWorker(uint32_t idx,
   sf_idx(0),
   sfn(0),
   updateMetaFormats(false),
+  loadSheddingLevel(LOAD_SHEDDING_NONE),
   stats()
 {
   srslte_ue_dl_init(&ue_dl, sfb.sf_buffer, max_prb, common.nof_rx_antennas);
@@ -64,26 +66,43 @@ void SubframeWorker::prepare(uint32_t sf_idx, uint32_t sfn, bool updateMetaForma
   this->sf_idx = sf_idx;
   this->sfn = sfn;
   this->updateMetaFormats = updateMetaFormats;
+  this->loadSheddingLevel = LOAD_SHEDDING_NONE;
 }
 
-void SubframeWorker::work() {
+void SubframeWorker::setLoadSheddingLevel(LoadSheddingLevel level) {
+  loadSheddingLevel = level;
+}
+
+void SubframeWorker::work(DCISearchPool& searchPool) {
   int n;
+  struct timeval t_start, t_end;
+  gettimeofday(&t_start, nullptr);
   { //PrintLifetime lt("###>> Subframe took: ");
     if(updateMetaFormats) {
       metaFormats.update_formats();
     }
-    SubframeInfo subframeInfo(ue_dl.cell);
+    std::shared_ptr<SubframeInfo> subframeInfo(common.getSubframeInfo(ue_dl.cell));
     DCISearch dciSearch(ue_dl,
                         metaFormats,
                         common.getRNTIManager(),
-                        subframeInfo,
+                        searchPool,
+                        *subframeInfo,
                         sf_idx, sfn);
     dciSearch.setShortcutDiscovery(common.getShortcutDiscovery());
+    dciSearch.setLoadSheddingLevel(loadSheddingLevel);
+    dciSearch.setSearchDepth(common.getMaxRecursionDepth(), common.getDisambiguationDepth());
+    dciSearch.setListViterbi(common.getListViterbiSize(), common.getViterbiMinReliability());
+    dciSearch.setOccupancyGate(&common.getOccupancyGate(), common.getOccupancyThreshold());
+    dciSearch.setOccupancyTrace(common.getOccupancyTrace());
+    dciSearch.setTargetedSearch(common.getTargetedSearch());
+    dciSearch.setHintTable(common.getHarqHints() ? &common.getHintTable() : nullptr);
     dciSearch.search();
     stats += dciSearch.getStats();  //worker-specific statistics
     common.addStats(dciSearch.getStats());  //common statistics
-    common.consumeDCICollection(subframeInfo);
+    common.consumeDCICollection(sfn, sf_idx, std::move(subframeInfo));
   }
+  gettimeofday(&t_end, nullptr);
+  common.reportDecodeTime(static_cast<uint32_t>((t_end.tv_sec - t_start.tv_sec) * 1000000 + (t_end.tv_usec - t_start.tv_usec)));
 ///TODO:
 /// optimize here - if current_rnti had been changed, this means that some RA-RNTI was found
 /// and current_rnti is set to this RA-RNTI value.
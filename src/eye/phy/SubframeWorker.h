@@ -2,6 +2,8 @@
 
 #include "PhyCommon.h"
 #include "MetaFormats.h"
+#include "DCISearchPool.h"
+#include "LoadShedding.h"
 #include "falcon/common/SubframeBuffer.h"
 #include "falcon/phy/falcon_ue/falcon_ue_dl.h"
 
@@ -19,7 +21,8 @@ public:
   void setChestAverageSubframe(bool enable);
 
   void prepare(uint32_t sf_idx, uint32_t sfn, bool updateMetaFormats);
-  void work();
+  void setLoadSheddingLevel(LoadSheddingLevel level);
+  void work(DCISearchPool& searchPool);
   void printStats();
   DCIBlindSearchStats& getStats();
   cf_t* getBuffer(uint32_t antenna_idx);
@@ -39,6 +42,7 @@ private:
   uint32_t sf_idx;
   uint32_t sfn;
   bool updateMetaFormats;
+  LoadSheddingLevel loadSheddingLevel;
   bool collision_dw, collision_up;
   DCIBlindSearchStats stats;
 };
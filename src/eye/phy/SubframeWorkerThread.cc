@@ -3,10 +3,12 @@
 
 #include <iostream>
 
-SubframeWorkerThread::SubframeWorkerThread(ThreadSafeQueue<SubframeWorker>& avail,
-                                           ThreadSafeQueue<SubframeWorker>& pending) :
+SubframeWorkerThread::SubframeWorkerThread(LockFreeQueue<SubframeWorker>& avail,
+                                           LockFreeQueue<SubframeWorker>& pending,
+                                           uint32_t nof_search_threads) :
   avail(avail),
   pending(pending),
+  searchPool(nof_search_threads),
   canceled(false),
   joined(false)
 {
@@ -33,11 +35,11 @@ void SubframeWorkerThread::wait_thread_finish() {
 void SubframeWorkerThread::run_thread() {
   std::cout << "SubframeWorkerThread ready" << std::endl;
   while(!canceled) {
-    std::shared_ptr<SubframeWorker> worker = pending.dequeue();
+    SubframeWorker* worker = pending.dequeue();
     if(worker != nullptr) {
-      worker->work();
+      worker->work(searchPool);
       // enqueue finished worker
-      avail.enqueue(std::move(worker));
+      avail.enqueue(worker);
     }
     else {
       // nullptr is only returned if phy is canceled
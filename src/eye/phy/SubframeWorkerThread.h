@@ -1,22 +1,25 @@
 #pragma once
 
 #include "SubframeWorker.h"
-#include "falcon/common/ThreadSafeQueue.h"
+#include "DCISearchPool.h"
+#include "falcon/common/LockFreeQueue.h"
 
 #include "srslte/common/threads.h"
 
 class SubframeWorkerThread : public thread {
 public:
-    SubframeWorkerThread(ThreadSafeQueue<SubframeWorker>& avail,
-                         ThreadSafeQueue<SubframeWorker>& pending);
+    SubframeWorkerThread(LockFreeQueue<SubframeWorker>& avail,
+                         LockFreeQueue<SubframeWorker>& pending,
+                         uint32_t nof_search_threads);
     virtual ~SubframeWorkerThread();
     void cancel();
     void wait_thread_finish();
 protected:
   virtual void run_thread() override;
 private:
-  ThreadSafeQueue<SubframeWorker>& avail;
-  ThreadSafeQueue<SubframeWorker>& pending;
+  LockFreeQueue<SubframeWorker>& avail;
+  LockFreeQueue<SubframeWorker>& pending;
+  DCISearchPool searchPool;
   volatile bool canceled;
   volatile bool joined;
 };
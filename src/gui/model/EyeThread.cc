@@ -97,7 +97,7 @@ void plot_rnti(EyeThread *inst, uint32_t *rnti_hist){
   else{
     ScanLineLegacy *scanline_rnti = new ScanLineLegacy;
     scanline_rnti->type = SCAN_LINE_RNTI_HIST;
-    scanline_rnti->rnti_active_set = inst->getRNTIManager().getActiveSet();
+    inst->getRNTIManager().getActiveSet(scanline_rnti->rnti_active_set);
 
     inst-> pushToSubscribers(scanline_rnti);
    }
@@ -213,12 +213,12 @@ void DCIGUIConsumer::consumeDCICollection(const SubframeInfo& subframeInfo) {
       case SRSLTE_DCI_FORMAT1C:
       case SRSLTE_DCI_FORMAT1B:
       case SRSLTE_DCI_FORMAT1D:
-        update_perfPlot(m_Thread, collection.get_sfn(), collection.get_sf_idx(), dci_dl_it->dl_grant->mcs[0].idx, dci_dl_it->dl_grant->mcs[0].tbs, dci_dl_it->dl_grant->nof_prb, SCAN_LINE_PERF_PLOT_B);
+        update_perfPlot(m_Thread, collection.get_sfn(), collection.get_sf_idx(), dci_dl_it->dl_grant.mcs[0].idx, dci_dl_it->dl_grant.mcs[0].tbs, dci_dl_it->dl_grant.nof_prb, SCAN_LINE_PERF_PLOT_B);
         break;
       case SRSLTE_DCI_FORMAT2:
       case SRSLTE_DCI_FORMAT2A:
       case SRSLTE_DCI_FORMAT2B:
-        update_perfPlot(m_Thread, collection.get_sfn(), collection.get_sf_idx(), dci_dl_it->dl_grant->mcs[0].idx, dci_dl_it->dl_grant->mcs[0].tbs, dci_dl_it->dl_grant->nof_prb, SCAN_LINE_PERF_PLOT_B);
+        update_perfPlot(m_Thread, collection.get_sfn(), collection.get_sf_idx(), dci_dl_it->dl_grant.mcs[0].idx, dci_dl_it->dl_grant.mcs[0].tbs, dci_dl_it->dl_grant.nof_prb, SCAN_LINE_PERF_PLOT_B);
         break;
         //case SRSLTE_DCI_FORMAT3:
         //case SRSLTE_DCI_FORMAT3A:
@@ -231,11 +231,11 @@ void DCIGUIConsumer::consumeDCICollection(const SubframeInfo& subframeInfo) {
   const std::vector<DCI_UL>& dci_ul = collection.getDCI_UL();
   for(std::vector<DCI_UL>::const_iterator dci_ul_it = dci_ul.begin(); dci_ul_it != dci_ul.end(); ++dci_ul_it) {
     // TODO: Ask for explantion here
-    if (dci_ul_it->ul_dci_unpacked->mcs_idx < 29) {
-      update_perfPlot(m_Thread, collection.get_sfn(), collection.get_sf_idx(), dci_ul_it->ul_grant->mcs.idx, dci_ul_it->ul_grant->mcs.tbs, dci_ul_it->ul_grant->L_prb, SCAN_LINE_PERF_PLOT_A);
+    if (dci_ul_it->ul_dci_unpacked.mcs_idx < 29) {
+      update_perfPlot(m_Thread, collection.get_sfn(), collection.get_sf_idx(), dci_ul_it->ul_grant.mcs.idx, dci_ul_it->ul_grant.mcs.tbs, dci_ul_it->ul_grant.L_prb, SCAN_LINE_PERF_PLOT_A);
     }
     else {
-      update_perfPlot(m_Thread, collection.get_sfn(), collection.get_sf_idx(), dci_ul_it->ul_grant->mcs.idx, 0, dci_ul_it->ul_grant->L_prb, SCAN_LINE_PERF_PLOT_A);
+      update_perfPlot(m_Thread, collection.get_sfn(), collection.get_sf_idx(), dci_ul_it->ul_grant.mcs.idx, 0, dci_ul_it->ul_grant.L_prb, SCAN_LINE_PERF_PLOT_A);
     }
   }
 }
@@ -22,9 +22,15 @@
 #include <QWidget>
 #include <QDebug>
 #include <QSettings>
+#include <QFileInfo>
 
 #include <iostream>
 
+// RNTI snapshots are kept next to the settings file unless configured otherwise
+static QString default_rnti_snapshot_file(const QSettings* settings) {
+  return QFileInfo(settings->fileName()).absolutePath() + "/rnti_snapshot.bin";
+}
+
 Settings::Settings() : glob_args() {
 
   //Init decoder args:
@@ -63,6 +69,9 @@ Settings::Settings() : glob_args() {
     glob_args.spectrum_args.spectrum_line_shown = 100;
     glob_args.spectrum_args.spectrum_line_width = 50;
 
+    //Eye args:
+    glob_args.eyeArgs.rnti_snapshot_file_name = default_rnti_snapshot_file(settings).toStdString();
+
     store_settings(); //Default settings on startup are saved to file.
   }
 
@@ -105,6 +114,7 @@ void Settings::load_settings() {
 
   glob_args.eyeArgs.rf_freq          = settings->value("RF_FREQ").toDouble();
   glob_args.gui_args.path_to_file    = settings->value("PATH_TO_FILE").toString().toLocal8Bit();
+  glob_args.eyeArgs.rnti_snapshot_file_name = settings->value("RNTI_SNAPSHOT_FILE", default_rnti_snapshot_file(settings)).toString().toStdString();
 
   settings->endGroup();
 
@@ -144,6 +154,7 @@ void Settings::store_settings(){
 
   settings->setValue("RF_FREQ"            , glob_args.eyeArgs.rf_freq);
   settings->setValue("PATH_TO_FILE"       , glob_args.gui_args.path_to_file);
+  settings->setValue("RNTI_SNAPSHOT_FILE" , QString::fromStdString(glob_args.eyeArgs.rnti_snapshot_file_name));
 
   settings->endGroup();
 
@@ -0,0 +1,55 @@
+#include "falcon/common/DCITrace.h"
+
+#include <iostream>
+#include <vector>
+
+using namespace std;
+
+/**
+ * Converts a binary DCI trace (FalconEye -b) into the text format of FalconEye -D.
+ * Subframe gaps are not part of the text format and are skipped.
+ */
+int main(int argc, char** argv) {
+    if(argc < 2) {
+        cerr << "Usage: " << argv[0] << " trace_file [output_file]" << endl;
+        return 1;
+    }
+
+    DCITraceReader reader;
+    if(!reader.open(argv[1])) {
+        cerr << "Could not open DCI trace " << argv[1] << endl;
+        return 1;
+    }
+
+    FILE* out = stdout;
+    if(argc > 2) {
+        out = fopen(argv[2], "w");
+        if(out == nullptr) {
+            cerr << "Could not open output file " << argv[2] << endl;
+            return 1;
+        }
+    }
+
+    DCITraceSubframeHeader header;
+    vector<DCITraceRecord> records;
+    uint64_t nof_subframes = 0;
+    uint64_t nof_gaps = 0;
+    uint64_t nof_dci = 0;
+    while(reader.next(header, records)) {
+        nof_subframes++;
+        if(header.flags & DCI_TRACE_FLAG_GAP) {
+            nof_gaps++;
+            continue;
+        }
+        for(vector<DCITraceRecord>::const_iterator it = records.begin(); it != records.end(); ++it) {
+            DCITracePrintText(out, header, *it);
+        }
+        nof_dci += records.size();
+    }
+
+    if(out != stdout) {
+        fclose(out);
+    }
+    cerr << "Converted " << nof_dci << " DCI of " << nof_subframes << " subframes (" << nof_gaps << " gaps)" << endl;
+    return 0;
+}
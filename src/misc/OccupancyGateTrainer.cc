@@ -0,0 +1,175 @@
+#include "falcon/phy/falcon_phch/falcon_occupancy_gate.h"
+
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+
+using namespace std;
+
+#define TRAIN_ITERATIONS 1000
+#define TRAIN_LEARNING_RATE 0.5
+#define TRAIN_L2 1e-4
+#define DEFAULT_TARGET_RECALL 0.995
+
+struct Sample {
+  falcon_dci_location_t location;
+  bool label;
+};
+
+static bool readTrace(const char* filename, vector<Sample>& samples) {
+  FILE* f = fopen(filename, "r");
+  if(f == nullptr) {
+    return false;
+  }
+  char line[512];
+  while(fgets(line, sizeof(line), f) != nullptr) {
+    unsigned int sfn, sf_idx, cfi, ncce, l, label;
+    float power, spread, relative_power, occupancy;
+    // the header line does not match
+    if(sscanf(line, "%u, %u, %u, %u, %u, %f, %f, %f, %f, %u",
+              &sfn, &sf_idx, &cfi, &ncce, &l, &power, &spread, &relative_power, &occupancy, &label) != 10 ||
+       l >= FALCON_OCCUPANCY_NOF_LEVELS) {
+      continue;
+    }
+    Sample s = {};
+    s.location.L = l;
+    s.location.ncce = ncce;
+    s.location.power = power;
+    s.location.spread = spread;
+    s.location.relative_power = relative_power;
+    s.label = label != 0;
+    samples.push_back(s);
+  }
+  fclose(f);
+  return true;
+}
+
+// Class-balanced logistic regression on standardized features (batch gradient descent).
+// Returns false if the samples do not contain both classes.
+static bool train(const vector<const Sample*>& samples, float* weights) {
+  const uint32_t n = FALCON_OCCUPANCY_NOF_FEATURES;
+  size_t nof_pos = 0;
+  for(const Sample* s : samples) {
+    nof_pos += s->label ? 1 : 0;
+  }
+  size_t nof_neg = samples.size() - nof_pos;
+  if(nof_pos == 0 || nof_neg == 0) {
+    return false;
+  }
+
+  // standardization (feature 0 is the bias)
+  vector<double> mean(n, 0), sd(n, 1);
+  vector<vector<double>> x(samples.size(), vector<double>(n));
+  for(size_t i = 0; i < samples.size(); i++) {
+    float f[FALCON_OCCUPANCY_NOF_FEATURES];
+    falcon_occupancy_features(&samples[i]->location, f);
+    for(uint32_t j = 0; j < n; j++) {
+      x[i][j] = f[j];
+    }
+  }
+  for(uint32_t j = 1; j < n; j++) {
+    double sum = 0, sum2 = 0;
+    for(size_t i = 0; i < x.size(); i++) {
+      sum += x[i][j];
+      sum2 += x[i][j] * x[i][j];
+    }
+    mean[j] = sum / x.size();
+    double var = sum2 / x.size() - mean[j] * mean[j];
+    sd[j] = var > 1e-12 ? sqrt(var) : 1;
+    for(size_t i = 0; i < x.size(); i++) {
+      x[i][j] = (x[i][j] - mean[j]) / sd[j];
+    }
+  }
+
+  double w_pos = 0.5 / nof_pos;
+  double w_neg = 0.5 / nof_neg;
+  vector<double> w(n, 0);
+  for(uint32_t it = 0; it < TRAIN_ITERATIONS; it++) {
+    vector<double> grad(n, 0);
+    for(size_t i = 0; i < x.size(); i++) {
+      double z = 0;
+      for(uint32_t j = 0; j < n; j++) {
+        z += w[j] * x[i][j];
+      }
+      double p = 1.0 / (1.0 + exp(-z));
+      double err = (p - (samples[i]->label ? 1.0 : 0.0)) * (samples[i]->label ? w_pos : w_neg);
+      for(uint32_t j = 0; j < n; j++) {
+        grad[j] += err * x[i][j];
+      }
+    }
+    for(uint32_t j = 0; j < n; j++) {
+      w[j] -= TRAIN_LEARNING_RATE * (grad[j] + (j > 0 ? TRAIN_L2 * w[j] : 0));
+    }
+  }
+
+  // back to raw features
+  weights[0] = static_cast<float>(w[0]);
+  for(uint32_t j = 1; j < n; j++) {
+    weights[j] = static_cast<float>(w[j] / sd[j]);
+    weights[0] -= static_cast<float>(w[j] * mean[j] / sd[j]);
+  }
+  return true;
+}
+
+/**
+ * Trains the occupancy gate of FalconEye (-G, -M) from feature traces recorded with FalconEye -Q.
+ * Prints the gate threshold that keeps the given share of DCI (recall) and the share of
+ * decodes it saves on the training data.
+ */
+int main(int argc, char** argv) {
+  if(argc < 3) {
+    cerr << "Usage: " << argv[0] << " trace_file model_file [target_recall, default " << DEFAULT_TARGET_RECALL << "]" << endl;
+    return 1;
+  }
+  double target_recall = argc > 3 ? atof(argv[3]) : DEFAULT_TARGET_RECALL;
+
+  vector<Sample> samples;
+  if(!readTrace(argv[1], samples)) {
+    cerr << "Could not open occupancy trace " << argv[1] << endl;
+    return 1;
+  }
+
+  falcon_occupancy_gate_t gate;
+  falcon_occupancy_gate_init(&gate);
+  for(uint32_t l = 0; l < FALCON_OCCUPANCY_NOF_LEVELS; l++) {
+    vector<const Sample*> level;
+    for(const Sample& s : samples) {
+      if(s.location.L == l) {
+        level.push_back(&s);
+      }
+    }
+    if(train(level, gate.weights[l])) {
+      cerr << "L" << (1 << l) << ": trained on " << level.size() << " locations" << endl;
+    }
+    else {
+      cerr << "L" << (1 << l) << ": " << level.size() << " locations without both classes, keeping built-in model" << endl;
+    }
+  }
+
+  // threshold that keeps target_recall of the DCI
+  vector<float> pos;
+  vector<float> neg;
+  for(const Sample& s : samples) {
+    float p = falcon_occupancy_gate_predict(&gate, &s.location);
+    (s.label ? pos : neg).push_back(p);
+  }
+  if(pos.empty()) {
+    cerr << "No DCI in trace, cannot derive a threshold" << endl;
+  }
+  else {
+    float threshold = falcon_occupancy_gate_threshold(pos.data(), static_cast<uint32_t>(pos.size()), target_recall);
+    size_t nof_skipped = count_if(neg.begin(), neg.end(), [threshold](float p) { return p < threshold; });
+    size_t nof_kept = count_if(pos.begin(), pos.end(), [threshold](float p) { return p >= threshold; });
+    cerr << "Threshold (-G) " << threshold << ": recall " << static_cast<double>(nof_kept) / pos.size()
+         << ", skipped " << nof_skipped << " of " << neg.size() << " empty locations" << endl;
+  }
+
+  if(falcon_occupancy_gate_save(&gate, argv[2]) != SRSLTE_SUCCESS) {
+    cerr << "Could not write occupancy model " << argv[2] << endl;
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,81 @@
+#include "falcon/util/RNTIManager.h"
+
+#include <iostream>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <stdlib.h>
+
+using namespace std;
+
+#define BENCH_NOF_FORMATS 7
+#define BENCH_NOF_UES 60
+#define BENCH_UES_PER_SUBFRAME 10
+#define BENCH_NOISE_PER_SUBFRAME 300
+
+/**
+ * Measures the validation throughput of the RNTIManager with dense counters,
+ * with hashed counters for the C-RNTI range and with the decaying activity
+ * estimators. The estimators are filled
+ * with random candidates (noise) and a small set of recurring RNTIs (UEs).
+ */
+static void run(const char* name, const char* estimator, uint32_t denseRange, uint32_t nof_subframes, uint32_t nof_validations) {
+  RNTIManager rm(BENCH_NOF_FORMATS, RNTI_PER_SUBFRAME, denseRange);
+  rm.setActivityEstimator(estimator);
+  mt19937 gen(1);
+  uniform_int_distribution<uint32_t> anyRnti(RNTI_CRNTI_START, 0xFFF3);
+  uniform_int_distribution<uint32_t> anyFormat(0, BENCH_NOF_FORMATS - 1);
+  vector<uint16_t> ues(BENCH_NOF_UES);
+  for(uint32_t i = 0; i < BENCH_NOF_UES; i++) {
+    ues[i] = static_cast<uint16_t>(anyRnti(gen));
+  }
+
+  RNTICandidateDelta delta;
+  for(uint32_t tti = 0; tti < nof_subframes; tti++) {
+    for(uint32_t i = 0; i < BENCH_NOISE_PER_SUBFRAME / BENCH_NOF_FORMATS; i++) {
+      delta.add(static_cast<uint16_t>(anyRnti(gen)), anyFormat(gen));
+    }
+    for(uint32_t i = 0; i < BENCH_UES_PER_SUBFRAME; i++) {
+      delta.add(ues[(tti * BENCH_UES_PER_SUBFRAME + i) % BENCH_NOF_UES], anyFormat(gen));
+    }
+    rm.commitSubframe(tti % RNTI_MANAGER_NOF_TTI, delta);
+  }
+
+  vector<uint16_t> queries(4096);
+  for(uint32_t i = 0; i < queries.size(); i++) {
+    queries[i] = (i % 8 == 0) ? ues[i % BENCH_NOF_UES] : static_cast<uint16_t>(anyRnti(gen));
+  }
+
+  uint32_t nof_valid = 0;
+  auto start = chrono::steady_clock::now();
+  for(uint32_t i = 0; i < nof_validations; i++) {
+    if(rm.validate(queries[i % queries.size()], i % BENCH_NOF_FORMATS)) {
+      nof_valid++;
+    }
+  }
+  auto end = chrono::steady_clock::now();
+  double sec = chrono::duration<double>(end - start).count();
+
+  cout << name << ":\t"
+       << rm.getMemorySize() / 1024 << " KiB,\t"
+       << nof_validations / sec / 1e6 << " M validations/s,\t"
+       << nof_valid << " valid" << endl;
+}
+
+int main(int argc, char** argv) {
+  uint32_t nof_subframes = 2000;
+  uint32_t nof_validations = 10000000;
+  if(argc > 1) {
+    nof_validations = static_cast<uint32_t>(atoi(argv[1]));
+  }
+  if(argc > 2) {
+    nof_subframes = static_cast<uint32_t>(atoi(argv[2]));
+  }
+  cout << "Usage: " << argv[0] << " [nof_validations] [nof_subframes]" << endl;
+
+  run("dense", "histogram", RNTI_HISTOGRAM_ELEMENT_COUNT, nof_subframes, nof_validations);
+  run("hashed", "histogram", RNTI_CRNTI_START, nof_subframes, nof_validations);
+  run("decay", "decay", RNTI_HISTOGRAM_ELEMENT_COUNT, nof_subframes, nof_validations);
+  run("sketch", "sketch", RNTI_HISTOGRAM_ELEMENT_COUNT, nof_subframes, nof_validations);
+  return 0;
+}
@@ -7,6 +7,47 @@ using namespace std;
 #define NOF_CCE(cfi)  ((cfi>0&&cfi<4)?q->nof_cce[cfi-1]:0)
 #define MAX_CANDIDATES_UE  (16+6) // From 36.213 Table 9.1.1-1 (Common+UE_spec.)
 
+/**
+ * @brief verifySearchSpaceCache Cross-checks the lookup table of falcon_search_space_cache_validate_location
+ * against srslte_pdcch_validate_location for all RNTIs, subframes, locations and numbers of CCE of this cell.
+ * @return number of mismatches
+ */
+static uint32_t verifySearchSpaceCache(srslte_pdcch_t* pdcch) {
+    falcon_search_space_cache_t cache;
+    if (falcon_search_space_cache_init(&cache)) {
+        cerr << "Error creating search space cache" << endl;
+        exit(-1);
+    }
+
+    uint32_t mismatches = 0;
+    for(uint32_t cfi=1; cfi<4; cfi++) {
+        uint32_t nof_cce = srslte_pdcch_nof_cce(pdcch, cfi);
+        for(uint32_t rnti=0; rnti<=0xffff; rnti++) {
+            for(uint32_t nsubframe=0; nsubframe<10; nsubframe++) {
+                for(uint32_t ncce=0; ncce<nof_cce; ncce++) {
+                    for(uint32_t l=0; l<4; l++) {
+                        uint32_t expected = srslte_pdcch_validate_location(nof_cce, ncce, l, nsubframe, static_cast<uint16_t>(rnti));
+                        uint32_t cached = falcon_search_space_cache_validate_location(&cache, nof_cce, ncce, l, nsubframe, static_cast<uint16_t>(rnti));
+                        if(expected != cached) {
+                            cout << "Mismatch:"
+                                 << " RNTI: " << rnti
+                                 << " CFI: " << cfi
+                                 << " SF: " << nsubframe
+                                 << " (" << ncce << ", " << l << "): " << expected << " vs. " << cached << endl;
+                            mismatches++;
+                        }
+                    }
+                }
+            }
+        }
+    }
+    cout << "Search space cache: " << mismatches << " mismatches, "
+         << cache.nof_hits << " hits, " << cache.nof_misses << " misses" << endl;
+
+    falcon_search_space_cache_free(&cache);
+    return mismatches;
+}
+
 /**
  * @brief main This test function demonstrates that the UE-specific search space function
  * sometimes allows overlapping candidates with different aggregation Level L which start with the same CCE.
@@ -91,6 +132,11 @@ int main(int argc, char *argv[]) {
         }
     }
 
+    // Verify precomputed search spaces
+    if(verifySearchSpaceCache(&pdcch) > 0) {
+        return 1;
+    }
+
     return 0;
 }
 